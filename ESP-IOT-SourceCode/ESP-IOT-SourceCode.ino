@@ -4,12 +4,21 @@
 // ============================================================================
 
 #include <Arduino.h>
-#include <EEPROM.h>
 #include "config.h"
 #include "storage.h"
+#include "journal.h"
+#include "event_loop.h"
+#include "control.h"
 #include "hardware.h"
 #include "app_network.h"
 #include "scheduler.h"
+#include "timekeeping.h"
+#include "timers.h"
+#include "buttons.h"
+#include "perf.h"
+#include "power.h"
+#include "adc_sampler.h"
+#include "protection.h"
 #include "app_webserver.h"
 #include "serial_cmd.h"
 
@@ -19,17 +28,16 @@
 Config config;
 bool powerJackState = false;
 bool usbOutputState = false;
-unsigned long lastWifiAttempt = 0;
-unsigned long lastTimeUpdate = 0;
-unsigned long lastButtonCheck = 0;
 bool wifiConnected = false;
 time_t currentTime = 0;
 
-// Button states
-bool lastButton1 = HIGH;
-bool lastButton2 = HIGH;
-bool lastButton3 = HIGH;
-bool lastButton4 = HIGH;
+// ============================================================================
+// CONTROL TASK EVENTS
+// ============================================================================
+// Checkpoint the clock so a reboot without NTP resumes close to real time
+void checkpointClock() {
+  if (currentTime > 0) journalPut(JOURNAL_LAST_TIME, currentTime);
+}
 
 // ============================================================================
 // SETUP
@@ -44,10 +52,13 @@ void setup() {
   Serial.println(F("    Dual Output + PD Control"));
   Serial.println(F("========================================\n"));
   
-  // Initialize EEPROM
-  EEPROM.begin(EEPROM_SIZE);
+  // Open the EEPROM and schedule stores and load config
   loadConfig();
   
+  // Restore output states and clock from the journal partition
+  beginJournal();
+  loadRuntimeState();
+  
   // Initialize output pins
   pinMode(POWER_JACK_PIN, OUTPUT);
   pinMode(USB_OUTPUT_PIN, OUTPUT);
@@ -64,34 +75,45 @@ void setup() {
   pinMode(BUTTON2_PIN, INPUT_PULLUP);
   pinMode(BUTTON3_PIN, INPUT_PULLUP);
   pinMode(BUTTON4_PIN, INPUT_PULLUP);
+  beginButtons();
   
-  // Initialize ADC pins
-  pinMode(VBUS_ADC_PIN, INPUT);
-  pinMode(VOUT_ADC_PIN, INPUT);
-  
-  // Set ADC resolution for ESP32-C6
-  analogReadResolution(12);  // 12-bit resolution
+  // Sample VBUS/VOUT continuously in the background; protection checks
+  // every frame on the ADC task
+  beginProtection();
+  beginAdcSampler();
   
-  // Set PD voltage from config
+  // Set PD voltage from config; VBUS is verified in the background
+  beginPD();
   setPDVoltage(config.pdVoltage);
   
   // Restore output states from config
   setPowerJackState(config.powerJackState);
   setUSBOutputState(config.usbOutputState);
   
-  // Try to connect to WiFi if configured
-  if (strlen(config.ssid) > 0) {
-    connectWiFi();
-    if (wifiConnected) {
-      setupWebServer();
-    }
-  }
-  
-  // Initialize time from saved value
+  // Initialize time from saved value. The first NTP sync compares against
+  // it to catch up on schedules missed while the unit was off.
   if (config.lastTime > 0) {
     currentTime = config.lastTime;
   }
   
+  // WiFi connects in the background; the web server and time sync start
+  // from hooks once it is up
+  beginWiFi();
+  addWiFiHook(setupWebServer);
+  addWiFiHook(updateTime);
+  
+  // Light sleep between events if enabled (/power on)
+  beginPower();
+  
+  beginTimers();
+  beginLiveUpdates();
+  addEvent(tickClock, CLOCK_TICK_INTERVAL);
+  addEvent(checkpointClock, TIME_CHECKPOINT_INTERVAL);
+  beginControlTask();
+  
+  // Flash writes from here on: config write-behind and journal appends
+  beginStorage();
+  
   printHelp();
   Serial.println(F("Ready. Type /help for commands.\n"));
 }
@@ -99,52 +121,20 @@ void setup() {
 // ============================================================================
 // MAIN LOOP
 // ============================================================================
+// The Arduino loop task is the network task: WiFi, NTP and serial. HTTP
+// clients are served by the web server's own task (app_webserver.cpp), so
+// neither a slow client nor this loop delays buttons, schedules or timers,
+// which run on the control task.
 void loop() {
-  unsigned long now = millis();
-  
-  // Update current time
-  if (currentTime > 0) {
-    static unsigned long lastMillis = 0;
-    if (lastMillis == 0) lastMillis = now;
-    if (now - lastMillis >= 1000) {
-      currentTime += (now - lastMillis) / 1000;
-      lastMillis = now;
-      config.lastTime = currentTime;
-    }
-  }
-  
-  // WiFi reconnection
-  if (!wifiConnected && strlen(config.ssid) > 0) {
-    if (now - lastWifiAttempt >= WIFI_RETRY_INTERVAL) {
-      lastWifiAttempt = now;
-      Serial.println(F("Retrying WiFi connection..."));
-      connectWiFi();
-      if (wifiConnected) {
-        setupWebServer();
-      }
-    }
-  }
-  
-  // Time update
-  if (wifiConnected && now - lastTimeUpdate >= TIME_UPDATE_INTERVAL) {
-    lastTimeUpdate = now;
-    updateTime();
+  {
+    PERF_SCOPE(PERF_NET_LOOP);
+    
+    // WiFi connection state machine and time sync results
+    wifiLoop();
+    
+    // Handle serial commands
+    handleSerialCommand();
   }
   
-  // Check buttons
-  checkButtons();
-  
-  // Check schedules
-  checkSchedules();
-  
-  // Handle web clients
-  if (wifiConnected) {
-    handleWebClient();
-  }
-  
-  // Handle serial commands
-  handleSerialCommand();
-  
-  // Small delay to prevent watchdog issues
-  delay(10);
+  delay(ioPollInterval());
 }
@@ -0,0 +1,169 @@
+#include "adc_sampler.h"
+#include "event_loop.h"
+#include "perf.h"
+#include "telemetry.h"
+#include "protection.h"
+#include "hardware.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const uint8_t adcPins[ADC_CHANNEL_COUNT] = { VBUS_ADC_PIN, VOUT_ADC_PIN };
+static const uint32_t adcDividers[ADC_CHANNEL_COUNT] = { VBUS_DIVIDER_Q16, VOUT_DIVIDER_Q16 };
+
+// railMillivolts() multiplies in 32 bits; the ADC never reports over ~3.3V
+static_assert(4000ULL * VBUS_DIVIDER_Q16 < (1ULL << 32), "VBUS divider ratio too large");
+static_assert(4000ULL * VOUT_DIVIDER_Q16 < (1ULL << 32), "VOUT divider ratio too large");
+
+// Per-channel window of recent frames, oldest overwritten first
+struct AdcWindow {
+  uint32_t samples[ADC_FILTER_LEN];
+  uint8_t next;
+  uint8_t count;
+  uint32_t sum;                 // Running sum for ADC_FILTER_AVERAGE
+  volatile uint32_t filtered;   // What readers see
+  volatile uint32_t raw;
+};
+
+static AdcWindow windows[ADC_CHANNEL_COUNT];
+static AdcStats stats = {};
+static int adcEvent = -1;
+static bool running = false;   // Control task only
+static volatile int64_t frameReadyUs = 0;
+static TaskHandle_t adcTask = nullptr;
+
+// Newest frame, handed from the ADC task to the control task's history
+static portMUX_TYPE frameMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t lastFrameMv[ADC_CHANNEL_COUNT];
+
+static void IRAM_ATTR onAdcFrame() {
+  frameReadyUs = esp_timer_get_time();
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(adcTask, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+#if ADC_FILTER == ADC_FILTER_MEDIAN
+static uint32_t median(const AdcWindow &w) {
+  uint32_t sorted[ADC_FILTER_LEN];
+  memcpy(sorted, w.samples, w.count * sizeof(uint32_t));
+  for (uint8_t i = 1; i < w.count; i++) {
+    uint32_t v = sorted[i];
+    uint8_t j = i;
+    for (; j > 0 && sorted[j - 1] > v; j--) sorted[j] = sorted[j - 1];
+    sorted[j] = v;
+  }
+  return sorted[w.count / 2];
+}
+#endif
+
+static void addSample(AdcWindow &w, uint32_t mv) {
+  if (w.count == ADC_FILTER_LEN) w.sum -= w.samples[w.next];
+  else w.count++;
+  w.samples[w.next] = mv;
+  w.sum += mv;
+  w.next = (w.next + 1) % ADC_FILTER_LEN;
+  w.raw = mv;
+#if ADC_FILTER == ADC_FILTER_MEDIAN
+  w.filtered = median(w);
+#else
+  w.filtered = w.sum / w.count;
+#endif
+}
+
+// In low-power mode the ADC is stopped between frames, since a running
+// conversion keeps the chip out of light sleep. Only with both outputs off
+// and no PD change settling: a live output gets every frame checked by
+// protection, so while one is on the chip effectively never enters light
+// sleep, and a PD change is verified at full rate.
+static bool mayPause() {
+  return config.lowPower && !powerJackState && !usbOutputState &&
+         getPDStatus().state != PD_SETTLING;
+}
+
+// Reads, filters and protection-checks each frame as it completes. Nothing
+// else runs at ADC_TASK_PRIORITY and this never waits on another task, so
+// the time to a cutoff does not depend on the control task, the web server
+// or flash writes. The history and the low-power pause follow on the
+// control task.
+static void adcTaskMain(void *) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    adc_continuous_result_t *results = nullptr;
+    if (!analogContinuousRead(&results, 0)) {
+      stats.readErrors++;
+      continue;
+    }
+    PERF_SCOPE(PERF_ADC);
+    uint32_t frameMv[ADC_CHANNEL_COUNT];
+    for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) frameMv[ch] = windows[ch].raw;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+      for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+        if (results[i].pin != adcPins[ch]) continue;
+        int pinMv = results[i].avg_read_mvolts;
+        frameMv[ch] = railMillivolts(pinMv > 0 ? pinMv : 0, adcDividers[ch]);
+        addSample(windows[ch], frameMv[ch]);
+      }
+    }
+    // Unfiltered: the filter would add up to ADC_FILTER_LEN / 2 frames of delay
+    protectionCheck(frameMv, frameReadyUs);
+    stats.frames++;
+
+    portENTER_CRITICAL(&frameMux);
+    memcpy(lastFrameMv, frameMv, sizeof(frameMv));
+    portEXIT_CRITICAL(&frameMux);
+    triggerEvent(adcEvent);
+  }
+}
+
+// Control task: runs after each frame, and every ADC_LOW_POWER_INTERVAL
+// while paused to take the next one.
+static void serviceAdc() {
+  if (!running) {
+    running = analogContinuousStart();
+    if (!running) scheduleEvent(adcEvent, ADC_LOW_POWER_INTERVAL);
+    return;
+  }
+
+  uint32_t frameMv[ADC_CHANNEL_COUNT];
+  portENTER_CRITICAL(&frameMux);
+  memcpy(frameMv, lastFrameMv, sizeof(frameMv));
+  portEXIT_CRITICAL(&frameMux);
+  telemetryAddFrame(frameMv);
+
+  if (mayPause()) {
+    analogContinuousStop();
+    running = false;
+    scheduleEvent(adcEvent, ADC_LOW_POWER_INTERVAL);
+  }
+}
+
+bool beginAdcSampler() {
+  adcEvent = addEvent(serviceAdc, 0);
+  xTaskCreate(adcTaskMain, "adc", ADC_TASK_STACK, nullptr, ADC_TASK_PRIORITY, &adcTask);
+  analogContinuousSetWidth(12);
+  if (!analogContinuous(adcPins, ADC_CHANNEL_COUNT, ADC_OVERSAMPLE, ADC_SAMPLE_FREQ, onAdcFrame)) {
+    Serial.println(F("ERR: ADC continuous mode setup failed"));
+    return false;
+  }
+  running = analogContinuousStart();
+  return running;
+}
+
+void resumeAdcSampler() {
+  if (running) return;
+  running = analogContinuousStart();
+  if (running) cancelEvent(adcEvent);   // Frames trigger it again
+}
+
+uint32_t getAdcMillivolts(uint8_t channel) {
+  return windows[channel].filtered;
+}
+
+uint32_t getAdcRawMillivolts(uint8_t channel) {
+  return windows[channel].raw;
+}
+
+const AdcStats& getAdcStats() {
+  return stats;
+}
@@ -0,0 +1,43 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "config.h"
+
+// Background VBUS/VOUT sampling. The ADC runs in continuous (DMA) mode and
+// averages ADC_OVERSAMPLE conversions per channel into each frame; the ADC
+// task filters the last ADC_FILTER_LEN frames per channel and runs the
+// protection check. Readers only load the cached result, never touch the
+// ADC.
+enum AdcChannel : uint8_t {
+  ADC_VBUS,
+  ADC_VOUT,
+  ADC_CHANNEL_COUNT
+};
+
+struct AdcStats {
+  uint32_t frames;       // Frames filtered
+  uint32_t readErrors;   // Frame-ready callbacks with no frame to read
+};
+
+// Pin millivolts to rail millivolts through a DIVIDER_Q16 ratio, rounded
+static inline uint32_t railMillivolts(uint32_t pinMv, uint32_t ratioQ16) {
+  return (pinMv * ratioQ16 + 32768) >> 16;
+}
+
+// Start the ADC task and continuous conversion, and register the frame
+// event; in setup(), before the control task starts
+bool beginAdcSampler();
+
+// Latest filtered rail voltage in millivolts; 0 until the first frame
+uint32_t getAdcMillivolts(uint8_t channel);
+
+// Latest unfiltered frame, for comparison
+uint32_t getAdcRawMillivolts(uint8_t channel);
+
+// Restart a sampler paused by low-power mode right away, rather than at the
+// next ADC_LOW_POWER_INTERVAL. Control task only.
+void resumeAdcSampler();
+
+const AdcStats& getAdcStats();
+
+#endif
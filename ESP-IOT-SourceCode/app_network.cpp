@@ -1,108 +1,232 @@
 #include "app_network.h"
-#include "storage.h"
+#include "journal.h"
+#include "scheduler.h"
+#include "timekeeping.h"
+#include "control.h"
+#include "perf.h"
 #include <WiFi.h>
+#include <esp_sntp.h>
 #include <time.h>
 
+// ============================================================================
+// WiFi State Machine
+// ============================================================================
+// The radio is never waited on. WiFi.begin() starts an attempt, and the
+// outcome arrives as an Arduino network event; wifiLoop() then moves
+// between the states. Failed attempts back off exponentially, with jitter
+// so a fleet doesn't retry in lockstep after an AP reboot.
+static WiFiState wifiState = WIFI_STATE_IDLE;
+static unsigned long stateSince = 0;
+static uint32_t backoffMs = WIFI_BACKOFF_MIN;  // Next backoff before jitter
+static uint32_t retryDelayMs = 0;              // Current backoff with jitter
+static uint32_t attempts = 0;
+
+// Set from the network event task, consumed by wifiLoop()
+static volatile bool linkUp = false;
+static volatile bool linkDown = false;
+static volatile uint8_t disconnectReason = 0;
+static volatile bool timeSynced = false;
+// Set around our own WiFi.disconnect(); the disconnect event it causes
+// arrives later on the event task and is not a lost link
+static volatile bool selfDisconnect = false;
+
+static void applySyncedTime(void *ctx);
+
+static WiFiHook hooks[WIFI_MAX_HOOKS];
+static uint8_t hookCount = 0;
+
+static void onWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+    selfDisconnect = false;
+    linkUp = true;
+  } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+    // Only react to the AP or the radio dropping the link. The AP may send
+    // ASSOC_LEAVE too, so the reason alone does not tell us apart.
+    if (selfDisconnect) {
+      selfDisconnect = false;
+      return;
+    }
+    disconnectReason = info.wifi_sta_disconnected.reason;
+    linkDown = true;
+  }
+}
+
+static void onTimeSync(struct timeval *tv) {
+  timeSynced = true;
+}
+
+static void enterState(WiFiState state) {
+  wifiState = state;
+  stateSince = millis();
+}
+
+static void startAttempt() {
+  Serial.print(F("Connecting to WiFi: "));
+  Serial.println(config.ssid);
+  linkUp = false;
+  linkDown = false;
+  attempts++;
+  WiFi.begin(config.ssid, config.password);
+  enterState(WIFI_STATE_CONNECTING);
+}
+
+// Drop the link without it counting as lost. A disconnect that raises no
+// event (nothing associated yet) leaves the flag set until the next link
+// comes up; a failed attempt is still caught by WIFI_CONNECT_TIMEOUT.
+static void disconnectSelf() {
+  selfDisconnect = true;
+  WiFi.disconnect();
+}
+
+static void enterBackoff() {
+  disconnectSelf();
+  wifiConnected = false;
+
+  // 75%..125% of the current step, then double the step up to the cap
+  retryDelayMs = backoffMs / 4 * 3 + random(backoffMs / 2 + 1);
+  backoffMs = backoffMs >= WIFI_BACKOFF_MAX / 2 ? WIFI_BACKOFF_MAX : backoffMs * 2;
+
+  Serial.print(F("WiFi connection failed (reason "));
+  Serial.print(disconnectReason);
+  Serial.print(F("), retrying in "));
+  Serial.print(retryDelayMs / 1000);
+  Serial.println(F("s"));
+  enterState(WIFI_STATE_BACKOFF);
+}
+
+void beginWiFi() {
+  WiFi.onEvent(onWiFiEvent);
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);   // Retries are paced by the backoff instead
+  sntp_set_time_sync_notification_cb(onTimeSync);
+}
+
+void addWiFiHook(WiFiHook hook) {
+  if (hookCount < WIFI_MAX_HOOKS) hooks[hookCount++] = hook;
+}
+
 void connectWiFi() {
   if (strlen(config.ssid) == 0) {
     Serial.println(F("No WiFi credentials configured."));
     return;
   }
+  // New credentials: drop any link or backoff and start over right away
+  if (wifiState != WIFI_STATE_IDLE) disconnectSelf();
+  wifiConnected = false;
+  backoffMs = WIFI_BACKOFF_MIN;
+  startAttempt();
+}
+
+void wifiLoop() {
+  PERF_SCOPE(PERF_WIFI);
+  if (linkDown) {
+    linkDown = false;
+    if (wifiState == WIFI_STATE_CONNECTED) {
+      Serial.println(F("WiFi connection lost."));
+      wifiConnected = false;
+      backoffMs = WIFI_BACKOFF_MIN;
+      startAttempt();
+    } else if (wifiState == WIFI_STATE_CONNECTING) {
+      enterBackoff();
+    }
+  }
   
-  Serial.print(F("Connecting to WiFi: "));
-  Serial.println(config.ssid);
-  
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(config.ssid, config.password);
+  if (linkUp) {
+    linkUp = false;
+    if (wifiState == WIFI_STATE_CONNECTING) {
+      enterState(WIFI_STATE_CONNECTED);
+      wifiConnected = true;
+      backoffMs = WIFI_BACKOFF_MIN;
+      Serial.print(F("WiFi connected! IP address: "));
+      Serial.println(WiFi.localIP());
+      for (uint8_t i = 0; i < hookCount; i++) hooks[i]();
+    }
+  }
   
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
+  if (timeSynced) {
+    timeSynced = false;
+    time_t synced = time(nullptr);
+    if (synced > 100000) {
+      runOnControl(applySyncedTime, &synced);
+      Serial.println(F("Time synchronized!"));
+    }
   }
   
-  if (WiFi.status() == WL_CONNECTED) {
-    wifiConnected = true;
-    Serial.println(F("\nWiFi connected!"));
-    Serial.print(F("IP address: "));
-    Serial.println(WiFi.localIP());
-    updateTime();
-  } else {
-    wifiConnected = false;
-    Serial.println(F("\nWiFi connection failed."));
+  unsigned long elapsed = millis() - stateSince;
+  switch (wifiState) {
+    case WIFI_STATE_IDLE:
+      if (strlen(config.ssid) > 0) startAttempt();
+      break;
+    case WIFI_STATE_CONNECTING:
+      if (elapsed >= WIFI_CONNECT_TIMEOUT) {
+        disconnectReason = 0;
+        enterBackoff();
+      }
+      break;
+    case WIFI_STATE_BACKOFF:
+      if (elapsed >= retryDelayMs) startAttempt();
+      break;
+    case WIFI_STATE_CONNECTED:
+      break;
+  }
+}
+
+WiFiState getWiFiState() {
+  return wifiState;
+}
+
+uint32_t wifiRetryIn() {
+  if (wifiState != WIFI_STATE_BACKOFF) return 0;
+  unsigned long elapsed = millis() - stateSince;
+  return elapsed >= retryDelayMs ? 0 : retryDelayMs - elapsed;
+}
+
+uint32_t wifiAttempts() {
+  return attempts;
+}
+
+const char *wifiStateName(WiFiState state) {
+  switch (state) {
+    case WIFI_STATE_CONNECTING: return "connecting";
+    case WIFI_STATE_CONNECTED: return "connected";
+    case WIFI_STATE_BACKOFF: return "backoff";
+    default: return "idle";
   }
 }
 
+// ============================================================================
+// Time
+// ============================================================================
+// Runs on the control task, which owns the clock and the schedules
+static void applySyncedTime(void *ctx) {
+  // The clock before the sync: the running clock, or after a reboot the
+  // last checkpoint from before the power loss
+  time_t previous = currentTime > 100000 ? currentTime : config.lastTime;
+  
+  currentTime = *(time_t *)ctx;
+  config.lastTime = currentTime;
+  journalPut(JOURNAL_LAST_TIME, currentTime);
+  catchUpSchedules(previous, currentTime);
+  invalidateSchedules();
+}
+
+// (Re)start SNTP. It runs in the background and re-syncs every
+// TIME_UPDATE_INTERVAL; each sync is applied by wifiLoop().
 void updateTime() {
   if (!wifiConnected) return;
   
   // Configure NTP with timezone offset
-  int tzOffset = 0;
-  String tz = String(config.timezone);
-  tz.toUpperCase();
-  
-  // Check for UTC+X or UTC-X format
-  if (tz.startsWith("UTC")) {
-    if (tz.length() > 3) {
-      String offsetStr = tz.substring(3);
-      tzOffset = offsetStr.toInt();
-    } else {
-      tzOffset = 0;
-    }
-  }
-  // Named timezones
-  else if (tz == "EST") tzOffset = -5;
-  else if (tz == "EDT") tzOffset = -4;
-  else if (tz == "CST") tzOffset = -6;
-  else if (tz == "CDT") tzOffset = -5;
-  else if (tz == "MST") tzOffset = -7;
-  else if (tz == "MDT") tzOffset = -6;
-  else if (tz == "PST") tzOffset = -8;
-  else if (tz == "PDT") tzOffset = -7;
-  else if (tz == "GMT") tzOffset = 0;
-  else if (tz == "CET") tzOffset = 1;
-  else if (tz == "CEST") tzOffset = 2;
-  else if (tz == "JST") tzOffset = 9;
-  else if (tz == "KST") tzOffset = 9;
-  else if (tz == "CNST") tzOffset = 8;
-  else if (tz == "AEST") tzOffset = 10;
-  else if (tz == "AEDT") tzOffset = 11;
-  else if (tz == "NZST") tzOffset = 12;
-  else if (tz == "NZDT") tzOffset = 13;
-  else if (tz == "IST") tzOffset = 5;
-  else if (tz == "HKT") tzOffset = 8;
-  else {
+  int tzOffset;
+  if (!getTimezoneOffset(tzOffset)) {
     Serial.print(F("WARN: Unknown timezone '"));
     Serial.print(config.timezone);
     Serial.println(F("', using UTC+0"));
-    tzOffset = 0;
   }
   
   configTime(tzOffset * 3600, 0, "pool.ntp.org", "time.nist.gov");
+  sntp_set_sync_interval(TIME_UPDATE_INTERVAL);
   
   Serial.print(F("Updating time (timezone: "));
   Serial.print(config.timezone);
   Serial.println(F(")..."));
-  
-  int attempts = 0;
-  while (time(nullptr) < 100000 && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-  Serial.println();
-  
-  currentTime = time(nullptr);
-  if (currentTime > 100000) {
-    config.lastTime = currentTime;
-    saveConfig();
-    Serial.println(F("Time synchronized!"));
-  } else {
-    Serial.println(F("Failed to get time from NTP."));
-    if (config.lastTime > 0) {
-      currentTime = config.lastTime;
-      Serial.println(F("Using last saved time."));
-    }
-  }
 }
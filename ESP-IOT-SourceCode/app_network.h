@@ -3,7 +3,31 @@
 
 #include "config.h"
 
+enum WiFiState : uint8_t {
+  WIFI_STATE_IDLE,        // No credentials
+  WIFI_STATE_CONNECTING,  // Attempt in progress
+  WIFI_STATE_CONNECTED,
+  WIFI_STATE_BACKOFF      // Waiting before the next attempt
+};
+
+// Called on the network task each time the connection comes up
+typedef void (*WiFiHook)();
+
+// Register the network event handlers. Nothing here waits on the radio;
+// wifiLoop() drives the connection from loop().
+void beginWiFi();
+void addWiFiHook(WiFiHook hook);
+void wifiLoop();
+
+// Start a fresh attempt now (e.g. after new credentials), resetting backoff
 void connectWiFi();
+
+WiFiState getWiFiState();
+const char *wifiStateName(WiFiState state);
+uint32_t wifiRetryIn();      // ms until the next attempt while backing off
+uint32_t wifiAttempts();
+
+// Restart SNTP with the configured timezone; returns immediately
 void updateTime();
 
 #endif
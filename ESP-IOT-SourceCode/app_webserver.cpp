@@ -2,690 +2,1351 @@
 #include "hardware.h"
 #include "storage.h"
 #include "app_network.h"
-#include <WebServer.h>
+#include "scheduler.h"
+#include "timers.h"
+#include "control.h"
+#include "event_loop.h"
+#include "buttons.h"
+#include "perf.h"
+#include "power.h"
+#include "telemetry.h"
+#include "protection.h"
+#include "index_html.h"
+#include "json_writer.h"
+#include "json_reader.h"
+#include "live.h"
+#include <esp_http_server.h>
+#include <lwip/sockets.h>
+#include <esp_timer.h>
+#include <esp_cpu.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <WiFi.h>
 
-WebServer server(80);
-
-// HTML page
-const char INDEX_HTML[] PROGMEM = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>IOT Switch Control</title>
-  <style>
-    * { margin: 0; padding: 0; box-sizing: border-box; }
-    body { 
-      font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif; 
-      background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-      min-height: 100vh;
-      padding: 20px;
-    }
-    .container { 
-      max-width: 800px; 
-      margin: 0 auto; 
-      background: white; 
-      border-radius: 12px; 
-      padding: 30px;
-      box-shadow: 0 20px 60px rgba(0,0,0,0.3);
-    }
-    h1 { 
-      color: #667eea; 
-      margin-bottom: 10px;
-      font-size: 2em;
-    }
-    .subtitle { 
-      color: #666; 
-      margin-bottom: 30px; 
-      font-size: 0.9em;
-    }
-    .section { 
-      margin-bottom: 30px; 
-      padding: 20px; 
-      background: #f8f9fa; 
-      border-radius: 8px;
-    }
-    .section h2 { 
-      color: #333; 
-      margin-bottom: 15px;
-      font-size: 1.3em;
-      border-bottom: 2px solid #667eea;
-      padding-bottom: 8px;
-    }
-    .status-grid {
-      display: grid;
-      grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-      gap: 15px;
-      margin-top: 15px;
-    }
-    .status-item {
-      background: white;
-      padding: 12px;
-      border-radius: 6px;
-      border-left: 4px solid #667eea;
-    }
-    .status-label { 
-      font-size: 0.85em; 
-      color: #666; 
-      margin-bottom: 5px;
-    }
-    .status-value { 
-      font-size: 1.1em; 
-      font-weight: bold; 
-      color: #333;
-    }
-    .button-group { 
-      display: flex; 
-      gap: 10px; 
-      flex-wrap: wrap;
-      margin-top: 15px;
-    }
-    button { 
-      padding: 12px 24px; 
-      font-size: 16px; 
-      border: none; 
-      border-radius: 6px; 
-      cursor: pointer;
-      font-weight: 600;
-      transition: all 0.3s;
-      flex: 1;
-      min-width: 120px;
-    }
-    .btn-on { 
-      background: #10b981; 
-      color: white;
-    }
-    .btn-on:hover { 
-      background: #059669;
-      transform: translateY(-2px);
-      box-shadow: 0 4px 12px rgba(16, 185, 129, 0.4);
-    }
-    .btn-off { 
-      background: #ef4444; 
-      color: white;
-    }
-    .btn-off:hover { 
-      background: #dc2626;
-      transform: translateY(-2px);
-      box-shadow: 0 4px 12px rgba(239, 68, 68, 0.4);
-    }
-    .btn-primary { 
-      background: #667eea; 
-      color: white;
-    }
-    .btn-primary:hover { 
-      background: #5568d3;
-      transform: translateY(-2px);
-      box-shadow: 0 4px 12px rgba(102, 126, 234, 0.4);
-    }
-    .btn-danger { 
-      background: #f59e0b; 
-      color: white;
-    }
-    .btn-danger:hover { 
-      background: #d97706;
-      transform: translateY(-2px);
-      box-shadow: 0 4px 12px rgba(245, 158, 11, 0.4);
-    }
-    input, select { 
-      padding: 10px; 
-      width: 100%; 
-      margin-top: 8px; 
-      border: 2px solid #e5e7eb; 
-      border-radius: 6px;
-      font-size: 14px;
-      transition: border-color 0.3s;
-    }
-    input:focus, select:focus { 
-      outline: none; 
-      border-color: #667eea;
-    }
-    .form-group { 
-      margin-bottom: 15px;
-    }
-    .form-group label { 
-      display: block; 
-      margin-bottom: 5px; 
-      font-weight: 600;
-      color: #333;
-    }
-    .schedule-item {
-      background: white;
-      padding: 12px;
-      margin-bottom: 10px;
-      border-radius: 6px;
-      display: flex;
-      justify-content: space-between;
-      align-items: center;
-      border-left: 4px solid #667eea;
-    }
-    .schedule-time { 
-      font-weight: bold; 
-      color: #667eea;
-      font-size: 1.1em;
-    }
-    .schedule-action { 
-      padding: 4px 12px; 
-      border-radius: 12px; 
-      font-size: 0.85em;
-      font-weight: 600;
-    }
-    .action-on { 
-      background: #d1fae5; 
-      color: #065f46;
-    }
-    .action-off { 
-      background: #fee2e2; 
-      color: #991b1b;
-    }
-    .power-state {
-      display: inline-block;
-      padding: 8px 20px;
-      border-radius: 20px;
-      font-weight: bold;
-      font-size: 1.2em;
-    }
-    .power-on { 
-      background: #d1fae5; 
-      color: #065f46;
-    }
-    .power-off { 
-      background: #fee2e2; 
-      color: #991b1b;
-    }
-    .refresh-btn {
-      background: #8b5cf6;
-      color: white;
-      padding: 8px 16px;
-      border-radius: 6px;
-      border: none;
-      cursor: pointer;
-      font-size: 0.9em;
-      float: right;
-    }
-    .refresh-btn:hover {
-      background: #7c3aed;
-    }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <h1>⚡ IOT Switch Control</h1>
-    <p class="subtitle">ESP32-C6 Dual Output Power Management System</p>
-
-    <div class="section">
-      <h2>📊 System Status 
-        <button class="refresh-btn" onclick="loadStatus()">🔄 Refresh</button>
-      </h2>
-      <div class="status-grid" id="statusGrid">
-        <div class="status-item">
-          <div class="status-label">Loading...</div>
-        </div>
-      </div>
-    </div>
-
-    <div class="section">
-      <h2>🔌 Power Jack Control</h2>
-      <div class="button-group">
-        <button class="btn-on" onclick="setPowerJack(true)">⚡ Enable Jack</button>
-        <button class="btn-off" onclick="setPowerJack(false)">🔴 Disable Jack</button>
-      </div>
-    </div>
-
-    <div class="section">
-      <h2>🔋 USB Output Control</h2>
-      <div class="button-group">
-        <button class="btn-on" onclick="setUSBOutput(true)">⚡ Enable USB</button>
-        <button class="btn-off" onclick="setUSBOutput(false)">🔴 Disable USB</button>
-      </div>
-    </div>
-
-    <div class="section">
-      <h2>⚙️ PD Voltage</h2>
-      <div class="button-group">
-        <button class="btn-primary" onclick="setPD(5)">5V</button>
-        <button class="btn-primary" onclick="setPD(9)">9V</button>
-        <button class="btn-primary" onclick="setPD(12)">12V</button>
-        <button class="btn-primary" onclick="setPD(15)">15V</button>
-        <button class="btn-primary" onclick="setPD(20)">20V</button>
-      </div>
-    </div>
-
-    <div class="section">
-      <h2>⏰ Schedule Manager</h2>
-      <div id="scheduleList"></div>
-      <div class="form-group" style="margin-top: 20px;">
-        <label>Add New Schedule (24-hour format):</label>
-        <input type="text" id="schedTime" placeholder="HHMM (e.g., 0730, 2315)" maxlength="4" 
-               pattern="[0-2][0-9][0-5][0-9]" style="font-family: monospace;">
-        <small style="display: block; margin-top: 5px; color: #666;">
-          Enter time as 4 digits: 0000-2359 (e.g., 0730 = 7:30 AM, 2315 = 11:15 PM)
-        </small>
-        <select id="schedAction" style="margin-top: 10px;">
-          <option value="1">Turn ON</option>
-          <option value="0">Turn OFF</option>
-        </select>
-        <button class="btn-primary" onclick="addSchedule()" style="margin-top: 10px; width: 100%;">
-          ➕ Add Schedule
-        </button>
-      </div>
-    </div>
-
-    <div class="section">
-      <h2>📡 WiFi Configuration</h2>
-      <div class="form-group">
-        <label>SSID:</label>
-        <input type="text" id="wifiSSID" placeholder="Network name">
-      </div>
-      <div class="form-group">
-        <label>Password:</label>
-        <input type="password" id="wifiPass" placeholder="Network password">
-      </div>
-      <button class="btn-primary" onclick="setWiFi()" style="width: 100%;">
-        💾 Save WiFi Settings
-      </button>
-    </div>
-
-    <div class="section">
-      <h2>🌍 Timezone</h2>
-      <div class="form-group">
-        <label>Timezone Code:</label>
-        <input type="text" id="timezone" placeholder="e.g., UTC+8, PST, JST">
-        <small style="display: block; margin-top: 5px; color: #666;">
-          Examples: UTC+8, UTC-5, EST, PST, JST, HKT
-        </small>
-      </div>
-      <button class="btn-primary" onclick="setTimezone()" style="width: 100%;">
-        💾 Save Timezone
-      </button>
-    </div>
-  </div>
-
-  <script>
-    function loadStatus() {
-      fetch('/api/status')
-        .then(r => r.json())
-        .then(data => {
-          const grid = document.getElementById('statusGrid');
-          const jackClass = data.powerJack ? 'power-on' : 'power-off';
-          const jackText = data.powerJack ? 'ENABLED' : 'DISABLED';
-          const usbClass = data.usbOutput ? 'power-on' : 'power-off';
-          const usbText = data.usbOutput ? 'ENABLED' : 'DISABLED';
-          
-          grid.innerHTML = `
-            <div class="status-item">
-              <div class="status-label">Power Jack</div>
-              <div class="status-value">
-                <span class="power-state ${jackClass}">${jackText}</span>
-              </div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">USB Output</div>
-              <div class="status-value">
-                <span class="power-state ${usbClass}">${usbText}</span>
-              </div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">VBUS Voltage</div>
-              <div class="status-value">${data.vbus.toFixed(2)} V</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">VOUT Voltage</div>
-              <div class="status-value">${data.vout.toFixed(2)} V</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">WiFi</div>
-              <div class="status-value">${data.wifi}</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">IP Address</div>
-              <div class="status-value">${data.ip}</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">Timezone</div>
-              <div class="status-value">${data.timezone}</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">Current Time</div>
-              <div class="status-value">${data.time}</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">PD Voltage</div>
-              <div class="status-value">${data.pdVoltage} V</div>
-            </div>
-            <div class="status-item">
-              <div class="status-label">Schedules</div>
-              <div class="status-value">${data.schedules} active</div>
-            </div>
-          `;
-          loadSchedules();
-        });
-    }
+// esp_http_server keeps up to HTTP_MAX_CONNECTIONS sockets open (HTTP/1.1
+// keep-alive, pipelined requests answered in order) and waits on all of them
+// from one task. Handlers therefore still run one at a time, which lets
+// them share the buffers below, but no longer on the loop task.
+static httpd_handle_t server = nullptr;
+static httpd_req_t *request;   // The request being handled
 
-    function loadSchedules() {
-      fetch('/api/schedules')
-        .then(r => r.json())
-        .then(data => {
-          const list = document.getElementById('scheduleList');
-          if (data.schedules.length === 0) {
-            list.innerHTML = '<p style="color: #666;">No schedules configured.</p>';
-            return;
-          }
-          list.innerHTML = data.schedules.map((s, i) => `
-            <div class="schedule-item">
-              <div>
-                <span class="schedule-time">${s.time}</span>
-                <span class="schedule-action action-${s.action}">${s.action}</span>
-              </div>
-              <button class="btn-danger" onclick="removeSchedule(${i})">🗑️ Remove</button>
-            </div>
-          `).join('');
-        });
-    }
+static const char *statusLine(int code) {
+  switch (code) {
+    case 200: return "200 OK";
+    case 304: return "304 Not Modified";
+    case 400: return "400 Bad Request";
+    case 404: return "404 Not Found";
+    case 409: return "409 Conflict";
+    case 413: return "413 Payload Too Large";
+    default: return "500 Internal Server Error";
+  }
+}
 
-    function setPowerJack(state) {
-      fetch('/api/powerjack', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({state: state})
-      }).then(() => loadStatus());
-    }
+static void sendResponse(int code, const char *type, const char *data, size_t len) {
+  httpd_resp_set_status(request, statusLine(code));
+  httpd_resp_set_type(request, type);
+  httpd_resp_send(request, data, len);
+}
 
-    function setUSBOutput(state) {
-      fetch('/api/usboutput', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({state: state})
-      }).then(() => loadStatus());
-    }
+static void sendJson(int code, const char *json) {
+  sendResponse(code, "application/json", json, strlen(json));
+}
 
-    function setPD(voltage) {
-      fetch('/api/pd', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({voltage: voltage})
-      }).then(() => {
-        alert('PD voltage set to ' + voltage + 'V');
-        loadStatus();
-      });
-    }
+// ============================================================================
+// JSON Responses
+// ============================================================================
+// A body that fits is sent in one piece with its length; a longer one
+// switches to chunked transfer at the first flush.
+static char jsonBuf[JSON_CHUNK];
 
-    function addSchedule() {
-      const time = document.getElementById('schedTime').value;
-      const action = document.getElementById('schedAction').value;
-      if (!time) {
-        alert('Please enter a time');
-        return;
-      }
-      
-      // Validate 24-hour format (0000-2359)
-      const timeNum = parseInt(time);
-      if (time.length !== 4 || isNaN(timeNum)) {
-        alert('Please enter time as 4 digits (e.g., 0730, 2315)');
-        return;
-      }
-      
-      const hours = Math.floor(timeNum / 100);
-      const mins = timeNum % 100;
-      
-      if (hours > 23 || mins > 59) {
-        alert('Invalid time! Hours must be 00-23, minutes must be 00-59');
-        return;
-      }
-      
-      fetch('/api/schedule', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({time: time, action: parseInt(action)})
-      }).then(() => {
-        document.getElementById('schedTime').value = '';
-        loadStatus();
-      });
-    }
+class JsonReply : public JsonWriter {
+ public:
+  explicit JsonReply(int code = 200)
+      : JsonWriter(jsonBuf, sizeof(jsonBuf), sendChunk, this), code(code), chunked(false) {}
 
-    function removeSchedule(index) {
-      fetch('/api/schedule/' + index, {method: 'DELETE'})
-        .then(() => loadStatus());
+  void send() {
+    if (chunked) {
+      flush();
+      httpd_resp_send_chunk(request, nullptr, 0);
+    } else {
+      sendResponse(code, "application/json", data(), buffered());
     }
+  }
 
-    function setWiFi() {
-      const ssid = document.getElementById('wifiSSID').value;
-      const pass = document.getElementById('wifiPass').value;
-      if (!ssid) {
-        alert('Please enter SSID');
-        return;
-      }
-      fetch('/api/wifi', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({ssid: ssid, password: pass})
-      }).then(() => {
-        alert('WiFi settings saved. Device will restart.');
-      });
+ private:
+  static void sendChunk(void *ctx, const char *data, size_t len) {
+    JsonReply *r = (JsonReply *)ctx;
+    if (!r->chunked) {
+      httpd_resp_set_status(request, statusLine(r->code));
+      httpd_resp_set_type(request, "application/json");
+      r->chunked = true;
     }
+    httpd_resp_send_chunk(request, data, len);
+  }
 
-    function setTimezone() {
-      const tz = document.getElementById('timezone').value;
-      if (!tz) {
-        alert('Please enter timezone');
-        return;
-      }
-      fetch('/api/timezone', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({timezone: tz})
-      }).then(() => {
-        alert('Timezone saved');
-        loadStatus();
-      });
+  int code;
+  bool chunked;
+};
+
+static void sendError(int code, const char *message) {
+  JsonReply json(code);
+  json.beginObject();
+  json.addString("error", message);
+  json.endObject();
+  json.send();
+}
+
+static void sendSuccess() {
+  sendJson(200, "{\"success\":true}");
+}
+
+// ============================================================================
+// Request Bodies
+// ============================================================================
+// The reader points into requestBody, so both live until the next request
+static char requestBody[HTTP_BODY_MAX];
+static JsonReader body;
+
+// Read and tokenize the POST body; answers 400 (413 if it does not fit) and
+// returns false when it is missing or not a well-formed JSON object
+static bool parseBody() {
+  size_t len = request->content_len;
+  if (len == 0) {
+    sendError(400, "Missing body");
+    return false;
+  }
+  if (len > sizeof(requestBody)) {
+    sendError(413, "Body too large");
+    return false;
+  }
+  for (size_t got = 0; got < len;) {
+    int n = httpd_req_recv(request, requestBody + got, len - got);
+    if (n <= 0) {
+      // The server closes the connection; nobody is left to answer
+      return false;
     }
+    got += n;
+  }
+  if (!body.parse(requestBody, len)) {
+    char message[64];
+    snprintf(message, sizeof(message), "Malformed JSON: %s", body.error());
+    sendError(400, message);
+    return false;
+  }
+  return true;
+}
+
+// Shared with the parser self-check in benchRequestParsing()
+static bool readPDVoltage(const JsonReader &r, uint8_t &volts) {
+  int32_t v;
+  if (!r.getInt("voltage", v, 0, 255) || !isValidPDVoltage(v)) return false;
+  volts = v;
+  return true;
+}
 
-    // Auto-refresh status every 10 seconds
-    setInterval(loadStatus, 10000);
-    loadStatus();
-  </script>
-</body>
-</html>
-)rawliteral";
+static bool readOutputState(const JsonReader &r, bool &state) {
+  return r.getBool("state", state);
+}
+
+// "HHMM", 0000-2359
+static bool parseHHMM(const char *text, uint16_t &time) {
+  size_t n = strlen(text);
+  if (n != 4) return false;
+  for (size_t i = 0; i < n; i++) {
+    if (text[i] < '0' || text[i] > '9') return false;
+  }
+  time = atoi(text);
+  return time <= 2359 && time % 100 <= 59;
+}
 
 // API Handlers
+// The page is stored gzipped (index_html.h, built from web/index.html by
+// tools/embed_ui.py). Browsers revalidate on each load and get a 304 while
+// the ETag still matches, so a refresh costs one small round trip.
 void handleRoot() {
-  server.send(200, "text/html", INDEX_HTML);
+  httpd_resp_set_hdr(request, "ETag", INDEX_HTML_ETAG);
+  httpd_resp_set_hdr(request, "Cache-Control", "no-cache");
+  char tag[sizeof(INDEX_HTML_ETAG)];
+  if (httpd_req_get_hdr_value_str(request, "If-None-Match", tag, sizeof(tag)) == ESP_OK &&
+      strcmp(tag, INDEX_HTML_ETAG) == 0) {
+    sendResponse(304, "text/html", "", 0);
+    return;
+  }
+  httpd_resp_set_hdr(request, "Content-Encoding", "gzip");
+  sendResponse(200, "text/html", (const char *)INDEX_HTML_GZ, INDEX_HTML_GZ_LEN);
 }
 
-void handleStatus() {
+static void writeStatus(JsonWriter &json) {
   char timeStr[30] = "Not synced";
   if (currentTime > 100000) {
     struct tm *timeinfo = localtime(&currentTime);
     strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", timeinfo);
   }
+  IPAddress ip = WiFi.localIP();
+  char ipStr[16];
+  snprintf(ipStr, sizeof(ipStr), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
   
-  String json = "{";
-  json += "\"powerJack\":" + String(powerJackState ? "true" : "false") + ",";
-  json += "\"usbOutput\":" + String(usbOutputState ? "true" : "false") + ",";
-  json += "\"vbus\":" + String(getVBusVoltage(), 2) + ",";
-  json += "\"vout\":" + String(getVOutVoltage(), 2) + ",";
-  json += "\"wifi\":\"" + String(wifiConnected ? "Connected" : "Disconnected") + "\",";
-  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
-  json += "\"timezone\":\"" + String(config.timezone) + "\",";
-  json += "\"time\":\"" + String(timeStr) + "\",";
-  json += "\"pdVoltage\":" + String(config.pdVoltage) + ",";
-  json += "\"schedules\":" + String(config.scheduleCount);
-  json += "}";
-  
-  server.send(200, "application/json", json);
+  json.beginObject();
+  json.addBool("powerJack", powerJackState);
+  json.addBool("usbOutput", usbOutputState);
+  uint32_t vbusMv = getVBusMillivolts();
+  uint32_t voutMv = getVOutMillivolts();
+  char volts[12];
+  formatVolts(volts, vbusMv);
+  json.addRaw("vbus", volts);
+  formatVolts(volts, voutMv);
+  json.addRaw("vout", volts);
+  json.addUint("vbusMv", vbusMv);
+  json.addUint("voutMv", voutMv);
+  json.addString("wifi", wifiConnected ? "Connected" : "Disconnected");
+  json.addString("ip", ipStr);
+  json.addString("timezone", config.timezone);
+  json.addString("time", timeStr);
+  json.addUint("pdVoltage", config.pdVoltage);
+  const PDStatus &pd = getPDStatus();
+  json.addString("pdState", pdStateName(pd.state));
+  json.addUint("pdSettleMs", pd.settleMs);
+  json.addUint("pdFailures", pd.failures);
+  json.addString("jackFault", protectFaultName(getProtectStats().outputs[PROTECT_JACK].latched));
+  json.addString("usbFault", protectFaultName(getProtectStats().outputs[PROTECT_USB].latched));
+  json.addUint("schedules", config.scheduleCount);
+  json.addUint("timers", getTimerCount());
+  json.addUint("flashCommits", getStorageStats().commits);
+  json.addUint("flashBytesWritten", getStorageStats().bytesWritten);
+  json.addUint("flashBytesChanged", getStorageStats().bytesChanged);
+  json.addUint("controlLatencyMaxUs", getEventLoopStats().maxLatencyUs);
+  json.addUint("buttonLatencyMaxUs", getButtonStats().maxLatencyUs);
+  json.addUint("telemetryBytes", telemetryMemoryBytes());
+  json.addUint("heapFree", ESP.getFreeHeap());
+  json.addUint("heapMinFree", ESP.getMinFreeHeap());
+  json.addUint("heapMaxBlock", ESP.getMaxAllocHeap());
+  const PowerStats &ps = getPowerStats();
+  uint64_t spanUs = esp_timer_get_time() - ps.startUs;
+  json.addBool("lowPower", config.lowPower);
+  json.addBool("lightSleep", ps.lightSleep);
+  if (ps.sleepTracked && spanUs > 0) json.addFixed("sleepPercent", ps.sleptUs * 1000 / spanUs, 1);
+  else json.addNull("sleepPercent");
+  json.endObject();
+}
+
+void handleStatus() {
+  JsonReply json;
+  writeStatus(json);
+  json.send();
 }
 
 void handleGetSchedules() {
-  String json = "{\"schedules\":[";
+  JsonReply json;
+  json.beginObject();
+  json.beginArray("schedules");
   for (int i = 0; i < config.scheduleCount; i++) {
-    if (i > 0) json += ",";
-    uint16_t t = config.schedules[i].time;
+    const Schedule &sched = config.schedules[i];
     char timeStr[6];
-    sprintf(timeStr, "%02d:%02d", t / 100, t % 100);
-    json += "{\"time\":\"" + String(timeStr) + "\",";
-    json += "\"action\":\"" + String(config.schedules[i].action ? "ON" : "OFF") + "\"}";
+    sprintf(timeStr, "%02d:%02d", sched.time / 100, sched.time % 100);
+    char actionStr[6];
+    if (sched.target == SCHEDULE_TARGET_PD) sprintf(actionStr, "%dV", sched.action);
+    else strcpy(actionStr, sched.action ? "ON" : "OFF");
+    char days[32];
+    formatScheduleDays(sched.days, days, sizeof(days));
+    json.beginObject();
+    json.addString("time", timeStr);
+    json.addString("action", actionStr);
+    json.addString("target", scheduleTargetName(sched.target));
+    json.addUint("days", sched.days);
+    json.addString("daysText", days);
+    json.endObject();
   }
-  json += "]}";
-  server.send(200, "application/json", json);
+  json.endArray();
+  json.addUint("max", MAX_SCHEDULES);
+  json.endObject();
+  json.send();
+}
+
+// Switch-on refused by a latched protection fault
+static void sendHeldOff(const char *output, ProtectOutput protect) {
+  char message[48];
+  snprintf(message, sizeof(message), "%s held off by %s fault", output,
+           protectFaultName(getProtectStats().outputs[protect].latched));
+  sendError(409, message);
 }
 
 void handleSetPowerJack() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    bool state = body.indexOf("true") > 0;
-    setPowerJackState(state);
-    server.send(200, "application/json", "{\"success\":true}");
-  } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+  bool state;
+  if (!parseBody()) return;
+  if (!readOutputState(body, state)) {
+    sendError(400, "state must be true or false");
+    return;
   }
+  if (!setPowerJackState(state)) {
+    sendHeldOff("powerjack", PROTECT_JACK);
+    return;
+  }
+  sendSuccess();
 }
 
 void handleSetUSBOutput() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    bool state = body.indexOf("true") > 0;
-    setUSBOutputState(state);
-    server.send(200, "application/json", "{\"success\":true}");
-  } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+  bool state;
+  if (!parseBody()) return;
+  if (!readOutputState(body, state)) {
+    sendError(400, "state must be true or false");
+    return;
   }
+  if (!setUSBOutputState(state)) {
+    sendHeldOff("usboutput", PROTECT_USB);
+    return;
+  }
+  sendSuccess();
 }
 
 void handleSetPD() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    int voltage = 9;
-    if (body.indexOf("\"voltage\":5") > 0) voltage = 5;
-    else if (body.indexOf("\"voltage\":9") > 0) voltage = 9;
-    else if (body.indexOf("\"voltage\":12") > 0) voltage = 12;
-    else if (body.indexOf("\"voltage\":15") > 0) voltage = 15;
-    else if (body.indexOf("\"voltage\":20") > 0) voltage = 20;
-    setPDVoltage(voltage);
-    server.send(200, "application/json", "{\"success\":true}");
-  } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+  uint8_t voltage;
+  if (!parseBody()) return;
+  if (!readPDVoltage(body, voltage)) {
+    sendError(400, "voltage must be 5, 9, 12, 15 or 20");
+    return;
   }
+  setPDVoltage(voltage);
+  // Returns before VBUS settles; pdState in /api/status has the outcome
+  sendJson(200, "{\"success\":true,\"pdState\":\"settling\"}");
 }
 
 void handleAddSchedule() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    
-    // Parse time
-    int timeIdx = body.indexOf("\"time\":\"") + 8;
-    int timeEnd = body.indexOf("\"", timeIdx);
-    String timeStr = body.substring(timeIdx, timeEnd);
-    uint16_t schedTime = timeStr.toInt();
-    
-    // Parse action
-    int actionIdx = body.indexOf("\"action\":") + 9;
-    uint8_t action = body.substring(actionIdx, actionIdx + 1).toInt();
-    
-    if (config.scheduleCount < 10) {
-      config.schedules[config.scheduleCount].time = schedTime;
-      config.schedules[config.scheduleCount].action = action;
-      config.scheduleCount++;
-      saveConfig();
-      server.send(200, "application/json", "{\"success\":true}");
+  if (!parseBody()) return;
+  Schedule sched;
+  char text[32];
+  int32_t v;
+  
+  if (!body.getString("time", text, sizeof(text)) || !parseHHMM(text, sched.time)) {
+    sendError(400, "Invalid time");
+    return;
+  }
+  
+  // 0/1, or volts for the pd target
+  if (!body.getInt("action", v, 0, 255)) {
+    sendError(400, "Invalid action");
+    return;
+  }
+  sched.action = v;
+  
+  sched.target = SCHEDULE_TARGET_BOTH;
+  if (body.has("target") &&
+      (!body.getString("target", text, sizeof(text)) || !parseScheduleTarget(text, sched.target))) {
+    sendError(400, "Invalid target");
+    return;
+  }
+  
+  // A weekday bitmask or text such as "weekdays"
+  sched.days = SCHEDULE_DAYS_ALL;
+  if (body.has("days")) {
+    bool valid;
+    if (body.isString("days")) {
+      valid = body.getString("days", text, sizeof(text)) && parseScheduleDays(text, sched.days);
     } else {
-      server.send(400, "application/json", "{\"error\":\"Schedule list full\"}");
+      valid = body.getInt("days", v, 1, SCHEDULE_DAYS_ALL);
+      sched.days = v;
+    }
+    if (!valid) {
+      sendError(400, "Invalid days");
+      return;
     }
+  }
+  
+  if (sched.target == SCHEDULE_TARGET_PD ? !isValidPDVoltage(sched.action) : sched.action > 1) {
+    sendError(400, "Invalid action");
+  } else if (addSchedule(sched)) {
+    sendSuccess();
   } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+    sendError(400, "Schedule list full");
   }
 }
 
+// DELETE /api/schedule/<index>
+// The last path segment as a number in 0..max. Anything else ("", "abc",
+// "3x", "-1", too large) is false, rather than atoi()'s 0. A query string
+// is ignored.
+static bool pathNumber(long max, long &value) {
+  const char *uri = request->uri;
+  size_t pathLen = strcspn(uri, "?");
+  const char *s = uri + pathLen;
+  while (s > uri && s[-1] != '/') s--;
+  if (!isdigit((uint8_t)*s)) return false;
+  char *end;
+  value = strtol(s, &end, 10);
+  return end == uri + pathLen && value <= max;
+}
+
 void handleRemoveSchedule() {
-  String uri = server.uri();
-  int index = uri.substring(uri.lastIndexOf('/') + 1).toInt();
+  long index;
+  if (!pathNumber(MAX_SCHEDULES - 1, index)) {
+    sendJson(400, "{\"error\":\"Invalid index\"}");
+    return;
+  }
+  
+  if (removeSchedule(index)) {
+    sendJson(200, "{\"success\":true}");
+  } else {
+    sendJson(400, "{\"error\":\"Invalid index\"}");
+  }
+}
+
+void handleAddTimer() {
+  if (!parseBody()) return;
+  char text[16];
+  uint8_t target;
+  uint32_t delayMs;
+  if (!body.getString("target", text, sizeof(text)) || !parseScheduleTarget(text, target) ||
+      target == SCHEDULE_TARGET_PD) {
+    sendError(400, "Invalid target");
+    return;
+  }
+  // Seconds as a number, or text with a unit ("15m")
+  bool haveDelay = body.isString("delay") ? body.getString("delay", text, sizeof(text))
+                                          : body.getNumberText("delay", text, sizeof(text));
+  if (!haveDelay || !parseDuration(text, delayMs)) {
+    sendError(400, "Invalid delay");
+    return;
+  }
+  bool repeat = false;
+  if (body.has("repeat") && !body.getBool("repeat", repeat)) {
+    sendError(400, "repeat must be true or false");
+    return;
+  }
   
-  if (index >= 0 && index < config.scheduleCount) {
-    for (int i = index; i < config.scheduleCount - 1; i++) {
-      config.schedules[i] = config.schedules[i + 1];
+  uint8_t action;
+  int id;
+  if (!body.getString("action", text, sizeof(text))) {
+    sendError(400, "Invalid action");
+    return;
+  } else if (strcmp(text, "cycle") == 0) {
+    id = startPowerCycle(target, delayMs);
+  } else if (parseTimerAction(text, action)) {
+    if (repeat && delayMs < TIMER_MIN_PERIOD) {
+      sendError(400, "Repeat period too short");
+      return;
     }
-    config.scheduleCount--;
-    saveConfig();
-    server.send(200, "application/json", "{\"success\":true}");
+    id = addTimer(target, action, delayMs, repeat ? delayMs : 0);
   } else {
-    server.send(400, "application/json", "{\"error\":\"Invalid index\"}");
+    sendError(400, "Invalid action");
+    return;
+  }
+  
+  if (id < 0) {
+    sendError(400, "Timer table full");
+  } else {
+    JsonReply json;
+    json.beginObject();
+    json.addBool("success", true);
+    json.addInt("id", id);
+    json.endObject();
+    json.send();
   }
 }
 
-void handleSetWiFi() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    
-    // Parse SSID
-    int ssidIdx = body.indexOf("\"ssid\":\"") + 8;
-    int ssidEnd = body.indexOf("\"", ssidIdx);
-    String ssid = body.substring(ssidIdx, ssidEnd);
-    
-    // Parse password
-    int passIdx = body.indexOf("\"password\":\"") + 12;
-    int passEnd = body.indexOf("\"", passIdx);
-    String password = body.substring(passIdx, passEnd);
-    
-    ssid.toCharArray(config.ssid, 64);
-    password.toCharArray(config.password, 64);
-    saveConfig();
+void handleGetTimers() {
+  OutputTimer timers[TIMER_MAX];
+  uint8_t count = copyTimers(timers);
+  JsonReply json;
+  json.beginObject();
+  json.beginArray("timers");
+  for (uint8_t i = 0; i < count; i++) {
+    const OutputTimer &t = timers[i];
+    json.beginObject();
+    json.addInt("id", t.id);
+    json.addString("target", scheduleTargetName(t.target));
+    json.addString("action", timerActionName(t.action));
+    json.addUint("remainingMs", timerRemaining(t));
+    json.addUint("periodMs", t.periodMs);
+    json.endObject();
+  }
+  json.endArray();
+  json.addUint("max", TIMER_MAX);
+  json.endObject();
+  json.send();
+}
+
+void handleGetMetrics() {
+  uint32_t windowMs = perfWindowMs();
+  JsonReply json;
+  json.beginObject();
+  json.addBool("enabled", PERF_ENABLED);
+  json.addUint("windowMs", windowMs);
+  json.addUint("cpuMhz", getCpuFrequencyMhz());
+  json.beginArray("stages");
+  for (uint8_t i = 0; i < PERF_STAGE_COUNT; i++) {
+    const PerfStats &s = getPerfStats(i);
+    json.beginObject();
+    json.addString("name", perfStageName(i));
+    json.addUint("count", s.count);
+    json.addFixed("ratePerSec", windowMs > 0 ? (uint64_t)s.count * 10000 / windowMs : 0, 1);
+    json.addUint("avgUs", s.count > 0 ? perfCyclesToUs(s.totalCycles / s.count) : 0);
+    json.addUint("p50Us", perfCyclesToUs(perfPercentileCycles(s, 50)));
+    json.addUint("p99Us", perfCyclesToUs(perfPercentileCycles(s, 99)));
+    json.addUint("maxUs", perfCyclesToUs(s.maxCycles));
     
-    server.send(200, "application/json", "{\"success\":true}");
-    delay(1000);
-    ESP.restart();
+    // Buckets by log2 of the cycle count, trailing empty buckets trimmed
+    int last = PERF_BUCKETS - 1;
+    while (last >= 0 && s.buckets[last] == 0) last--;
+    json.beginArray("histogram");
+    for (int b = 0; b <= last; b++) json.addUint(nullptr, s.buckets[b]);
+    json.endArray();
+    json.endObject();
+  }
+  json.endArray();
+  json.endObject();
+  json.send();
+}
+
+void handleResetMetrics() {
+  perfReset();
+  sendJson(200, "{\"success\":true}");
+}
+
+static void historyValue(JsonWriter &json, int16_t mv) {
+  if (mv == TELEMETRY_NONE) json.addNull(nullptr);
+  else json.addInt(nullptr, mv);
+}
+
+// Value of ?key= in the request URL; false when absent or too long
+static bool queryArg(const char *key, char *out, size_t size) {
+  char query[96];
+  return httpd_req_get_url_query_str(request, query, sizeof(query)) == ESP_OK &&
+         httpd_query_key_value(query, key, out, size) == ESP_OK;
+}
+
+// GET /api/history?tier=fine|coarse[&last=<s>][&from=<t>][&to=<t>]
+// Times are unix seconds once the clock is synced, uptime seconds before.
+void handleHistory() {
+  char tierStr[8] = "fine";
+  char arg[16];
+  queryArg("tier", tierStr, sizeof(tierStr));
+  uint8_t tier;
+  if (strcmp(tierStr, "fine") == 0) {
+    tier = TELEMETRY_FINE;
+  } else if (strcmp(tierStr, "coarse") == 0) {
+    tier = TELEMETRY_COARSE;
+  } else {
+    sendJson(400, "{\"error\":\"tier must be fine or coarse\"}");
+    return;
+  }
+
+  bool unixClock = currentTime > 100000;
+  int64_t offset = unixClock ? (int64_t)currentTime - telemetryUptime() : 0;
+  uint32_t period = telemetryPeriod(tier);
+
+  uint32_t first = 0, last = 0;
+  bool any = telemetryRange(tier, first, last);
+  if (any && queryArg("last", arg, sizeof(arg))) {
+    int64_t since = (int64_t)telemetryUptime() - atoll(arg);
+    if (since > (int64_t)first * period) first = since / period;
+  }
+  if (any && queryArg("from", arg, sizeof(arg))) {
+    int64_t from = atoll(arg) - offset;
+    if (from > (int64_t)first * period) first = from / period;
+  }
+  if (any && queryArg("to", arg, sizeof(arg))) {
+    int64_t to = atoll(arg) - offset;
+    if (to < 0) any = false;
+    else if (to / period < last) last = to / period;
+  }
+  uint32_t count = any && first <= last ? last - first + 1 : 0;
+
+  // A day of rows streams through the JSON_CHUNK buffer
+  JsonReply json;
+  json.beginObject();
+  json.addString("tier", tierStr);
+  json.addUint("period", period);
+  json.addString("clock", unixClock ? "unix" : "uptime");
+  json.addInt("start", count > 0 ? (int64_t)first * period + offset : 0);
+  json.addUint("count", count);
+  json.addString("unit", "mV");
+  json.addUint("memoryBytes", telemetryMemoryBytes());
+  json.beginArray("columns");
+  if (tier == TELEMETRY_FINE) {
+    json.addString(nullptr, "vbus");
+    json.addString(nullptr, "vout");
+  } else {
+    static const char *const names[] = { "vbusMin", "vbusAvg", "vbusMax", "voutMin", "voutAvg", "voutMax" };
+    for (uint8_t c = 0; c < 6; c++) json.addString(nullptr, names[c]);
+  }
+  json.endArray();
+
+  json.beginArray("rows");
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t slot = first + i;
+    json.beginArray();
+    if (tier == TELEMETRY_FINE) {
+      FineSample s;
+      if (!getFineSample(slot, s)) s.mv[ADC_VBUS] = s.mv[ADC_VOUT] = TELEMETRY_NONE;
+      historyValue(json, s.mv[ADC_VBUS]);
+      historyValue(json, s.mv[ADC_VOUT]);
+    } else {
+      CoarseSample s;
+      bool valid = getCoarseSample(slot, s);
+      for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+        historyValue(json, valid ? s.min[ch] : TELEMETRY_NONE);
+        historyValue(json, valid ? s.avg[ch] : TELEMETRY_NONE);
+        historyValue(json, valid ? s.max[ch] : TELEMETRY_NONE);
+      }
+    }
+    json.endArray();
+  }
+  json.endArray();
+  json.endObject();
+  json.send();
+}
+
+// DELETE /api/timer/<id>, or /api/timer/all
+void handleCancelTimer() {
+  const char *id = strrchr(request->uri, '/') + 1;
+  long number;
+  
+  if (strcmp(id, "all") == 0) {
+    cancelAllTimers();
+    sendJson(200, "{\"success\":true}");
+  } else if (!pathNumber(UINT16_MAX, number)) {
+    sendJson(400, "{\"error\":\"Invalid timer id\"}");
+  } else if (cancelTimer(number)) {
+    sendJson(200, "{\"success\":true}");
   } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+    sendJson(404, "{\"error\":\"No such timer\"}");
   }
 }
 
+void handleSetWiFi() {
+  if (!parseBody()) return;
+  struct Credentials {
+    char ssid[sizeof(config.ssid)];
+    char password[sizeof(config.password)];
+  } credentials;
+  if (!body.getString("ssid", credentials.ssid, sizeof(credentials.ssid)) || credentials.ssid[0] == '\0') {
+    sendError(400, "ssid must be a string of 1-63 bytes");
+    return;
+  }
+  if (!body.getString("password", credentials.password, sizeof(credentials.password))) {
+    sendError(400, "password must be a string of up to 63 bytes");
+    return;
+  }
+  
+  runOnControl([](void *arg) {
+    Credentials *c = (Credentials *)arg;
+    memcpy(config.ssid, c->ssid, sizeof(config.ssid));
+    memcpy(config.password, c->password, sizeof(config.password));
+    saveConfig();
+  }, &credentials);
+  
+  sendSuccess();
+  flushConfig();
+  delay(1000);
+  ESP.restart();
+}
+
 void handleSetTimezone() {
-  if (server.hasArg("plain")) {
-    String body = server.arg("plain");
-    
-    int tzIdx = body.indexOf("\"timezone\":\"") + 12;
-    int tzEnd = body.indexOf("\"", tzIdx);
-    String tz = body.substring(tzIdx, tzEnd);
-    
-    tz.toCharArray(config.timezone, 8);
+  if (!parseBody()) return;
+  char tz[sizeof(config.timezone)];
+  if (!body.getString("timezone", tz, sizeof(tz)) || tz[0] == '\0') {
+    sendError(400, "timezone must be a code of 1-7 characters");
+    return;
+  }
+  
+  runOnControl([](void *arg) {
+    memcpy(config.timezone, arg, sizeof(config.timezone));
     saveConfig();
-    
-    if (wifiConnected) {
-      updateTime();
+    invalidateSchedules();
+  }, tz);
+  
+  if (wifiConnected) {
+    updateTime();
+  }
+  
+  sendSuccess();
+}
+
+void handleSetPower() {
+  if (!parseBody()) return;
+  bool enabled;
+  if (!body.getBool("lowPower", enabled)) {
+    sendError(400, "lowPower must be true or false");
+    return;
+  }
+  bool ok = setLowPowerMode(enabled);
+  JsonReply json;
+  json.beginObject();
+  json.addBool("success", true);
+  json.addBool("lightSleep", ok && enabled);
+  json.endObject();
+  json.send();
+}
+
+void handleGetProtection() {
+  const ProtectStats &ps = getProtectStats();
+  JsonReply json;
+  json.beginObject();
+  json.addUint("pdMarginPercent", PROTECT_PD_MARGIN);
+  json.addUint("maxReactionUs", ps.maxReactionUs);
+  json.beginArray("outputs");
+  for (uint8_t i = 0; i < PROTECT_OUTPUT_COUNT; i++) {
+    const ProtectOutputStats &s = ps.outputs[i];
+    json.beginObject();
+    json.addString("output", protectOutputName((ProtectOutput)i));
+    json.addUint("minMv", config.outputLimits[i].minMv);
+    json.addUint("maxMv", config.outputLimits[i].maxMv);
+    json.addString("fault", protectFaultName(s.latched));
+    json.addUint("faultMv", s.railMv);
+    json.addUint("faultLimitMv", s.limitMv);
+    json.addUint("ovpTrips", s.ovpTrips);
+    json.addUint("uvpTrips", s.uvpTrips);
+    json.endObject();
+  }
+  json.endArray();
+  json.endObject();
+  json.send();
+}
+
+// {"clear":true} and/or {"output":"jack","minMv":8500,"maxMv":9900}
+void handleSetProtection() {
+  if (!parseBody()) return;
+  char output[8];
+  if (body.has("output")) {
+    int32_t minMv, maxMv;
+    if (!body.getString("output", output, sizeof(output)) ||
+        (strcmp(output, "jack") != 0 && strcmp(output, "usb") != 0) ||
+        !body.getInt("minMv", minMv, 0, 30000) || !body.getInt("maxMv", maxMv, 0, 30000) ||
+        (maxMv > 0 && minMv >= maxMv)) {
+      sendError(400, "Invalid output or limits");
+      return;
     }
-    
-    server.send(200, "application/json", "{\"success\":true}");
-  } else {
-    server.send(400, "application/json", "{\"error\":\"Missing body\"}");
+    setProtectionLimits(strcmp(output, "jack") == 0 ? PROTECT_JACK : PROTECT_USB, minMv, maxMv);
+  }
+  bool clear = false;
+  if (body.has("clear") && !body.getBool("clear", clear)) {
+    sendError(400, "clear must be true or false");
+    return;
   }
+  if (clear) clearProtectionFaults();
+  handleGetProtection();
 }
 
-void setupWebServer() {
-  server.on("/", handleRoot);
-  server.on("/api/status", HTTP_GET, handleStatus);
-  server.on("/api/schedules", HTTP_GET, handleGetSchedules);
-  server.on("/api/powerjack", HTTP_POST, handleSetPowerJack);
-  server.on("/api/usboutput", HTTP_POST, handleSetUSBOutput);
-  server.on("/api/pd", HTTP_POST, handleSetPD);
-  server.on("/api/schedule", HTTP_POST, handleAddSchedule);
-  server.on("/api/timezone", HTTP_POST, handleSetTimezone);
-  server.on("/api/wifi", HTTP_POST, handleSetWiFi);
+// ============================================================================
+// Live Updates (/ws)
+// ============================================================================
+// The page opens a WebSocket on /ws and gets a JSON text frame whenever
+// something it shows changes, holding only the changed fields under their
+// /api/status names: {"powerJack":true}, {"vbus":9.02,"vbusMv":9020},
+// {"schedules":3}. The first frame after connecting has all of them.
+// Frames go out from the server task, between requests.
+#if CONFIG_HTTPD_WS_SUPPORT
+static volatile bool liveQueued = false;
+
+static void writeLive(JsonWriter &json, uint16_t mask, const LiveState &s) {
+  char volts[12];
+  json.beginObject();
+  if (mask & LIVE_POWER_JACK) json.addBool("powerJack", s.powerJack);
+  if (mask & LIVE_USB_OUTPUT) json.addBool("usbOutput", s.usbOutput);
+  if (mask & LIVE_PD_VOLTAGE) json.addUint("pdVoltage", s.pdVoltage);
+  if (mask & LIVE_PD_STATE) json.addString("pdState", pdStateName(s.pdState));
+  if (mask & LIVE_VBUS) {
+    formatVolts(volts, s.vbusMv);
+    json.addRaw("vbus", volts);
+    json.addUint("vbusMv", s.vbusMv);
+  }
+  if (mask & LIVE_VOUT) {
+    formatVolts(volts, s.voutMv);
+    json.addRaw("vout", volts);
+    json.addUint("voutMv", s.voutMv);
+  }
+  if (mask & LIVE_SCHEDULES) json.addUint("schedules", s.schedules);
+  if (mask & LIVE_FAULTS) {
+    json.addString("jackFault", protectFaultName(s.jackFault));
+    json.addString("usbFault", protectFaultName(s.usbFault));
+  }
+  json.endObject();
+}
+
+// Queued by pushLive(); handlers are not running, so jsonBuf is free
+static void sendLive(void *arg) {
+  liveQueued = false;
+  LiveState s;
+  uint16_t mask = takeLiveChanges(s);
+  if (mask == 0) return;
+  JsonWriter json(jsonBuf, sizeof(jsonBuf), nullptr, nullptr);
+  writeLive(json, mask, s);
+  if (json.overflowed()) {
+    // A cut frame is not JSON; the page catches up at its next change
+    Serial.println(F("ERR: Live update larger than JSON_CHUNK, not sent"));
+    return;
+  }
   
-  // Handle DELETE for schedule removal
-  server.onNotFound([]() {
-    String uri = server.uri();
-    if (uri.startsWith("/api/schedule/") && server.method() == HTTP_DELETE) {
-      handleRemoveSchedule();
-    } else {
-      server.send(404, "text/plain", "Not found");
+  httpd_ws_frame_t frame = {};
+  frame.final = true;
+  frame.type = HTTPD_WS_TYPE_TEXT;
+  frame.payload = (uint8_t *)jsonBuf;
+  frame.len = json.buffered();
+  
+  int fds[HTTP_MAX_CONNECTIONS];
+  size_t count = HTTP_MAX_CONNECTIONS;
+  uint8_t clients = 0;
+  if (httpd_get_client_list(server, &count, fds) == ESP_OK) {
+    for (size_t i = 0; i < count; i++) {
+      if (httpd_ws_get_fd_info(server, fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET) continue;
+      if (httpd_ws_send_frame_async(server, fds[i], &frame) == ESP_OK) clients++;
+      else httpd_sess_trigger_close(server, fds[i]);
     }
-  });
+  }
+  // Every client failed; stop checking until someone connects
+  if (clients == 0) setLiveWatching(false);
+}
+
+// Session close, on the server task. With a close_fn set the server leaves
+// closing the socket to us. The session is still listed while this runs.
+static void onSessionClose(httpd_handle_t hd, int sockfd) {
+  if (httpd_ws_get_fd_info(hd, sockfd) == HTTPD_WS_CLIENT_WEBSOCKET) {
+    int fds[HTTP_MAX_CONNECTIONS];
+    size_t count = HTTP_MAX_CONNECTIONS;
+    uint8_t others = 0;
+    if (httpd_get_client_list(hd, &count, fds) == ESP_OK) {
+      for (size_t i = 0; i < count; i++) {
+        if (fds[i] != sockfd && httpd_ws_get_fd_info(hd, fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET) others++;
+      }
+    }
+    // The last page closed; stop checking now, not at the next change
+    if (others == 0) setLiveWatching(false);
+  }
+  close(sockfd);
+}
+
+// Change hook, on the control task. Changes made before the queued send
+// runs go out in the same frame.
+static void pushLive() {
+  if (liveQueued || !server) return;
+  liveQueued = true;
+  if (httpd_queue_work(server, sendLive, nullptr) != ESP_OK) liveQueued = false;
+}
+
+static esp_err_t handleLiveSocket(httpd_req_t *req) {
+  if (req->method == HTTP_GET) {
+    // Handshake done: this client gets the full state next
+    setLiveWatching(true);
+    return ESP_OK;
+  }
+  // Nothing is expected from clients; read their frames and drop them
+  uint8_t buf[32];
+  httpd_ws_frame_t frame = {};
+  frame.payload = buf;
+  if (httpd_ws_recv_frame(req, &frame, 0) != ESP_OK || frame.len > sizeof(buf)) return ESP_FAIL;
+  return frame.len > 0 ? httpd_ws_recv_frame(req, &frame, frame.len) : ESP_OK;
+}
+#endif
+
+void beginLiveUpdates() {
+#if CONFIG_HTTPD_WS_SUPPORT
+  beginLive(pushLive);
+#endif
+}
+
+typedef void (*Handler)();
+
+static esp_err_t route(httpd_req_t *req) {
+  PERF_SCOPE(PERF_WEB);
+  request = req;
+  ((Handler)req->user_ctx)();
+  return ESP_OK;
+}
+
+static void on(const char *uri, httpd_method_t method, Handler handler) {
+  httpd_uri_t r = {};
+  r.uri = uri;
+  r.method = method;
+  r.handler = route;
+  r.user_ctx = (void *)handler;
+  httpd_register_uri_handler(server, &r);
+}
+
+static esp_err_t handleNotFound(httpd_req_t *req, httpd_err_code_t error) {
+  request = req;
+  sendResponse(404, "text/plain", "Not found", 9);
+  return ESP_OK;
+}
+
+// Called on every WiFi connect; the server is started once and keeps its
+// listening socket across reconnects
+void setupWebServer() {
+  if (server) return;
+  
+  httpd_config_t cfg = HTTPD_DEFAULT_CONFIG();
+  cfg.task_priority = HTTP_TASK_PRIORITY;
+  cfg.stack_size = HTTP_TASK_STACK;
+  cfg.max_open_sockets = HTTP_MAX_CONNECTIONS;
+  cfg.max_uri_handlers = HTTP_MAX_ROUTES;
+  cfg.lru_purge_enable = true;
+  cfg.recv_wait_timeout = HTTP_IO_TIMEOUT;
+  cfg.send_wait_timeout = HTTP_IO_TIMEOUT;
+  cfg.uri_match_fn = httpd_uri_match_wildcard;
+#if CONFIG_HTTPD_WS_SUPPORT
+  cfg.close_fn = onSessionClose;
+#endif
+  if (httpd_start(&server, &cfg) != ESP_OK) {
+    server = nullptr;
+    Serial.println(F("ERROR: Web server failed to start"));
+    return;
+  }
+  
+  on("/", (httpd_method_t)HTTP_ANY, handleRoot);   // Any method, as before the move
+  on("/api/status", HTTP_GET, handleStatus);
+  on("/api/schedules", HTTP_GET, handleGetSchedules);
+  on("/api/powerjack", HTTP_POST, handleSetPowerJack);
+  on("/api/usboutput", HTTP_POST, handleSetUSBOutput);
+  on("/api/pd", HTTP_POST, handleSetPD);
+  on("/api/schedule", HTTP_POST, handleAddSchedule);
+  on("/api/timezone", HTTP_POST, handleSetTimezone);
+  on("/api/power", HTTP_POST, handleSetPower);
+  on("/api/protection", HTTP_GET, handleGetProtection);
+  on("/api/protection", HTTP_POST, handleSetProtection);
+  on("/api/wifi", HTTP_POST, handleSetWiFi);
+  on("/api/timer", HTTP_POST, handleAddTimer);
+  on("/api/timers", HTTP_GET, handleGetTimers);
+  on("/api/metrics", HTTP_GET, handleGetMetrics);
+  on("/api/metrics", HTTP_DELETE, handleResetMetrics);
+  on("/api/history", HTTP_GET, handleHistory);
+  
+  // Schedule and timer removal by index/id in the path
+  on("/api/schedule/*", HTTP_DELETE, handleRemoveSchedule);
+  on("/api/timer/*", HTTP_DELETE, handleCancelTimer);
+  httpd_register_err_handler(server, HTTPD_404_NOT_FOUND, handleNotFound);
+  
+#if CONFIG_HTTPD_WS_SUPPORT
+  httpd_uri_t ws = {};
+  ws.uri = "/ws";
+  ws.method = HTTP_GET;
+  ws.handler = handleLiveSocket;
+  ws.is_websocket = true;
+  httpd_register_uri_handler(server, &ws);
+#endif
   
-  server.begin();
   Serial.println(F("Web server started on port 80"));
 }
 
-void handleWebClient() {
-  server.handleClient();
+// ============================================================================
+// String vs JsonWriter Benchmark
+// ============================================================================
+#define JSON_BENCH_ROUNDS 100
+
+// handleStatus() as it used to build its body
+static String legacyStatusJson() {
+  char timeStr[30] = "Not synced";
+  if (currentTime > 100000) {
+    struct tm *timeinfo = localtime(&currentTime);
+    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", timeinfo);
+  }
+  
+  String json = "{";
+  json += "\"powerJack\":" + String(powerJackState ? "true" : "false") + ",";
+  json += "\"usbOutput\":" + String(usbOutputState ? "true" : "false") + ",";
+  uint32_t vbusMv = getVBusMillivolts();
+  uint32_t voutMv = getVOutMillivolts();
+  char volts[12];
+  formatVolts(volts, vbusMv);
+  json += "\"vbus\":" + String(volts) + ",";
+  formatVolts(volts, voutMv);
+  json += "\"vout\":" + String(volts) + ",";
+  json += "\"vbusMv\":" + String(vbusMv) + ",";
+  json += "\"voutMv\":" + String(voutMv) + ",";
+  json += "\"wifi\":\"" + String(wifiConnected ? "Connected" : "Disconnected") + "\",";
+  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
+  json += "\"timezone\":\"" + String(config.timezone) + "\",";
+  json += "\"time\":\"" + String(timeStr) + "\",";
+  json += "\"pdVoltage\":" + String(config.pdVoltage) + ",";
+  const PDStatus &pd = getPDStatus();
+  json += "\"pdState\":\"" + String(pdStateName(pd.state)) + "\",";
+  json += "\"pdSettleMs\":" + String(pd.settleMs) + ",";
+  json += "\"pdFailures\":" + String(pd.failures) + ",";
+  json += "\"jackFault\":\"" + String(protectFaultName(getProtectStats().outputs[PROTECT_JACK].latched)) + "\",";
+  json += "\"usbFault\":\"" + String(protectFaultName(getProtectStats().outputs[PROTECT_USB].latched)) + "\",";
+  json += "\"schedules\":" + String(config.scheduleCount) + ",";
+  json += "\"timers\":" + String(getTimerCount()) + ",";
+  json += "\"flashCommits\":" + String(getStorageStats().commits) + ",";
+  json += "\"flashBytesWritten\":" + String(getStorageStats().bytesWritten) + ",";
+  json += "\"flashBytesChanged\":" + String(getStorageStats().bytesChanged) + ",";
+  json += "\"controlLatencyMaxUs\":" + String(getEventLoopStats().maxLatencyUs) + ",";
+  json += "\"buttonLatencyMaxUs\":" + String(getButtonStats().maxLatencyUs) + ",";
+  json += "\"telemetryBytes\":" + String(telemetryMemoryBytes()) + ",";
+  json += "\"heapFree\":" + String(ESP.getFreeHeap()) + ",";
+  json += "\"heapMinFree\":" + String(ESP.getMinFreeHeap()) + ",";
+  json += "\"heapMaxBlock\":" + String(ESP.getMaxAllocHeap()) + ",";
+  const PowerStats &ps = getPowerStats();
+  uint64_t spanUs = esp_timer_get_time() - ps.startUs;
+  json += "\"lowPower\":" + String(config.lowPower ? "true" : "false") + ",";
+  json += "\"lightSleep\":" + String(ps.lightSleep ? "true" : "false") + ",";
+  json += "\"sleepPercent\":";
+  json += ps.sleepTracked && spanUs > 0 ? String((double)ps.sleptUs * 100.0 / spanUs, 1) : String("null");
+  json += "}";
+  return json;
+}
+
+// Counts the body without keeping it, so the bench sees every byte
+static void discardJson(void *ctx, const char *data, size_t len) {
+}
+
+// Runs on the loop task, so it cannot borrow jsonBuf from the server
+void benchStatusJson(JsonBench &r) {
+  char buf[JSON_CHUNK];
+  volatile size_t sink = 0;
+  PerfHeap before, held, after;
+  uint32_t start;
+
+  // Held by one finished body, then lost over the timed rounds
+  perfHeapSnapshot(before);
+  {
+    String json = legacyStatusJson();
+    perfHeapSnapshot(held);
+  }
+  r.stringBlocks = held.blocks - before.blocks;
+  r.stringBytes = before.freeBytes - held.freeBytes;
+  perfHeapSnapshot(before);
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < JSON_BENCH_ROUNDS; i++) {
+    String json = legacyStatusJson();
+    sink = sink + json.length();
+  }
+  r.stringCycles = (esp_cpu_get_cycle_count() - start) / JSON_BENCH_ROUNDS;
+  perfHeapSnapshot(after);
+  r.stringLost = before.freeBytes - after.freeBytes;
+
+  perfHeapSnapshot(before);
+  {
+    JsonWriter json(buf, sizeof(buf), discardJson, nullptr);
+    writeStatus(json);
+    perfHeapSnapshot(held);
+  }
+  r.writerBlocks = held.blocks - before.blocks;
+  r.writerBytes = before.freeBytes - held.freeBytes;
+  perfHeapSnapshot(before);
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < JSON_BENCH_ROUNDS; i++) {
+    JsonWriter json(buf, sizeof(buf), discardJson, nullptr);
+    writeStatus(json);
+    sink = sink + json.total();
+    r.length = json.total();
+  }
+  r.writerCycles = (esp_cpu_get_cycle_count() - start) / JSON_BENCH_ROUNDS;
+  perfHeapSnapshot(after);
+  r.writerLost = before.freeBytes - after.freeBytes;
+}
+
+// ============================================================================
+// Request Parser Self-Check (/bench)
+// ============================================================================
+// The old handleSetPD() body scan, kept to show what the reader replaced
+static int legacyPDVoltage(const String &body) {
+  int voltage = 9;
+  if (body.indexOf("\"voltage\":5") > 0) voltage = 5;
+  else if (body.indexOf("\"voltage\":9") > 0) voltage = 9;
+  else if (body.indexOf("\"voltage\":12") > 0) voltage = 12;
+  else if (body.indexOf("\"voltage\":15") > 0) voltage = 15;
+  else if (body.indexOf("\"voltage\":20") > 0) voltage = 20;
+  return voltage;
+}
+
+// Bodies for /api/pd and what the handler must do with them: set volts,
+// or 0 to answer 400
+struct PDCase {
+  const char *body;
+  uint8_t volts;
+};
+static const PDCase pdCorpus[] = {
+  { "{\"voltage\":9}", 9 },
+  { " { \"voltage\" : 20 } ", 20 },
+  { "{\"voltage\":12,\"note\":\"a,b}\"}", 12 },
+  { "{\"voltage\":50}", 0 },
+  { "{\"voltage\":200}", 0 },
+  { "{\"voltage\":0}", 0 },
+  { "{\"voltage\":5.5}", 0 },
+  { "{\"voltage\":20.0}", 0 },
+  { "{\"voltage\":2e1}", 0 },
+  { "{\"voltage\":\"9\"}", 0 },
+  { "{\"voltage\":-5}", 0 },
+  { "{\"voltage\":+20}", 0 },
+  { "{\"voltage\":true}", 0 },
+  { "{\"voltage\":9,\"voltage\":20}", 0 },
+  { "{\"note\":\"\\\"voltage\\\":20\"}", 0 },
+  { "{\"voltage\":9}x", 0 },
+  { "{\"voltage\":9", 0 },
+  { "{\"voltage\":09}", 0 },
+  { "[{\"voltage\":9}]", 0 },
+  { "{\"voltage\":99999999999}", 0 },
+  { "", 0 },
+};
+
+// The old handleSetUSBOutput()/handleSetPowerJack() test
+static bool legacyStateOn(const String &body) {
+  return body.indexOf("true") > 0;
+}
+
+// Bodies for the output switches: 1 on, 0 off, -1 to answer 400
+struct StateCase {
+  const char *body;
+  int8_t on;
+};
+static const StateCase stateCorpus[] = {
+  { "{\"state\":true}", 1 },
+  { "{\"state\":false}", 0 },
+  { "{\"state\":false,\"note\":\"true\"}", 0 },
+  { "{\"state\":\"true\"}", -1 },
+  { "{\"state\":1}", -1 },
+  { "{\"state\":tru}", -1 },
+  { "{\"state\":truex}", -1 },
+  { "{\"state\":TRUE}", -1 },
+  { "{\"state\":false,\"state\":true}", -1 },
+  { "{\"true\":false}", -1 },
+};
+
+// Mutants of a seed body: at every position, cut 0-3 bytes and insert one
+// fuzz byte, one splice token or nothing. That covers substitutions,
+// insertions, deletions and multi-byte splices such as "9" -> "20" or
+// "fals" -> "tru". Seeds include bodies one edit away from 20V, an
+// out-of-range voltage and "true", so the mutants do reach them.
+static const char fuzzBytes[] = "\"{}[],:.-+ 0129eEtfnu\\x";
+static const char *const fuzzSplices[] = {
+  "20", "2", "0", "00", ".0", "e1", "true", "tru", "\\\"",
+  ",\"voltage\":20", ",\"state\":true", "\":true", "}{", "9999999999"
+};
+static const size_t FUZZ_INSERTS = sizeof(fuzzBytes) - 1 + sizeof(fuzzSplices) / sizeof(fuzzSplices[0]) + 1;
+static const size_t FUZZ_MAX_CUT = 3;
+
+enum FuzzResult : uint8_t {
+  FUZZ_REJECTED,
+  FUZZ_ACCEPTED,
+  FUZZ_REACHED,    // Accepted as 20V or "on"
+  FUZZ_WRONG       // Accepted with a value the body does not spell out
+};
+
+static bool jsonSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// True if body has the member "key":value written out literally, the value
+// ending at whitespace, ',', '}' or the end. Whatever the reader accepts
+// must look like this; anything else was guessed.
+static bool hasLiteral(const char *body, size_t len, const char *key, const char *value) {
+  size_t kn = strlen(key), vn = strlen(value);
+  for (size_t i = 0; i + kn + 2 <= len; i++) {
+    if (body[i] != '"' || memcmp(body + i + 1, key, kn) != 0 || body[i + kn + 1] != '"') continue;
+    size_t p = i + kn + 2;
+    while (p < len && jsonSpace(body[p])) p++;
+    if (p == len || body[p++] != ':') continue;
+    while (p < len && jsonSpace(body[p])) p++;
+    if (len - p < vn || memcmp(body + p, value, vn) != 0) continue;
+    p += vn;
+    if (p == len || jsonSpace(body[p]) || body[p] == ',' || body[p] == '}') return true;
+  }
+  return false;
+}
+
+template <typename Check>
+static void fuzzBody(const char *base, Check check, ParseBench &r) {
+  char buf[64];
+  size_t n = strlen(base);
+  JsonReader reader;
+  for (size_t pos = 0; pos <= n; pos++) {
+    for (size_t cut = 0; cut <= FUZZ_MAX_CUT && pos + cut <= n; cut++) {
+      for (size_t k = 0; k < FUZZ_INSERTS; k++) {
+        const char *insert = "";
+        size_t insertLen = 0;
+        if (k < sizeof(fuzzBytes) - 1) {
+          insert = fuzzBytes + k;
+          insertLen = 1;
+        } else if (k < FUZZ_INSERTS - 1) {
+          insert = fuzzSplices[k - (sizeof(fuzzBytes) - 1)];
+          insertLen = strlen(insert);
+        }
+        if (cut == 0 && insertLen == 0) continue;
+        memcpy(buf, base, pos);
+        memcpy(buf + pos, insert, insertLen);
+        memcpy(buf + pos + insertLen, base + pos + cut, n - pos - cut);
+        size_t len = n - cut + insertLen;
+
+        r.mutants++;
+        if (!reader.parse(buf, len)) continue;
+        FuzzResult result = check(reader, buf, len);
+        if (result == FUZZ_REJECTED) continue;
+        r.accepted++;
+        if (result == FUZZ_REACHED) r.reached++;
+        if (result == FUZZ_WRONG) r.wrong++;
+      }
+    }
+  }
+}
+
+void benchRequestParsing(ParseBench &r) {
+  static const char scheduleBody[] =
+    "{\"time\":\"0730\",\"action\":1,\"target\":\"jack\",\"days\":\"weekdays\"}";
+  volatile uint32_t sink = 0;
+  uint32_t start;
+  JsonReader reader;
+
+  // A full schedule body: tokenize and pull out every field
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < JSON_BENCH_ROUNDS; i++) {
+    char text[16];
+    int32_t action;
+    reader.parse(scheduleBody, sizeof(scheduleBody) - 1);
+    reader.getString("time", text, sizeof(text));
+    reader.getInt("action", action, 0, 255);
+    reader.getString("target", text, sizeof(text));
+    reader.getString("days", text, sizeof(text));
+    sink = sink + action + text[0];
+  }
+  r.readerCycles = (esp_cpu_get_cycle_count() - start) / JSON_BENCH_ROUNDS;
+  r.bodyLength = sizeof(scheduleBody) - 1;
+
+  r.corpusCases = sizeof(pdCorpus) / sizeof(pdCorpus[0]) + sizeof(stateCorpus) / sizeof(stateCorpus[0]);
+  r.corpusPassed = 0;
+  r.legacyWrong = 0;
+  for (const PDCase &c : pdCorpus) {
+    uint8_t volts = 0;
+    if (!reader.parse(c.body, strlen(c.body)) || !readPDVoltage(reader, volts)) volts = 0;
+    if (volts == c.volts) r.corpusPassed++;
+    // The old scan never refused a body, so a reject case it "set" is wrong too
+    if (legacyPDVoltage(String(c.body)) != c.volts) r.legacyWrong++;
+  }
+  for (const StateCase &c : stateCorpus) {
+    bool on;
+    int8_t got = reader.parse(c.body, strlen(c.body)) && readOutputState(reader, on) ? on : -1;
+    if (got == c.on) r.corpusPassed++;
+    if (legacyStateOn(String(c.body)) != c.on) r.legacyWrong++;
+  }
+
+  // Every accepted mutant must be a supported voltage or a boolean that the
+  // body spells out for the right key
+  r.mutants = r.accepted = r.reached = r.wrong = 0;
+  static const char *const pdSeeds[] = {
+    "{\"voltage\":5}", "{\"voltage\":9}", "{\"voltage\":12}", "{\"voltage\":15}",
+    "{\"voltage\":2}", "{\"voltage\":0}", "{\"voltage\":200}"
+  };
+  for (const char *seed : pdSeeds) {
+    fuzzBody(seed, [](const JsonReader &j, const char *body, size_t len) {
+      uint8_t v;
+      if (!readPDVoltage(j, v)) return FUZZ_REJECTED;
+      // Spelled out rather than isValidPDVoltage(), which the reader uses
+      bool supported = v == 5 || v == 9 || v == 12 || v == 15 || v == 20;
+      char text[4];
+      snprintf(text, sizeof(text), "%u", v);
+      if (!supported || !hasLiteral(body, len, "voltage", text)) return FUZZ_WRONG;
+      return v == 20 ? FUZZ_REACHED : FUZZ_ACCEPTED;
+    }, r);
+  }
+  static const char *const stateSeeds[] = {
+    "{\"state\":false}", "{\"state\":tru}", "{\"state\":\"true\"}", "{\"state\":1}"
+  };
+  for (const char *seed : stateSeeds) {
+    fuzzBody(seed, [](const JsonReader &j, const char *body, size_t len) {
+      bool on;
+      if (!readOutputState(j, on)) return FUZZ_REJECTED;
+      if (!hasLiteral(body, len, "state", on ? "true" : "false")) return FUZZ_WRONG;
+      return on ? FUZZ_REACHED : FUZZ_ACCEPTED;
+    }, r);
+  }
+}
+
+// ============================================================================
+// Request Storm (/storm)
+// ============================================================================
+struct StormClient {
+  int64_t endUs;
+  uint32_t requests, failures;
+  volatile bool done;
+};
+static StormClient stormClients[STORM_CLIENTS];
+
+// One GET per connection: the request, then our FIN, so the server answers
+// and closes the session
+static bool stormRequest() {
+  static const char req[] = "GET /api/status HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+  int s = socket(AF_INET, SOCK_STREAM, 0);
+  if (s < 0) return false;
+  timeval tv = { HTTP_IO_TIMEOUT, 0 };
+  setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(80);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  bool ok = connect(s, (sockaddr *)&addr, sizeof(addr)) == 0 &&
+            send(s, req, sizeof(req) - 1, 0) == (int)(sizeof(req) - 1);
+  if (ok) shutdown(s, SHUT_WR);
+  char buf[128];
+  size_t got = 0;
+  int n = 0;
+  while (ok && (n = recv(s, buf, sizeof(buf), 0)) > 0) {
+    if (got == 0) ok = n >= 12 && memcmp(buf, "HTTP/1.1 200", 12) == 0;
+    got += n;
+  }
+  close(s);
+  return ok && n == 0 && got > 0;
+}
+
+static void stormClientMain(void *arg) {
+  StormClient *c = (StormClient *)arg;
+  while (esp_timer_get_time() < c->endUs) {
+    if (stormRequest()) {
+      c->requests++;
+    } else {
+      c->failures++;
+      delay(1);   // Out of sockets: let the server close some
+    }
+  }
+  c->done = true;
+  vTaskDelete(nullptr);
+}
+
+struct StormProbe {
+  int64_t sentUs, ranUs;
+};
+
+// Time round trips to the control task for ms milliseconds
+static void probeControl(uint32_t ms, uint32_t &probes, uint32_t &avgUs, uint32_t &maxUs) {
+  uint64_t sumUs = 0;
+  probes = maxUs = 0;
+  int64_t endUs = esp_timer_get_time() + ms * 1000LL;
+  while (esp_timer_get_time() < endUs) {
+    StormProbe p = { esp_timer_get_time(), 0 };
+    runOnControl([](void *arg) { ((StormProbe *)arg)->ranUs = esp_timer_get_time(); }, &p);
+    uint32_t us = p.ranUs - p.sentUs;
+    if (us > maxUs) maxUs = us;
+    sumUs += us;
+    probes++;
+    delay(STORM_PROBE_INTERVAL);
+  }
+  avgUs = probes > 0 ? sumUs / probes : 0;
+}
+
+bool benchRequestStorm(StormBench &r, uint32_t seconds) {
+  memset(&r, 0, sizeof(r));
+  if (!server) return false;
+
+  // The probes run above the server and the clients, so they are sent on
+  // time; what they measure is the wait for the control task alone
+  UBaseType_t priority = uxTaskPriorityGet(nullptr);
+  vTaskPrioritySet(nullptr, HTTP_TASK_PRIORITY + 1);
+  probeControl(1000, r.idleProbes, r.idleAvgUs, r.idleMaxUs);
+
+  int64_t endUs = esp_timer_get_time() + seconds * 1000000LL;
+  for (uint8_t i = 0; i < STORM_CLIENTS; i++) {
+    StormClient &c = stormClients[i];
+    c.endUs = endUs;
+    c.requests = c.failures = 0;
+    c.done = false;
+    if (xTaskCreate(stormClientMain, "storm", STORM_CLIENT_STACK, &c, HTTP_TASK_PRIORITY, nullptr) != pdPASS) {
+      c.done = true;
+    }
+  }
+  probeControl(seconds * 1000, r.probes, r.avgUs, r.maxUs);
+
+  // A client may still be waiting on its last response
+  for (uint8_t i = 0; i < STORM_CLIENTS; i++) {
+    while (!stormClients[i].done) delay(10);
+    r.requests += stormClients[i].requests;
+    r.failures += stormClients[i].failures;
+  }
+  vTaskPrioritySet(nullptr, priority);
+  return true;
 }
@@ -3,7 +3,50 @@
 
 #include "config.h"
 
-void setupWebServer();
-void handleWebClient();
+void setupWebServer();   // Starts the server task; HTTP is not served from loop()
+
+// Register the /ws change check; in setup(), before the control task starts
+void beginLiveUpdates();
+
+// The /api/status body built the old way, by String concatenation, against
+// JsonWriter (/bench). Heap figures come from perfHeapSnapshot() and include
+// whatever other tasks allocate meanwhile.
+struct JsonBench {
+  uint32_t stringCycles, writerCycles;   // Per body
+  int32_t stringBlocks, writerBlocks;    // Heap blocks a finished body holds
+  int32_t stringBytes, writerBytes;      // Heap bytes a finished body holds
+  int32_t stringLost, writerLost;        // Free heap lost over all the rounds
+  size_t length;                         // Body size
+};
+void benchStatusJson(JsonBench &r);
+
+// JsonReader on request bodies (/bench): time to read a schedule body, the
+// /api/pd and output corpora against the reader and the old indexOf()
+// scans, and byte edits and splices of seed bodies. wrong must be 0: no
+// mutant may be accepted with an unsupported voltage, or a value its body
+// does not spell out. reached must not be: the mutants have to get to 20V
+// and "on" for the check to mean anything.
+struct ParseBench {
+  uint32_t readerCycles;             // Per body
+  size_t bodyLength;
+  uint8_t corpusCases, corpusPassed;
+  uint8_t legacyWrong;               // Cases the old scans got wrong
+  uint32_t mutants, accepted;
+  uint32_t reached;                  // Accepted as 20V or "on"
+  uint32_t wrong;
+};
+void benchRequestParsing(ParseBench &r);
+
+// Control latency under a request flood (/storm): STORM_CLIENTS local tasks
+// fetch /api/status over loopback as fast as the server answers while the
+// caller times round trips to the control task, the path every forwarded
+// command takes. A second of probes without the flood comes first, for
+// comparison. False when the web server is not running.
+struct StormBench {
+  uint32_t idleProbes, idleAvgUs, idleMaxUs;
+  uint32_t probes, avgUs, maxUs;     // During the flood
+  uint32_t requests, failures;       // Flood requests answered / not
+};
+bool benchRequestStorm(StormBench &r, uint32_t seconds);
 
 #endif
@@ -0,0 +1,277 @@
+#include "buttons.h"
+#include "hardware.h"
+#include "scheduler.h"
+#include "timers.h"
+#include "event_loop.h"
+#include "perf.h"
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+#include <hal/gpio_ll.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+// ============================================================================
+// Actions
+// ============================================================================
+typedef void (*ButtonFn)();
+
+static const uint8_t pdSteps[] = { 5, 9, 12, 15, 20 };
+#define PD_STEP_COUNT (sizeof(pdSteps) / sizeof(pdSteps[0]))
+
+// 5V -> 9V -> 12V -> 15V -> 20V -> 5V; an unlisted setting goes to 9V
+static void nextPD() {
+  uint8_t i = 0;
+  while (i < PD_STEP_COUNT && pdSteps[i] != config.pdVoltage) i++;
+  if (i == PD_STEP_COUNT) i = 0;
+  setPDVoltage(pdSteps[(i + 1) % PD_STEP_COUNT]);
+}
+
+static void toggleJack() { setPowerJackState(!powerJackState); }
+static void toggleUSB() { setUSBOutputState(!usbOutputState); }
+static void cycleJack() { startPowerCycle(SCHEDULE_TARGET_JACK, BUTTON_POWER_CYCLE); }
+static void cycleUSB() { startPowerCycle(SCHEDULE_TARGET_USB, BUTTON_POWER_CYCLE); }
+
+static void allOn() {
+  setPowerJackState(true);
+  setUSBOutputState(true);
+}
+
+// A button without long or double actions fires its short action as soon
+// as the press settles. Otherwise the short action waits for the release
+// (and, with a double action, for the double-click window to pass), so
+// only bind those where acting on release is acceptable.
+struct ButtonAction {
+  uint8_t pin;
+  ButtonFn onShort;
+  ButtonFn onLong;
+  ButtonFn onDouble;
+};
+
+static const ButtonAction buttonTable[BUTTON_COUNT] = {
+  { BUTTON1_PIN, toggleJack, cycleJack, nullptr },  // Jack: toggle / power-cycle
+  { BUTTON2_PIN, toggleUSB,  cycleUSB,  nullptr },  // USB: toggle / power-cycle
+  { BUTTON3_PIN, nextPD,     nullptr,   nullptr },  // PD: next voltage
+  { BUTTON4_PIN, allOn,      nullptr,   nullptr },  // All outputs on
+};
+
+// ============================================================================
+// Interrupt queue
+// ============================================================================
+// Single producer: every GPIO handler runs from the one GPIO interrupt.
+// Head and tail count up freely and are masked on access.
+//
+// Each pin interrupts on the level opposite to its current one, and the
+// handler flips it after every change. This catches both edges like CHANGE
+// does, and a level (unlike an edge) can also wake the chip from light
+// sleep, with the same pin setting doing both jobs.
+struct ButtonEdge {
+  uint8_t button;
+  bool down;
+  int64_t us;
+};
+
+static ButtonEdge edgeQueue[BUTTON_QUEUE_SIZE];
+static volatile uint32_t queueHead = 0;
+static volatile uint32_t queueTail = 0;
+static volatile uint32_t droppedEdges = 0;
+static int buttonEvent = -1;
+
+static void IRAM_ATTR onButtonEdge(void *arg) {
+  uint8_t i = (uint8_t)(uintptr_t)arg;
+  uint8_t pin = buttonTable[i].pin;
+  bool down = ((REG_READ(GPIO_IN_REG) >> pin) & 1) == 0;
+  uint32_t head = queueHead;
+  if (head - queueTail >= BUTTON_QUEUE_SIZE) {
+    droppedEdges = droppedEdges + 1;
+  } else {
+    ButtonEdge &e = edgeQueue[head & (BUTTON_QUEUE_SIZE - 1)];
+    e.button = i;
+    e.down = down;
+    e.us = esp_timer_get_time();
+    __atomic_store_n(&queueHead, head + 1, __ATOMIC_RELEASE);
+  }
+  gpio_ll_set_intr_type(&GPIO, pin, down ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  triggerEventFromISR(buttonEvent);
+}
+
+// ============================================================================
+// Debounce and gestures
+// ============================================================================
+// A button's level counts once it has been quiet for BUTTON_DEBOUNCE. Edges
+// carry their own timestamps, so a burst that queued up while the control
+// task was busy still settles, and is timed, as it happened.
+enum ButtonPhase : uint8_t {
+  BTN_IDLE,         // Released
+  BTN_DOWN,         // Pressed, gesture not decided yet
+  BTN_WAIT_DOUBLE,  // Released after a press, waiting for a second one
+  BTN_HELD          // Pressed, action already taken; ignore until release
+};
+
+struct ButtonState {
+  bool down;          // Debounced level
+  bool rawDown;       // Level at the last edge
+  bool settling;      // Edges seen within the last BUTTON_DEBOUNCE
+  ButtonPhase phase;
+  int64_t burstUs;    // First edge of the current burst
+  int64_t lastEdgeUs;
+  int64_t phaseUs;    // When the press or release that set phase happened
+};
+
+static ButtonState buttons[BUTTON_COUNT];
+static ButtonStats stats = {};
+static uint32_t seenDropped = 0;
+
+#define DEBOUNCE_US ((int64_t)BUTTON_DEBOUNCE * 1000)
+#define LONG_PRESS_US ((int64_t)BUTTON_LONG_PRESS * 1000)
+#define DOUBLE_CLICK_US ((int64_t)BUTTON_DOUBLE_CLICK * 1000)
+
+// fromUs is the edge or timeout that decided the gesture
+static void fire(uint8_t i, ButtonFn fn, const __FlashStringHelper *gesture, int64_t fromUs) {
+  uint32_t latency = (uint32_t)(esp_timer_get_time() - fromUs);
+  stats.gestures++;
+  stats.sumLatencyUs += latency;
+  if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+  fn();
+  Serial.print(F("Button "));
+  Serial.print(i + 1);
+  Serial.print(' ');
+  Serial.print(gesture);
+  Serial.print(F(" ("));
+  Serial.print(latency);
+  Serial.println(F("us)"));
+}
+
+// Run gesture timeouts that fell due by t
+static void expireGestures(uint8_t i, int64_t t) {
+  ButtonState &b = buttons[i];
+  const ButtonAction &a = buttonTable[i];
+  if (b.phase == BTN_DOWN && a.onLong && t >= b.phaseUs + LONG_PRESS_US) {
+    b.phase = BTN_HELD;
+    fire(i, a.onLong, F("long press"), b.phaseUs + LONG_PRESS_US);
+  } else if (b.phase == BTN_WAIT_DOUBLE && t >= b.phaseUs + DOUBLE_CLICK_US) {
+    b.phase = BTN_IDLE;
+    fire(i, a.onShort, F("press"), b.phaseUs + DOUBLE_CLICK_US);
+  }
+}
+
+// The level settled at down; t is when the burst started
+static void settle(uint8_t i, bool down, int64_t t) {
+  ButtonState &b = buttons[i];
+  const ButtonAction &a = buttonTable[i];
+  if (down == b.down) return;
+  b.down = down;
+  expireGestures(i, t);
+
+  if (down) {
+    if (b.phase == BTN_WAIT_DOUBLE) {
+      b.phase = BTN_HELD;
+      fire(i, a.onDouble, F("double-click"), t);
+    } else if (!a.onLong && !a.onDouble) {
+      b.phase = BTN_HELD;
+      fire(i, a.onShort, F("press"), t);
+    } else {
+      b.phase = BTN_DOWN;
+      b.phaseUs = t;
+    }
+  } else if (b.phase == BTN_DOWN) {
+    if (a.onDouble) {
+      b.phase = BTN_WAIT_DOUBLE;
+      b.phaseUs = t;
+    } else {
+      b.phase = BTN_IDLE;
+      fire(i, a.onShort, F("press"), t);
+    }
+  } else {
+    b.phase = BTN_IDLE;
+  }
+}
+
+static void noteEdge(const ButtonEdge &e) {
+  ButtonState &b = buttons[e.button];
+  stats.edges++;
+  // A gap longer than the debounce time closes the previous burst
+  if (b.settling && e.us - b.lastEdgeUs >= DEBOUNCE_US) {
+    settle(e.button, b.rawDown, b.burstUs);
+    b.settling = false;
+  }
+  if (!b.settling) {
+    b.settling = true;
+    b.burstUs = e.us;
+  }
+  b.rawDown = e.down;
+  b.lastEdgeUs = e.us;
+}
+
+static void deadline(int64_t &next, int64_t at) {
+  if (at < next) next = at;
+}
+
+static void serviceButtons() {
+  PERF_SCOPE(PERF_BUTTONS);
+  uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+  while (queueTail != head) {
+    ButtonEdge e = edgeQueue[queueTail & (BUTTON_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queueTail, queueTail + 1, __ATOMIC_RELEASE);
+    noteEdge(e);
+  }
+
+  // Lost edges: treat every button as bouncing from now and read the pins
+  // once they have been quiet, rather than trusting a queued level
+  int64_t now = esp_timer_get_time();
+  if (droppedEdges != seenDropped) {
+    seenDropped = droppedEdges;
+    for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+      if (!buttons[i].settling) buttons[i].burstUs = now;
+      buttons[i].settling = true;
+      buttons[i].lastEdgeUs = now;
+    }
+  }
+
+  int64_t next = INT64_MAX;
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+    ButtonState &b = buttons[i];
+    now = esp_timer_get_time();
+    if (b.settling) {
+      if (now - b.lastEdgeUs < DEBOUNCE_US) {
+        // Timeouts after the burst started wait until it settles: a release
+        // at 790ms must not turn into a long press at 800ms
+        expireGestures(i, b.burstUs);
+        deadline(next, b.lastEdgeUs + DEBOUNCE_US);
+        continue;
+      }
+      b.settling = false;
+      settle(i, digitalRead(buttonTable[i].pin) == LOW, b.burstUs);
+    }
+    expireGestures(i, now);
+    if (b.phase == BTN_DOWN && buttonTable[i].onLong) deadline(next, b.phaseUs + LONG_PRESS_US);
+    if (b.phase == BTN_WAIT_DOUBLE) deadline(next, b.phaseUs + DOUBLE_CLICK_US);
+  }
+
+  if (next == INT64_MAX) {
+    cancelEvent(buttonEvent);
+  } else {
+    int64_t until = next - esp_timer_get_time();
+    scheduleEvent(buttonEvent, until > 0 ? (uint32_t)((until + 999) / 1000) : 0);
+  }
+}
+
+void beginButtons() {
+  buttonEvent = addEvent(serviceButtons, 0);
+  for (uint8_t i = 0; i < BUTTON_COUNT; i++) {
+    ButtonState &b = buttons[i];
+    b.down = digitalRead(buttonTable[i].pin) == LOW;
+    b.rawDown = b.down;
+    b.settling = false;
+    b.phase = b.down ? BTN_HELD : BTN_IDLE;  // Held at boot: wait for release
+    attachInterruptArg(digitalPinToInterrupt(buttonTable[i].pin), onButtonEdge,
+                       (void *)(uintptr_t)i, b.down ? ONHIGH : ONLOW);
+    gpio_wakeup_enable((gpio_num_t)buttonTable[i].pin,
+                       b.down ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+}
+
+const ButtonStats& getButtonStats() {
+  stats.overflows = droppedEdges;
+  return stats;
+}
@@ -0,0 +1,24 @@
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include "config.h"
+
+// Front-panel buttons. Pin interrupts queue timestamped levels; the control
+// task debounces each button on its own and dispatches short press, long
+// press and double-click from a table in buttons.cpp. The same interrupts
+// wake the chip from light sleep.
+struct ButtonStats {
+  uint32_t edges;         // Edges taken from the interrupt queue
+  uint32_t overflows;     // Edges dropped with the queue full (levels resync)
+  uint32_t gestures;      // Actions dispatched
+  uint32_t maxLatencyUs;  // Worst delay from the deciding edge to the action
+  uint64_t sumLatencyUs;
+};
+
+// Read the initial levels, register the button event and attach the
+// interrupts. Pins must already be configured as INPUT_PULLUP.
+void beginButtons();
+
+const ButtonStats& getButtonStats();
+
+#endif
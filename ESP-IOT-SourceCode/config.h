@@ -31,18 +31,159 @@ static const uint32_t BAUD = 115200;
 #define USB_OUTPUT_PIN 10    // GPIO10 - USB output enable (LOW=enable, HIGH=disable)
 
 // Timing
-#define WIFI_RETRY_INTERVAL 60000      // 1 minute
-#define BUTTON_DEBOUNCE 50
+#define WIFI_CONNECT_TIMEOUT 15000     // Give up on an attempt after 15s
+#define WIFI_BACKOFF_MIN 2000          // First retry delay, doubled per failure
+#define WIFI_BACKOFF_MAX 300000        // ...up to 5 minutes
+#define WIFI_MAX_HOOKS 4
 #define TIME_UPDATE_INTERVAL 3600000   // 1 hour
+#define CONFIG_FLUSH_QUIET 2000        // Commit config after 2s without changes
+#define CONFIG_FLUSH_MAX_DELAY 10000   // ...but never hold changes longer than 10s
+#define TIME_CHECKPOINT_INTERVAL 60000 // Journal the clock every minute
+#define SCHEDULE_CLOCK_JUMP 120        // Clock steps >2 min rebuild the schedule index
+#define CLOCK_TICK_INTERVAL 1000       // Advance currentTime and check schedules
+#define IO_POLL_INTERVAL 20            // Serial polling
+#define IO_POLL_INTERVAL_LOW_POWER 100 // ...in low-power mode, so light sleep can last
 
-// ADC configuration for ESP32-C6
-#define ADC_RESOLUTION 4095            // 12-bit ADC
-#define ADC_VREF 3.3                   // Reference voltage
-#define VBUS_DIVIDER_RATIO 10.216      // (47k+5.1k)/5.1k = 52.1/5.1 = 10.216
-#define VOUT_DIVIDER_RATIO 10.216      // (47k+5.1k)/5.1k = 52.1/5.1 = 10.216
+// Web server (esp_http_server, on its own task)
+#define JSON_CHUNK 1024                // API response buffer; longer bodies are chunked
+#define HTTP_BODY_MAX 512              // Largest POST body accepted
+#define HTTP_MAX_CONNECTIONS 6         // Open sockets; the longest idle is dropped for a new one
+#define HTTP_MAX_ROUTES 24
+#define HTTP_IO_TIMEOUT 5              // Seconds a stalled client may hold the server
+#define HTTP_TASK_PRIORITY 2           // Above the loop task, below the control task
+#define HTTP_TASK_STACK 6144
+
+// Request storm (/storm): local clients flood the web server while the
+// control task's round trip is timed
+#define STORM_CLIENTS 4                // Below HTTP_MAX_CONNECTIONS, leaving room for a browser
+#define STORM_CLIENT_STACK 3072
+#define STORM_PROBE_INTERVAL 10        // ms between control round trips
+#define STORM_LATENCY_BUDGET 5000      // us; /storm fails a slower round trip
+
+// Live updates (/ws)
+#define LIVE_INTERVAL 200              // State check while a client is connected
+#define LIVE_VOLTAGE_STEP 50           // mV a rail must move to be pushed
+
+// Buttons
+#define BUTTON_COUNT 4
+#define BUTTON_DEBOUNCE 20             // A level must hold this long (ms) to count
+#define BUTTON_LONG_PRESS 800
+#define BUTTON_DOUBLE_CLICK 300        // Max gap between the clicks of a double-click
+#define BUTTON_POWER_CYCLE 5000        // Off time for a long-press power-cycle
+#define BUTTON_QUEUE_SIZE 32           // Edges buffered from the ISR; power of two
+
+// Relative output timers
+#define TIMER_MAX 16
+#define TIMER_MIN_PERIOD 1000          // Shortest repeat; each switch is a journal append
+#define TIMER_MAX_DELAY 86400000       // 24 hours
+
+// Tasks. The control task must outrank the Arduino loop task (priority 1),
+// which handles WiFi and serial, and the HTTP server task.
+#define CONTROL_TASK_PRIORITY 5
+#define CONTROL_TASK_STACK 8192
+#define CONTROL_QUEUE_LENGTH 8
+// Flash commits and journal appends run on their own task, below everything
+// else: an erase or NVS rewrite never delays the control or network tasks.
+#define STORAGE_TASK_PRIORITY 1
+#define STORAGE_TASK_STACK 4096
+#define STORAGE_QUEUE_LENGTH 8
+
+// Event loop
+#define EVENT_MAX 16                   // Registered handlers (pending mask is 32 bits)
+#define EVENT_MAX_SLEEP 1000           // Upper bound on one wait, in ms
+
+// Stage timing histograms (perf.h); 0 compiles the instrumentation out
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1
+#endif
+
+// ADC configuration for ESP32-C6. Both channels are sampled continuously;
+// 2000 conversions/s at 20 per channel per frame gives 50 frames/s. The
+// frame time bounds how fast protection.h reacts.
+#define ADC_SAMPLE_FREQ 2000           // Conversions per second, all channels
+#define ADC_OVERSAMPLE 20              // Conversions averaged into one frame
+#define ADC_FILTER_AVERAGE 0
+#define ADC_FILTER_MEDIAN 1            // Rejects single-frame spikes
+#define ADC_FILTER ADC_FILTER_MEDIAN
+#define ADC_FILTER_LEN 5               // Frames per filter window (100ms)
+#define ADC_LOW_POWER_INTERVAL 1000    // One frame per second in low-power mode
+// Frames are read and protection-checked on their own task, above the
+// control task and lwIP (18), so neither a busy control task nor a network
+// flood delays a cutoff; only esp_timer and the WiFi driver rank higher.
+#define ADC_TASK_PRIORITY 20
+#define ADC_TASK_STACK 3072
+
+// PD negotiation: after a CFG pin change, the filtered VBUS reading is
+// polled until it is within tolerance of the request or the timeout ends
+#define PD_POLL_INTERVAL 20            // One ADC frame
+#define PD_SETTLE_TIMEOUT 2000         // CH224K normally settles in <500ms
+#define PD_SETTLE_STABLE 3             // Consecutive polls in tolerance
+#define PD_TOLERANCE_PERCENT 5
+#define PD_MAX_HOOKS 2
+
+// Over/under-voltage protection (protection.h). Per-output windows are set
+// at runtime (/protect); this margin over the PD setting always applies.
+#define PROTECT_PD_MARGIN 10           // Percent over the requested PD voltage
+#define PROTECT_BLANKING_MS 100        // No UVP right after an output turns on
+
+// Voltage history (telemetry.h), 2 channels of int16 millivolts. RAM:
+// 4 bytes per fine second, 12 bytes per coarse period.
+#define TELEMETRY_FINE_SECONDS 3600    // 1s averages for an hour: 14.4 KB
+#define TELEMETRY_COARSE_PERIOD 60     // min/avg/max per minute...
+#define TELEMETRY_COARSE_HOURS 24      // ...for a day: 17.3 KB
+
+// Voltage dividers: rail = pin * (R_HIGH + R_LOW) / R_LOW. The ratios are
+// folded into Q16 fixed-point constants at compile time, so the voltage
+// path is integer millivolts throughout (the C6 core has no FPU).
+#define VBUS_R_HIGH 47000              // Ohms; 47k/5.1k gives 10.216
+#define VBUS_R_LOW 5100
+#define VOUT_R_HIGH 47000
+#define VOUT_R_LOW 5100
+#define DIVIDER_Q16(high, low) ((uint32_t)((((uint64_t)(high) + (low)) * 65536 + (low) / 2) / (low)))
+#define VBUS_DIVIDER_Q16 DIVIDER_Q16(VBUS_R_HIGH, VBUS_R_LOW)
+#define VOUT_DIVIDER_Q16 DIVIDER_Q16(VOUT_R_HIGH, VOUT_R_LOW)
 
 // EEPROM Layout
+// Config and the schedule table are each stored as a versioned, CRC32-
+// protected record written alternately into an A and a B slot; boot picks
+// the valid slot with the newest sequence. Every commit rewrites a whole
+// NVS blob, so the table has a blob of its own and a settings change only
+// rewrites the small EEPROM one.
 #define EEPROM_SIZE 512
+#define CONFIG_SLOT_SIZE 256
+#define CONFIG_SLOT_A 0
+#define CONFIG_SLOT_B 256
+#define CONFIG_RECORD_MAGIC 0x4643     // "CF"
+#define CONFIG_RECORD_VERSION 3
+#define SCHEDULE_STORE_NAME "schedules"  // NVS blob; at most 15 characters
+#define SCHEDULE_STORE_SIZE 3584
+#define SCHEDULE_SLOT_SIZE 1792        // Variable-length table, 4 bytes/entry
+#define SCHEDULE_SLOT_A 0
+#define SCHEDULE_SLOT_B 1792
+#define SCHEDULE_RECORD_MAGIC 0x5343   // "SC"
+#define SCHEDULE_RECORD_VERSION 1
+
+// Earlier layout with the schedule slots inside a 4 KB EEPROM blob, only
+// read to migrate
+#define SHARED_EEPROM_SIZE 4096
+#define SHARED_SCHEDULE_SLOT_A 512
+#define SHARED_SCHEDULE_SLOT_B 2304
+
+// Scheduler
+#define MAX_SCHEDULES 256
+#define SCHEDULE_TARGET_BOTH 0         // Power jack and USB output
+#define SCHEDULE_TARGET_JACK 1
+#define SCHEDULE_TARGET_USB 2
+#define SCHEDULE_TARGET_PD 3           // Change PD voltage
+#define SCHEDULE_DAYS_ALL 0x7F         // Bit 0 = Sunday ... bit 6 = Saturday
+
+// Journal partition (see partitions.csv) for high-churn runtime state:
+// output states and the last known time
+#define JOURNAL_PARTITION_LABEL "journal"
+#define JOURNAL_PARTITION_SUBTYPE 0x40
+#define JOURNAL_SECTOR_SIZE 4096
+
+// Legacy (pre-record) layout, only read to migrate old units
 #define EEPROM_MAGIC 0xAB
 #define ADDR_MAGIC 0
 #define ADDR_SSID 1
@@ -60,7 +201,15 @@ static const uint32_t BAUD = 115200;
 // ============================================================================
 struct Schedule {
   uint16_t time;   // 0-2359 in 24hr format
-  uint8_t action;  // 0=off, 1=on
+  uint8_t action;  // 0=off, 1=on; volts for SCHEDULE_TARGET_PD
+  uint8_t days;    // Weekday bitmask (SCHEDULE_DAYS_ALL = every day)
+  uint8_t target;  // SCHEDULE_TARGET_*
+};
+
+// Allowed rail window for one output, in mV; 0 disables that side
+struct OutputLimits {
+  uint16_t minMv;
+  uint16_t maxMv;
 };
 
 struct Config {
@@ -69,10 +218,12 @@ struct Config {
   char timezone[8];
   time_t lastTime;
   uint8_t pdVoltage;       // 5, 9, 12, 15, or 20
-  uint8_t scheduleCount;
-  Schedule schedules[10];
+  uint16_t scheduleCount;
+  Schedule schedules[MAX_SCHEDULES];
   bool powerJackState;     // Power jack output state
   bool usbOutputState;     // USB output state
+  bool lowPower;           // Automatic light sleep (power.h)
+  OutputLimits outputLimits[2];  // By ProtectOutput (protection.h)
 };
 
 // ============================================================================
@@ -81,16 +232,7 @@ struct Config {
 extern Config config;
 extern bool powerJackState;
 extern bool usbOutputState;
-extern unsigned long lastWifiAttempt;
-extern unsigned long lastTimeUpdate;
-extern unsigned long lastButtonCheck;
 extern bool wifiConnected;
 extern time_t currentTime;
 
-// Button states
-extern bool lastButton1;
-extern bool lastButton2;
-extern bool lastButton3;
-extern bool lastButton4;
-
 #endif
@@ -0,0 +1,57 @@
+#include "control.h"
+#include "event_loop.h"
+#include "perf.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+struct ControlMsg {
+  ControlFn fn;
+  void *ctx;
+  TaskHandle_t caller;    // Notified once fn has run
+};
+
+static TaskHandle_t controlTask = nullptr;
+static QueueHandle_t controlQueue = nullptr;
+static int controlEvent = -1;
+
+static void drainQueue() {
+  PERF_SCOPE(PERF_CONTROL_QUEUE);
+  ControlMsg msg;
+  while (xQueueReceive(controlQueue, &msg, 0) == pdTRUE) {
+    msg.fn(msg.ctx);
+    xTaskNotifyGive(msg.caller);
+  }
+}
+
+static void controlTaskMain(void *) {
+  for (;;) {
+    runEventLoop();
+  }
+}
+
+void beginControlTask() {
+  controlQueue = xQueueCreate(CONTROL_QUEUE_LENGTH, sizeof(ControlMsg));
+  controlEvent = addEvent(drainQueue, 0);
+  xTaskCreate(controlTaskMain, "control", CONTROL_TASK_STACK, nullptr,
+              CONTROL_TASK_PRIORITY, &controlTask);
+}
+
+bool onControlTask() {
+  return controlTask == nullptr || xTaskGetCurrentTaskHandle() == controlTask;
+}
+
+void runOnControl(ControlFn fn, void *ctx) {
+  if (onControlTask()) {
+    fn(ctx);
+    return;
+  }
+
+  // The caller blocks until the control task has run fn, so ctx may live
+  // on the caller's stack. The control task has the higher priority and
+  // usually runs fn before triggerEvent() even returns.
+  ControlMsg msg = { fn, ctx, xTaskGetCurrentTaskHandle() };
+  xQueueSend(controlQueue, &msg, portMAX_DELAY);
+  triggerEvent(controlEvent);
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
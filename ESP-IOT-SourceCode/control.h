@@ -0,0 +1,26 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "config.h"
+
+// The control task owns the outputs, buttons, schedules, timers and the
+// config; it runs the event loop at CONTROL_TASK_PRIORITY. WiFi, the web
+// server and serial stay on the lower-priority Arduino loop task and hand
+// anything that changes state to the control task through a queue. Flash
+// writes are left to the storage task (storage.h).
+
+// Register the control queue's event and start the task. Call at the end
+// of setup(), after all events are registered.
+void beginControlTask();
+
+// True on the control task, and anywhere before it has started
+bool onControlTask();
+
+// Run fn(ctx) on the control task and wait for it to finish. Runs inline
+// when onControlTask(). Functions that change shared state use this to
+// forward calls made from other tasks:
+//   if (!onControlTask()) { runOnControl(...); return; }
+typedef void (*ControlFn)(void *ctx);
+void runOnControl(ControlFn fn, void *ctx);
+
+#endif
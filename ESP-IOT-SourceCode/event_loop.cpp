@@ -0,0 +1,189 @@
+#include "event_loop.h"
+#include "perf.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+// Pending events are kept in a binary min-heap ordered by deadline, so the
+// loop only ever looks at the top entry to know how long it may sleep.
+// Interrupts set a bit in a pending mask and notify the loop task, which
+// moves the event to the front of the heap on wakeup.
+struct Event {
+  EventHandler handler;
+  uint32_t periodMs;      // 0 = one-shot
+  uint32_t deadline;      // millis() value, compared wrap-safe
+  int8_t heapPos;         // Index in heap[], -1 when not armed
+};
+
+static Event events[EVENT_MAX];
+static uint8_t eventCount = 0;
+static uint8_t heap[EVENT_MAX];
+static uint8_t heapSize = 0;
+
+static TaskHandle_t ownerTask = nullptr;
+static volatile uint32_t pendingMask = 0;
+static int64_t triggeredAt[EVENT_MAX];  // Guarded by pendingMux
+static portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
+static EventLoopStats stats = {0, 0, 0, 0, 0, 0, 0};
+
+static bool before(uint8_t a, uint8_t b) {
+  return (int32_t)(events[a].deadline - events[b].deadline) < 0;
+}
+
+static void heapSet(uint8_t pos, uint8_t id) {
+  heap[pos] = id;
+  events[id].heapPos = pos;
+}
+
+static void siftUp(uint8_t pos) {
+  uint8_t id = heap[pos];
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (!before(id, heap[parent])) break;
+    heapSet(pos, heap[parent]);
+    pos = parent;
+  }
+  heapSet(pos, id);
+}
+
+static void siftDown(uint8_t pos) {
+  uint8_t id = heap[pos];
+  while (true) {
+    uint8_t child = pos * 2 + 1;
+    if (child >= heapSize) break;
+    if (child + 1 < heapSize && before(heap[child + 1], heap[child])) child++;
+    if (!before(heap[child], id)) break;
+    heapSet(pos, heap[child]);
+    pos = child;
+  }
+  heapSet(pos, id);
+}
+
+static void heapRemove(uint8_t id) {
+  int8_t pos = events[id].heapPos;
+  if (pos < 0) return;
+  events[id].heapPos = -1;
+  heapSize--;
+  if (pos == heapSize) return;
+  uint8_t last = heap[heapSize];
+  heapSet(pos, last);
+  siftDown(pos);
+  siftUp(events[last].heapPos);
+}
+
+static void arm(uint8_t id, uint32_t deadline) {
+  heapRemove(id);
+  events[id].deadline = deadline;
+  heapSet(heapSize, id);
+  heapSize++;
+  siftUp(heapSize - 1);
+}
+
+int addEvent(EventHandler handler, uint32_t periodMs) {
+  if (eventCount >= EVENT_MAX) return -1;
+  uint8_t id = eventCount++;
+  events[id].handler = handler;
+  events[id].periodMs = periodMs;
+  events[id].heapPos = -1;
+  if (periodMs > 0) arm(id, millis() + periodMs);
+  return id;
+}
+
+void scheduleEvent(int id, uint32_t delayMs) {
+  if (id < 0 || id >= eventCount) return;
+  arm(id, millis() + delayMs);
+}
+
+void cancelEvent(int id) {
+  if (id < 0 || id >= eventCount) return;
+  heapRemove(id);
+}
+
+void IRAM_ATTR triggerEventFromISR(int id) {
+  if (id < 0 || id >= EVENT_MAX) return;
+  portENTER_CRITICAL_ISR(&pendingMux);
+  if (!(pendingMask & (1UL << id))) triggeredAt[id] = esp_timer_get_time();
+  pendingMask |= 1UL << id;
+  portEXIT_CRITICAL_ISR(&pendingMux);
+  if (ownerTask != nullptr) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(ownerTask, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+void triggerEvent(int id) {
+  if (id < 0 || id >= EVENT_MAX) return;
+  portENTER_CRITICAL(&pendingMux);
+  if (!(pendingMask & (1UL << id))) triggeredAt[id] = esp_timer_get_time();
+  pendingMask |= 1UL << id;
+  portEXIT_CRITICAL(&pendingMux);
+  if (ownerTask != nullptr) xTaskNotifyGive(ownerTask);
+}
+
+void runEventLoop() {
+  if (ownerTask == nullptr) {
+    ownerTask = xTaskGetCurrentTaskHandle();
+    stats.startUs = esp_timer_get_time();
+  }
+
+  // Triggered events jump the queue
+  static int64_t since[EVENT_MAX];
+  static uint32_t latencyMask = 0;
+  portENTER_CRITICAL(&pendingMux);
+  uint32_t pending = pendingMask;
+  pendingMask = 0;
+  for (uint8_t id = 0; id < EVENT_MAX; id++) {
+    if ((pending & (1UL << id)) && !(latencyMask & (1UL << id))) since[id] = triggeredAt[id];
+  }
+  portEXIT_CRITICAL(&pendingMux);
+  latencyMask |= pending;
+  for (uint8_t id = 0; pending != 0; id++, pending >>= 1) {
+    if (pending & 1) arm(id, millis());
+  }
+
+  // Dispatch everything due. Periodic events are re-armed from their old
+  // deadline so they don't drift, unless they fell a whole period behind.
+  uint32_t now = millis();
+  {
+    PERF_SCOPE(PERF_CONTROL_LOOP);
+    while (heapSize > 0 && (int32_t)(now - events[heap[0]].deadline) >= 0) {
+      uint8_t id = heap[0];
+      Event &e = events[id];
+      if (e.periodMs > 0) {
+        uint32_t next = e.deadline + e.periodMs;
+        if ((int32_t)(now - next) >= 0) next = now + e.periodMs;
+        arm(id, next);
+      } else {
+        heapRemove(id);
+      }
+      if (latencyMask & (1UL << id)) {
+        latencyMask &= ~(1UL << id);
+        uint32_t latency = esp_timer_get_time() - since[id];
+        if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+        stats.sumLatencyUs += latency;
+        stats.triggered++;
+      }
+      e.handler();
+      stats.dispatched++;
+      now = millis();
+    }
+  }
+
+  // Sleep until the next deadline; a trigger ends the wait early
+  uint32_t waitMs = EVENT_MAX_SLEEP;
+  if (heapSize > 0) {
+    int32_t until = (int32_t)(events[heap[0]].deadline - now);
+    if (until < (int32_t)waitMs) waitMs = until > 0 ? until : 0;
+  }
+  if (waitMs == 0) return;
+
+  int64_t sleepStart = esp_timer_get_time();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+  stats.sleptUs += esp_timer_get_time() - sleepStart;
+  stats.wakeups++;
+}
+
+const EventLoopStats& getEventLoopStats() {
+  return stats;
+}
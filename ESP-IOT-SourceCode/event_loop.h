@@ -0,0 +1,39 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include "config.h"
+
+typedef void (*EventHandler)();
+
+struct EventLoopStats {
+  uint32_t dispatched;    // Handlers run
+  uint32_t wakeups;       // Returns from sleep
+  uint64_t sleptUs;       // Time spent blocked waiting for the next event
+  uint64_t startUs;       // When the loop started, for the idle ratio
+  uint32_t triggered;     // Triggered events dispatched
+  uint32_t maxLatencyUs;  // Worst trigger-to-handler delay
+  uint64_t sumLatencyUs;
+};
+
+// Register a handler. A non-zero period re-arms it automatically and
+// schedules the first run one period from now; one-shot events (period 0)
+// stay idle until scheduleEvent() or triggerEventFromISR(). Returns the
+// event id, or -1 when the table is full.
+int addEvent(EventHandler handler, uint32_t periodMs);
+
+// (Re)arm an event to run delayMs from now; replaces any pending deadline
+void scheduleEvent(int id, uint32_t delayMs);
+void cancelEvent(int id);
+
+// Run an event as soon as the loop wakes, from an interrupt handler or from
+// another task. The delay until the handler starts is tracked as latency.
+void triggerEventFromISR(int id);
+void triggerEvent(int id);
+
+// Run everything that is due, then block until the next deadline or a
+// trigger. Call repeatedly from one task.
+void runEventLoop();
+
+const EventLoopStats& getEventLoopStats();
+
+#endif
@@ -1,31 +1,135 @@
 #include "hardware.h"
 #include "storage.h"
+#include "journal.h"
+#include "control.h"
+#include "adc_sampler.h"
+#include "event_loop.h"
+#include "protection.h"
+#include <esp_timer.h>
+#include <esp_cpu.h>
 
 // ============================================================================
 // Power Output Control
 // ============================================================================
-void setPowerJackState(bool state) {
+bool setPowerJackState(bool state) {
+  if (!onControlTask()) {
+    struct Call { bool state, ok; } call = { state, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = setPowerJackState(c->state); }, &call);
+    return call.ok;
+  }
+  if (state) resumeAdcSampler();   // Protection needs every frame from now on
+  // State first so the ADC task judges the output from its first frame on;
+  // a trip in between refuses the pin
   powerJackState = state;
-  digitalWrite(POWER_JACK_PIN, state ? HIGH : LOW);
+  if (!protectionDrive(PROTECT_JACK, state)) {
+    powerJackState = false;
+    Serial.println(F("ERR: Power jack held off by a protection fault (/protect clear)"));
+    return false;
+  }
   config.powerJackState = state;
-  saveConfig();
+  journalPut(JOURNAL_POWER_JACK, state ? 1 : 0);
   Serial.print(F("Power Jack state: "));
   Serial.println(state ? F("ON (Enabled)") : F("OFF (Disabled)"));
+  return true;
 }
 
-void setUSBOutputState(bool state) {
+bool setUSBOutputState(bool state) {
+  if (!onControlTask()) {
+    struct Call { bool state, ok; } call = { state, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = setUSBOutputState(c->state); }, &call);
+    return call.ok;
+  }
+  if (state) resumeAdcSampler();   // Protection needs every frame from now on
+  // State first so the ADC task judges the output from its first frame on;
+  // a trip in between refuses the pin
   usbOutputState = state;
-  digitalWrite(USB_OUTPUT_PIN, state ? LOW : HIGH);  // Inverted: LOW=enable, HIGH=disable
+  if (!protectionDrive(PROTECT_USB, state)) {
+    usbOutputState = false;
+    Serial.println(F("ERR: USB output held off by a protection fault (/protect clear)"));
+    return false;
+  }
   config.usbOutputState = state;
-  saveConfig();
+  journalPut(JOURNAL_USB_OUTPUT, state ? 1 : 0);
   Serial.print(F("USB Output state: "));
   Serial.println(state ? F("ON (Enabled)") : F("OFF (Disabled)"));
+  return true;
 }
 
 // ============================================================================
 // PD Voltage Control via CH224K
 // ============================================================================
-void setPDVoltage(uint8_t voltage) {
+static PDStatus pd = { PD_IDLE, 0, 0, 0, 0, 0 };
+static int pdEvent = -1;
+static uint64_t pdStartUs = 0;
+static uint8_t pdStablePolls = 0;
+static PDHook pdHooks[PD_MAX_HOOKS];
+static uint8_t pdHookCount = 0;
+
+static void finishPD(PDState state, uint32_t vbusMv) {
+  pd.state = state;
+  pd.settleMs = (esp_timer_get_time() - pdStartUs) / 1000;
+  pd.measuredMv = vbusMv;
+  if (state == PD_FAILED) pd.failures++;
+
+  char volts[12];
+  formatVolts(volts, vbusMv);
+  if (state == PD_OK) {
+    Serial.print(F("PD: "));
+    Serial.print(pd.requested);
+    Serial.print(F("V reached in "));
+    Serial.print(pd.settleMs);
+    Serial.print(F("ms, VBUS "));
+  } else {
+    Serial.print(F("ERR: PD negotiation for "));
+    Serial.print(pd.requested);
+    Serial.print(F("V failed after "));
+    Serial.print(pd.settleMs);
+    Serial.print(F("ms, VBUS "));
+  }
+  Serial.print(volts);
+  Serial.println(F("V"));
+  formatVolts(volts, getVOutMillivolts());
+  Serial.print(F("Measured VOUT: "));
+  Serial.print(volts);
+  Serial.println(F("V"));
+
+  for (uint8_t i = 0; i < pdHookCount; i++) pdHooks[i](pd);
+}
+
+// Polls while an attempt is in progress. The filtered reading lags the rail
+// by a couple of frames, which is included in settleMs.
+static void pollPD() {
+  if (pd.state != PD_SETTLING) return;
+  uint32_t vbusMv = getVBusMillivolts();
+  uint32_t targetMv = pd.requested * 1000UL;
+  uint32_t toleranceMv = targetMv * PD_TOLERANCE_PERCENT / 100;
+  bool inTolerance = vbusMv + toleranceMv >= targetMv && vbusMv <= targetMv + toleranceMv;
+  pdStablePolls = inTolerance ? pdStablePolls + 1 : 0;
+
+  if (pdStablePolls >= PD_SETTLE_STABLE) {
+    finishPD(PD_OK, vbusMv);
+  } else if ((esp_timer_get_time() - pdStartUs) / 1000 >= PD_SETTLE_TIMEOUT) {
+    finishPD(PD_FAILED, vbusMv);
+  } else {
+    scheduleEvent(pdEvent, PD_POLL_INTERVAL);
+  }
+}
+
+void beginPD() {
+  pdEvent = addEvent(pollPD, 0);
+}
+
+void addPDHook(PDHook hook) {
+  if (pdHookCount < PD_MAX_HOOKS) pdHooks[pdHookCount++] = hook;
+}
+
+bool setPDVoltage(uint8_t voltage) {
+  if (!onControlTask()) {
+    struct Call { uint8_t voltage; bool ok; } call = { voltage, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = setPDVoltage(c->voltage); }, &call);
+    return call.ok;
+  }
+  
   // CH224K CFG pins control PD voltage request
   // CFG1 CFG2 CFG3 mapping:
   // 1XX = 5V
@@ -62,87 +166,131 @@ void setPDVoltage(uint8_t voltage) {
       break;
     default:
       Serial.println(F("ERR: Invalid PD voltage. Use 5, 9, 12, 15, or 20."));
-      return;
+      return false;
   }
   
+  // Until it settles the rail may still be at the old voltage, or at any
+  // voltage of an attempt this one interrupts
+  uint8_t from = config.pdVoltage;
+  if (pd.state == PD_SETTLING && pd.previous > from) from = pd.previous;
+  pd.previous = from;
+
   config.pdVoltage = voltage;
   saveConfig();
   Serial.print(F("PD voltage set to: "));
   Serial.print(voltage);
   Serial.println(F("V"));
   
-  // Wait a bit and verify
-  delay(500);
-  float measuredVBus = getVBusVoltage();
-  float measuredVOut = getVOutVoltage();
-  Serial.print(F("Measured VBUS: "));
-  Serial.print(measuredVBus, 2);
-  Serial.println(F("V"));
-  Serial.print(F("Measured VOUT: "));
-  Serial.print(measuredVOut, 2);
-  Serial.println(F("V"));
+  // Verify in the background; a newer request restarts the wait
+  pd.state = PD_SETTLING;
+  pd.requested = voltage;
+  pdStartUs = esp_timer_get_time();
+  pdStablePolls = 0;
+  resumeAdcSampler();   // Every poll needs a fresh frame, also in low-power mode
+  scheduleEvent(pdEvent, PD_POLL_INTERVAL);
+  return true;
+}
+
+const PDStatus& getPDStatus() {
+  return pd;
+}
+
+const char *pdStateName(PDState state) {
+  switch (state) {
+    case PD_SETTLING: return "settling";
+    case PD_OK:       return "ok";
+    case PD_FAILED:   return "failed";
+    default:          return "idle";
+  }
 }
 
 // ============================================================================
 // Voltage Sensing
 // ============================================================================
-float getVBusVoltage() {
-  int rawValue = analogRead(VBUS_ADC_PIN);
-  float adcVoltage = (rawValue * ADC_VREF / ADC_RESOLUTION);
-  float vbus = adcVoltage * VBUS_DIVIDER_RATIO;
-  return vbus;
+// Filtered values cached by the ADC sampler; no conversion happens here
+uint32_t getVBusMillivolts() {
+  return getAdcMillivolts(ADC_VBUS);
 }
 
-float getVOutVoltage() {
-  int rawValue = analogRead(VOUT_ADC_PIN);
-  float adcVoltage = (rawValue * ADC_VREF / ADC_RESOLUTION);
-  float vout = adcVoltage * VOUT_DIVIDER_RATIO;
-  return vout;
+uint32_t getVOutMillivolts() {
+  return getAdcMillivolts(ADC_VOUT);
+}
+
+void formatVolts(char *out, uint32_t mv) {
+  uint32_t cv = (mv + 5) / 10;   // Centivolts, rounded
+  uint32_t whole = cv / 100;
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + whole % 10;
+    whole /= 10;
+  } while (whole > 0);
+  while (n > 0) *out++ = digits[--n];
+  *out++ = '.';
+  *out++ = '0' + (cv % 100) / 10;
+  *out++ = '0' + cv % 10;
+  *out = '\0';
 }
 
 // ============================================================================
-// Button Handling
+// Float vs Integer Benchmark
 // ============================================================================
-void checkButtons() {
-  if (millis() - lastButtonCheck < BUTTON_DEBOUNCE) return;
-  lastButtonCheck = millis();
-  
-  // Button 1 - Toggle Power Jack
-  bool btn1 = digitalRead(BUTTON1_PIN);
-  if (btn1 == LOW && lastButton1 == HIGH) {
-    setPowerJackState(!powerJackState);
+#define BENCH_ROUNDS 1000
+
+// The conversion as it used to be: raw counts through the 3.3V reference,
+// the 12-bit range and the divider ratio, in soft-float
+static float floatVolts(int raw) {
+  float adcVoltage = (raw * 3.3 / 4095);
+  return adcVoltage * 10.216;
+}
+
+void benchVoltagePath(VoltageBench &r) {
+  volatile uint32_t input = 2800;   // Defeats constant folding
+  volatile uint32_t sink = 0;
+  char buf[12];
+  uint32_t start;
+
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) sink = sink + (uint32_t)floatVolts(input + (i & 63));
+  r.floatConvert = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS;
+
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) sink = sink + railMillivolts(input + (i & 63), VBUS_DIVIDER_Q16);
+  r.intConvert = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS;
+
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+    String s = String(floatVolts(input + (i & 63)), 2);
+    sink = sink + s.length();
   }
-  lastButton1 = btn1;
-  
-  // Button 2 - Toggle USB Output
-  bool btn2 = digitalRead(BUTTON2_PIN);
-  if (btn2 == LOW && lastButton2 == HIGH) {
-    setUSBOutputState(!usbOutputState);
+  r.floatFormat = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS - r.floatConvert;
+
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+    formatVolts(buf, input * 3 + (i & 63));
+    sink = sink + buf[0];
   }
-  lastButton2 = btn2;
-  
-  // Button 3 - Cycle PD Voltage (5V -> 9V -> 12V -> 15V -> 20V -> 5V)
-  bool btn3 = digitalRead(BUTTON3_PIN);
-  if (btn3 == LOW && lastButton3 == HIGH) {
-    uint8_t nextVoltage;
-    switch (config.pdVoltage) {
-      case 5:  nextVoltage = 9;  break;
-      case 9:  nextVoltage = 12; break;
-      case 12: nextVoltage = 15; break;
-      case 15: nextVoltage = 20; break;
-      case 20: nextVoltage = 5;  break;
-      default: nextVoltage = 9;  break;
-    }
-    setPDVoltage(nextVoltage);
+  r.intFormat = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS;
+
+  // The voltage part of /api/status, conversion included
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+    String json = "\"vbus\":" + String(floatVolts(input + (i & 63)), 2) + ",";
+    json += "\"vout\":" + String(floatVolts(input - (i & 63)), 2) + ",";
+    sink = sink + json.length();
   }
-  lastButton3 = btn3;
-  
-  // Button 4 - Turn everything ON
-  bool btn4 = digitalRead(BUTTON4_PIN);
-  if (btn4 == LOW && lastButton4 == HIGH) {
-    Serial.println(F("Button 4: Enabling all outputs"));
-    setPowerJackState(true);
-    setUSBOutputState(true);
+  r.floatStatus = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS;
+
+  start = esp_cpu_get_cycle_count();
+  for (uint32_t i = 0; i < BENCH_ROUNDS; i++) {
+    String json = "\"vbus\":";
+    formatVolts(buf, railMillivolts(input + (i & 63), VBUS_DIVIDER_Q16));
+    json += buf;
+    json += ",\"vout\":";
+    formatVolts(buf, railMillivolts(input - (i & 63), VOUT_DIVIDER_Q16));
+    json += buf;
+    json += ",";
+    sink = sink + json.length();
   }
-  lastButton4 = btn4;
+  r.intStatus = (esp_cpu_get_cycle_count() - start) / BENCH_ROUNDS;
 }
@@ -3,18 +3,54 @@
 
 #include "config.h"
 
-// Power output control
-void setPowerJackState(bool state);
-void setUSBOutputState(bool state);
+// Power output control. Switching on returns false, and leaves the output
+// off, while a protection fault is latched for it.
+bool setPowerJackState(bool state);
+bool setUSBOutputState(bool state);
 
-// PD voltage control
-void setPDVoltage(uint8_t voltage);
+// PD voltage control. setPDVoltage() only drives the CH224K CFG pins and
+// returns; the control task then watches VBUS until it reaches the new
+// voltage (PD_OK) or PD_SETTLE_TIMEOUT passes (PD_FAILED).
+enum PDState : uint8_t {
+  PD_IDLE,       // No request since boot
+  PD_SETTLING,
+  PD_OK,
+  PD_FAILED
+};
 
-// Voltage sensing
-float getVBusVoltage();
-float getVOutVoltage();
+struct PDStatus {
+  PDState state;
+  uint8_t requested;     // Volts
+  uint8_t previous;      // Highest setting the rail may still be at while settling
+  uint32_t settleMs;     // Request to VBUS in tolerance, or time waited
+  uint32_t measuredMv;   // VBUS when the attempt finished
+  uint32_t failures;     // Failed attempts since boot
+};
 
-// Button handling
-void checkButtons();
+// Called on the control task when an attempt finishes
+typedef void (*PDHook)(const PDStatus &status);
+
+// Register the settle event; before the first setPDVoltage()
+void beginPD();
+void addPDHook(PDHook hook);
+bool setPDVoltage(uint8_t voltage);   // False for an unsupported voltage
+const PDStatus& getPDStatus();
+const char *pdStateName(PDState state);
+
+// Voltage sensing: filtered rail voltages from the ADC sampler
+uint32_t getVBusMillivolts();
+uint32_t getVOutMillivolts();
+
+// Millivolts as volts with two decimals ("9.02"); out needs 12 bytes
+void formatVolts(char *out, uint32_t mv);
+
+// Average CPU cycles per operation, the old float path against the
+// integer one (/bench)
+struct VoltageBench {
+  uint32_t floatConvert, intConvert;   // ADC reading to rail voltage
+  uint32_t floatFormat, intFormat;     // Voltage to "9.02"
+  uint32_t floatStatus, intStatus;     // Both rails into status JSON
+};
+void benchVoltagePath(VoltageBench &r);
 
 #endif
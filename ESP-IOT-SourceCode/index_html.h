@@ -0,0 +1,294 @@
+// Generated by tools/embed_ui.py from web/index.html - do not edit
+#ifndef INDEX_HTML_H
+#define INDEX_HTML_H
+
+#include <Arduino.h>
+
+// 17618 bytes of HTML, gzip-compressed
+#define INDEX_HTML_GZ_LEN 4470
+#define INDEX_HTML_ETAG "\"8854da180feb52e4\""
+
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0x3c, 0xdb, 0x72, 0xdb, 0xc8,
+  0x95, 0xef, 0xfe, 0x8a, 0x1e, 0x8e, 0x67, 0x08, 0xc6, 0xbc, 0x53, 0xa4, 0x45, 0x4a, 0x62, 0xca,
+  0xb6, 0xe4, 0xd8, 0xb3, 0xb6, 0xa4, 0x0a, 0x69, 0x4f, 0x4d, 0xcd, 0xce, 0x96, 0x40, 0xa2, 0x41,
+  0xc2, 0x06, 0x01, 0x14, 0xba, 0x29, 0x5a, 0x56, 0xf8, 0xb6, 0x4f, 0x9b, 0xa4, 0x52, 0xbb, 0xc9,
+  0xd6, 0x56, 0xf2, 0x90, 0x54, 0xfe, 0x60, 0x1f, 0xf6, 0x61, 0x9f, 0xf6, 0x63, 0xe6, 0x07, 0x36,
+  0x9f, 0xb0, 0xe7, 0x74, 0xe3, 0xd2, 0x0d, 0x02, 0x14, 0x65, 0x4b, 0x93, 0x97, 0xa5, 0x6b, 0x48,
+  0xa0, 0x2f, 0xa7, 0xcf, 0xad, 0xcf, 0xad, 0x5b, 0x73, 0xf8, 0xc5, 0xf1, 0xd9, 0xb3, 0xf1, 0x77,
+  0xe7, 0x27, 0x64, 0xce, 0x17, 0xee, 0xf0, 0xc1, 0x61, 0xfc, 0x43, 0x4d, 0x6b, 0xf8, 0x80, 0x90,
+  0xc3, 0x05, 0xe5, 0x26, 0x99, 0xce, 0xcd, 0x90, 0x51, 0x7e, 0x54, 0x7a, 0x33, 0x7e, 0x5e, 0xdb,
+  0x2f, 0xa5, 0x1d, 0x9e, 0xb9, 0xa0, 0x47, 0xa5, 0x4b, 0x87, 0xae, 0x02, 0x3f, 0xe4, 0x25, 0x32,
+  0xf5, 0x3d, 0x4e, 0x3d, 0x18, 0xb8, 0x72, 0x2c, 0x3e, 0x3f, 0xb2, 0xe8, 0xa5, 0x33, 0xa5, 0x35,
+  0xf1, 0x52, 0x25, 0x8e, 0xe7, 0x70, 0xc7, 0x74, 0x6b, 0x6c, 0x6a, 0xba, 0xf4, 0xa8, 0x55, 0x6f,
+  0x4a, 0x40, 0xdc, 0xe1, 0x2e, 0x1d, 0xbe, 0x3c, 0x1b, 0x93, 0xd1, 0xca, 0xe1, 0xd3, 0x39, 0x79,
+  0x06, 0x40, 0x42, 0xdf, 0x3d, 0x6c, 0xc8, 0x1e, 0x1c, 0xc3, 0xf8, 0x95, 0x7c, 0x22, 0xe4, 0x67,
+  0xe4, 0x9a, 0x2c, 0xcc, 0x70, 0xe6, 0x78, 0x03, 0xd2, 0x3c, 0x20, 0x81, 0x69, 0x59, 0x8e, 0x37,
+  0x13, 0xcf, 0x13, 0xff, 0x43, 0x8d, 0x39, 0x1f, 0xc5, 0xeb, 0xc4, 0x0f, 0x2d, 0x1a, 0xd6, 0xa0,
+  0xe9, 0x80, 0xac, 0xc5, 0xc4, 0x89, 0x6f, 0x5d, 0xc1, 0x5c, 0xf1, 0x4c, 0x88, 0x0d, 0x8b, 0xd4,
+  0x6c, 0x73, 0xe1, 0xb8, 0x57, 0x03, 0x52, 0x1e, 0xd1, 0x99, 0x4f, 0xc9, 0x9b, 0x97, 0xe5, 0x2a,
+  0x19, 0x9b, 0x73, 0x7f, 0x61, 0x56, 0xc9, 0x2f, 0xa8, 0x47, 0x2f, 0xe1, 0xf7, 0x2d, 0x0d, 0x2d,
+  0xd3, 0x83, 0x07, 0x66, 0x7a, 0xac, 0xc6, 0x68, 0xe8, 0xd8, 0x07, 0x31, 0x90, 0x89, 0x39, 0x7d,
+  0x3f, 0x0b, 0xfd, 0xa5, 0x67, 0x0d, 0x88, 0xeb, 0x78, 0xd4, 0x0c, 0x6b, 0xb3, 0xd0, 0xb4, 0x1c,
+  0x60, 0x81, 0xd1, 0xea, 0x74, 0x2d, 0x3a, 0xab, 0x92, 0x2f, 0x7b, 0xbd, 0xc7, 0x94, 0x9a, 0xa4,
+  0xf9, 0x15, 0x3c, 0x3f, 0xee, 0xed, 0x4d, 0xcc, 0x36, 0x69, 0x35, 0x9b, 0x5f, 0x55, 0x0e, 0x22,
+  0x20, 0x0b, 0xc7, 0xab, 0xcd, 0xa9, 0x33, 0x9b, 0xf3, 0x01, 0x76, 0x5c, 0xce, 0xe3, 0x8e, 0x84,
+  0xb4, 0x76, 0x33, 0xf8, 0x20, 0x1b, 0x25, 0x25, 0x75, 0x64, 0xb3, 0x09, 0xeb, 0x85, 0x29, 0x3d,
+  0x0b, 0xf3, 0x83, 0xe4, 0xf3, 0x80, 0xec, 0x37, 0x71, 0x7c, 0xda, 0x11, 0xf1, 0x8a, 0x98, 0x4b,
+  0xee, 0xe7, 0xa2, 0xbe, 0x9a, 0x3b, 0x9c, 0xa6, 0x3d, 0x92, 0x73, 0x48, 0xc7, 0x92, 0x01, 0x4a,
+  0x6d, 0x05, 0x58, 0x82, 0x52, 0x27, 0x41, 0x89, 0x48, 0xb6, 0xcf, 0x4d, 0xcb, 0x5f, 0xe1, 0x2a,
+  0x88, 0x2c, 0xe9, 0xe1, 0x57, 0x38, 0x9b, 0x98, 0x46, 0xb3, 0x2a, 0xfe, 0xd5, 0x3b, 0x15, 0x95,
+  0x82, 0x79, 0x2b, 0xc5, 0x7c, 0xea, 0xbb, 0x7e, 0x38, 0x88, 0xf9, 0x94, 0xc1, 0x1b, 0x04, 0xc8,
+  0xb9, 0xbf, 0x40, 0xce, 0xa4, 0x0b, 0x0a, 0xd9, 0x81, 0xa0, 0x29, 0xb0, 0x86, 0x2e, 0x34, 0xce,
+  0xb0, 0xe5, 0x44, 0x68, 0x4d, 0x1e, 0xf8, 0x5e, 0x11, 0xec, 0x8e, 0xca, 0x2f, 0x05, 0x78, 0xb3,
+  0xde, 0xcf, 0x82, 0xa7, 0x53, 0xee, 0xf8, 0x9e, 0xca, 0xf6, 0x62, 0x48, 0xba, 0xfc, 0xf2, 0x18,
+  0xff, 0xa5, 0xbd, 0x6f, 0xf7, 0x6d, 0xb3, 0x88, 0xf5, 0xfb, 0x19, 0xb1, 0xc7, 0xab, 0xcf, 0xdb,
+  0x9b, 0xe4, 0x75, 0x3a, 0x9d, 0x42, 0xd6, 0x75, 0x73, 0x59, 0xd7, 0xaa, 0x77, 0x62, 0xea, 0x48,
+  0xba, 0x5d, 0xe4, 0x14, 0x90, 0x39, 0x61, 0xbe, 0xeb, 0x58, 0x89, 0x58, 0x74, 0x9a, 0x92, 0x81,
+  0x1b, 0x28, 0x72, 0x93, 0x2f, 0x19, 0xec, 0x02, 0x98, 0x7a, 0x1d, 0xcd, 0xb1, 0x1c, 0x16, 0xb8,
+  0x26, 0x6c, 0x33, 0x6c, 0x8d, 0x01, 0xe1, 0x73, 0x8d, 0xd3, 0x05, 0xf4, 0x70, 0x5a, 0x03, 0x2a,
+  0x96, 0x0b, 0x0f, 0x48, 0x0e, 0x69, 0x40, 0x4d, 0x6e, 0xa0, 0xaa, 0xd6, 0x6c, 0x87, 0x57, 0x71,
+  0x77, 0x80, 0x6a, 0x1b, 0x6d, 0xd4, 0xe9, 0x2a, 0x69, 0xd9, 0x61, 0x25, 0xd9, 0x38, 0x33, 0x33,
+  0xd0, 0x89, 0x8b, 0xe8, 0xe6, 0xbe, 0xd6, 0xae, 0x63, 0x06, 0x9a, 0xbe, 0x48, 0x30, 0xdb, 0xdc,
+  0x04, 0x59, 0xd1, 0x09, 0xed, 0xcf, 0x97, 0x4e, 0x6f, 0xa3, 0xc7, 0xa5, 0x36, 0xec, 0xe1, 0xbd,
+  0x7c, 0xde, 0xe9, 0x68, 0xb8, 0xe6, 0x84, 0xba, 0x19, 0x6b, 0x14, 0x2b, 0xdd, 0x7e, 0x17, 0xe4,
+  0x72, 0x0b, 0xf5, 0x2d, 0xa0, 0xf4, 0xd2, 0x74, 0x97, 0x34, 0x77, 0x89, 0x56, 0xbd, 0xa5, 0xac,
+  0x20, 0x3a, 0x56, 0x91, 0x01, 0x9a, 0xf8, 0xae, 0x75, 0x90, 0xa7, 0x5b, 0xea, 0x02, 0x93, 0x25,
+  0x2c, 0xec, 0xd5, 0x90, 0x73, 0x41, 0xba, 0x40, 0x22, 0x66, 0xdb, 0xa5, 0xa9, 0xba, 0x4b, 0x21,
+  0x69, 0x1b, 0x0c, 0xba, 0x6b, 0xab, 0x10, 0xdb, 0xf1, 0x7b, 0x17, 0xe1, 0xc9, 0x05, 0xd3, 0xa5,
+  0x34, 0xf1, 0x90, 0xf6, 0x5e, 0xfe, 0xf6, 0x6d, 0xf5, 0xd4, 0x6d, 0x27, 0x44, 0x34, 0x20, 0x9e,
+  0xef, 0x15, 0x9a, 0x3a, 0x75, 0xfc, 0x74, 0x19, 0x32, 0x24, 0x3e, 0xf0, 0x1d, 0x70, 0x69, 0xe1,
+  0x41, 0x1e, 0xb3, 0x7a, 0xcd, 0x66, 0xdc, 0xce, 0x43, 0xf0, 0x0e, 0x0e, 0xee, 0xce, 0x01, 0x31,
+  0x5d, 0x17, 0xa4, 0xd8, 0x61, 0x07, 0x0a, 0xc1, 0x80, 0x8d, 0x6a, 0xef, 0x23, 0x4b, 0xdd, 0xda,
+  0xb0, 0xec, 0x13, 0xee, 0xd5, 0x54, 0x4a, 0x35, 0x6b, 0xd1, 0x6a, 0x4e, 0xfa, 0xfb, 0xad, 0xac,
+  0x78, 0x14, 0xc5, 0xd5, 0x80, 0x0c, 0xe6, 0xfe, 0xa5, 0xea, 0x21, 0x34, 0x50, 0xcd, 0x6e, 0xbf,
+  0xd7, 0xeb, 0x6b, 0xd8, 0xdb, 0x7e, 0x08, 0xca, 0x24, 0x1e, 0x71, 0x4f, 0x7e, 0x67, 0xd4, 0x80,
+  0xb9, 0x95, 0x7c, 0x23, 0x8f, 0x3a, 0x2e, 0x78, 0x2f, 0x6c, 0x7c, 0xab, 0x07, 0x3b, 0x73, 0xbf,
+  0x0b, 0x5f, 0xed, 0x7e, 0x15, 0x48, 0xdf, 0xab, 0x6c, 0xa2, 0x63, 0xdb, 0x05, 0x98, 0x50, 0x7b,
+  0x0f, 0x3e, 0x3b, 0x12, 0x65, 0xdb, 0x5b, 0xa9, 0xb2, 0xa6, 0xed, 0x5e, 0xbb, 0x77, 0x47, 0x54,
+  0xb5, 0x3b, 0x40, 0x4c, 0x6f, 0x5f, 0xfe, 0x97, 0x4b, 0x54, 0x10, 0x3a, 0xa0, 0xb5, 0x57, 0x05,
+  0xc8, 0x64, 0xfc, 0xd9, 0x56, 0xc2, 0x22, 0x48, 0x5b, 0x89, 0xeb, 0x76, 0x7b, 0xfb, 0x56, 0xe7,
+  0xae, 0x44, 0xd6, 0x6c, 0xa3, 0xb8, 0x40, 0x70, 0xed, 0xce, 0x5e, 0x01, 0x79, 0x10, 0xf6, 0xcc,
+  0x0a, 0xb1, 0xb1, 0xbb, 0x7d, 0xda, 0x9c, 0xec, 0x46, 0x9d, 0x04, 0xb4, 0x5d, 0x72, 0xfd, 0xc7,
+  0x8f, 0x9b, 0x77, 0x26, 0xb9, 0x3d, 0xd4, 0xc5, 0x2e, 0x88, 0xad, 0xd5, 0xda, 0xa4, 0xcd, 0xf1,
+  0x82, 0x25, 0x38, 0x16, 0x46, 0x5d, 0x70, 0xa7, 0x79, 0x36, 0x45, 0x35, 0x56, 0xf1, 0x46, 0x85,
+  0x80, 0x2d, 0x6b, 0x7e, 0x85, 0xa5, 0xda, 0xcf, 0x31, 0x31, 0x8a, 0xf3, 0xa4, 0x5d, 0xfa, 0x98,
+  0x4e, 0xb6, 0xd9, 0x9b, 0x1c, 0xb3, 0xb5, 0x97, 0x36, 0xab, 0x66, 0x25, 0x9a, 0x2c, 0x38, 0xad,
+  0xd8, 0x17, 0x85, 0xa8, 0x81, 0xed, 0x4f, 0x97, 0x2c, 0x26, 0x4d, 0xbe, 0xa5, 0x04, 0xfa, 0x4b,
+  0x8e, 0x31, 0x6a, 0xbe, 0x09, 0xcc, 0x04, 0x61, 0xaa, 0x04, 0x51, 0x0e, 0x59, 0x5b, 0x5f, 0x18,
+  0x61, 0x6c, 0xce, 0xc9, 0x78, 0xba, 0xc4, 0x4b, 0x4c, 0x5c, 0x7f, 0xfa, 0x7e, 0x9b, 0x4b, 0x23,
+  0x37, 0x98, 0xdc, 0x22, 0xef, 0xc4, 0xa6, 0x73, 0x6a, 0x2d, 0x5d, 0xfa, 0x39, 0xae, 0x7e, 0x4b,
+  0xf0, 0x59, 0x2c, 0x43, 0xdd, 0x01, 0x46, 0x8d, 0xef, 0x96, 0x8c, 0x3b, 0xf6, 0x55, 0x2d, 0xca,
+  0x8c, 0x06, 0x84, 0x05, 0x26, 0xa4, 0x44, 0x13, 0xca, 0x57, 0x94, 0x7a, 0xf1, 0x28, 0xd3, 0x75,
+  0x66, 0x9e, 0x40, 0x18, 0x40, 0x4e, 0xa9, 0xea, 0x71, 0x6e, 0x13, 0x5b, 0xc4, 0x94, 0x73, 0x67,
+  0x91, 0xf5, 0xfc, 0x5b, 0x1d, 0xbc, 0x1e, 0xe3, 0x6d, 0x44, 0x0a, 0xb9, 0x6b, 0x98, 0x99, 0x48,
+  0x38, 0xe1, 0x63, 0xbc, 0x17, 0x77, 0x4a, 0x28, 0x36, 0x03, 0x9f, 0xad, 0x52, 0x8f, 0x90, 0x90,
+  0x6b, 0x17, 0x3b, 0x4a, 0xab, 0x65, 0x9b, 0xb4, 0xbb, 0x41, 0x66, 0xb3, 0xd7, 0xb5, 0xf7, 0x7a,
+  0xb9, 0x90, 0x0a, 0xdd, 0x93, 0x4d, 0x69, 0x9b, 0xb6, 0x37, 0x40, 0xf5, 0xfb, 0xad, 0x49, 0x6b,
+  0xa2, 0x81, 0x0a, 0xfc, 0x15, 0x50, 0x89, 0xc1, 0x17, 0xdd, 0x0c, 0x7d, 0x1d, 0x0f, 0xf7, 0x5e,
+  0x4d, 0x2a, 0x7d, 0x96, 0x63, 0xfb, 0x18, 0xc4, 0x14, 0xab, 0x58, 0x3b, 0x9b, 0xfa, 0x68, 0xb2,
+  0xcc, 0x13, 0x5a, 0x36, 0x2b, 0x92, 0xa8, 0xdd, 0x01, 0xbb, 0x22, 0x40, 0x77, 0xc0, 0xad, 0x90,
+  0xda, 0x21, 0x65, 0xf3, 0x1a, 0xf8, 0x87, 0xdc, 0x3d, 0xfa, 0xe5, 0xfe, 0xa4, 0x3b, 0xb5, 0x7b,
+  0x07, 0x85, 0xfe, 0x25, 0xc3, 0xbf, 0x56, 0x6f, 0xf7, 0x40, 0x3d, 0x32, 0x81, 0x3b, 0x44, 0x7a,
+  0x1b, 0x79, 0x20, 0x46, 0x73, 0xbe, 0x09, 0xbc, 0x0f, 0x51, 0x04, 0x45, 0x14, 0xc5, 0xae, 0x2e,
+  0x8f, 0xae, 0xc7, 0xd3, 0x8e, 0x49, 0xad, 0x74, 0xe6, 0x61, 0x23, 0x2a, 0x6e, 0x1c, 0x36, 0x64,
+  0xd1, 0xe5, 0x10, 0x0b, 0x15, 0xa2, 0xea, 0x61, 0x39, 0x97, 0x64, 0xea, 0x9a, 0x8c, 0x1d, 0x95,
+  0x92, 0x8c, 0xbf, 0x24, 0xab, 0x20, 0x87, 0xf3, 0xd6, 0xf0, 0xc7, 0x3f, 0xfd, 0x95, 0xe4, 0x95,
+  0x4d, 0xa0, 0x4b, 0x8e, 0x09, 0xe2, 0xd9, 0x71, 0x56, 0x5c, 0x1a, 0x9e, 0x8c, 0xce, 0x3b, 0xed,
+  0xda, 0xb3, 0x1e, 0x39, 0x5e, 0x9a, 0x2e, 0x39, 0x5b, 0x72, 0x70, 0x1b, 0xe4, 0x1c, 0xa5, 0x4a,
+  0x5e, 0x9b, 0x9e, 0x39, 0xa3, 0x0b, 0x30, 0x3e, 0x64, 0x74, 0xc5, 0xc0, 0x14, 0x1d, 0x36, 0x82,
+  0xe1, 0x03, 0x09, 0x49, 0xc1, 0x24, 0x4a, 0x42, 0x23, 0x3c, 0x10, 0x93, 0xf6, 0xf0, 0x6f, 0x7f,
+  0xf9, 0xfd, 0xbf, 0x44, 0x93, 0xc8, 0x48, 0x64, 0x1f, 0xb1, 0x06, 0x40, 0x7f, 0x14, 0xbc, 0x47,
+  0xd3, 0x15, 0x2e, 0x95, 0x88, 0xef, 0x4d, 0x5d, 0x67, 0xfa, 0xfe, 0xa8, 0x04, 0x3c, 0xb5, 0xe4,
+  0x44, 0xa3, 0x52, 0x02, 0x70, 0x7f, 0xf8, 0x67, 0xf2, 0x4b, 0x39, 0xf0, 0xb0, 0x21, 0xe7, 0x27,
+  0xcb, 0x35, 0x60, 0xbd, 0xf8, 0x59, 0x45, 0x2b, 0x4d, 0x3c, 0x4b, 0xc4, 0xb1, 0xe2, 0x86, 0x5f,
+  0xe0, 0xfb, 0x30, 0x45, 0x66, 0x73, 0x06, 0x1a, 0x5d, 0x65, 0x44, 0xee, 0x18, 0xe1, 0xc3, 0x4a,
+  0xc3, 0x57, 0x80, 0x25, 0x28, 0x5c, 0xbd, 0x5e, 0x3f, 0x6c, 0xc0, 0x20, 0x05, 0xac, 0xfa, 0xaa,
+  0xbc, 0x44, 0x8f, 0x3b, 0xf2, 0xf0, 0x0f, 0xbf, 0x89, 0x24, 0xf1, 0x0d, 0xe8, 0x8b, 0x22, 0xce,
+  0x5c, 0x7a, 0xd5, 0x1c, 0x4c, 0x25, 0x50, 0xe7, 0xb6, 0xcc, 0x04, 0x14, 0x46, 0x33, 0xca, 0xc5,
+  0x1a, 0xb8, 0x84, 0xc1, 0xc3, 0x25, 0x05, 0x76, 0xa3, 0x1e, 0x9d, 0x78, 0xe6, 0xc4, 0xa5, 0x62,
+  0xe5, 0x2c, 0xc7, 0xf3, 0x81, 0xda, 0x76, 0x11, 0x54, 0xdb, 0x74, 0x19, 0x95, 0x52, 0xfc, 0x2f,
+  0x72, 0xec, 0xb0, 0x42, 0xc0, 0x9f, 0xce, 0xa8, 0x5f, 0x93, 0x37, 0xa3, 0xa7, 0xb1, 0xf6, 0xde,
+  0x1b, 0xa3, 0x60, 0x0d, 0xb9, 0x44, 0x0e, 0xa3, 0xa0, 0xef, 0xd3, 0xf8, 0x94, 0x02, 0xcd, 0xe5,
+  0x53, 0x0e, 0xdc, 0x4f, 0x64, 0xd3, 0x8f, 0x7f, 0xfa, 0xe3, 0xff, 0xfe, 0xf7, 0xef, 0xc8, 0xf9,
+  0x31, 0x79, 0xeb, 0xbb, 0x1c, 0x76, 0xf6, 0xe7, 0x33, 0x28, 0xca, 0x52, 0x32, 0x82, 0x3f, 0x36,
+  0xba, 0x40, 0x45, 0xf7, 0xed, 0x4e, 0xfc, 0x28, 0x02, 0xd1, 0x07, 0x10, 0xfd, 0xcf, 0x03, 0xd1,
+  0x6a, 0x03, 0x8c, 0x56, 0xfb, 0x33, 0x81, 0x20, 0x2d, 0xad, 0xcf, 0x24, 0xa6, 0xdd, 0x04, 0x20,
+  0xed, 0xe6, 0xdb, 0xbb, 0x92, 0xe4, 0xef, 0xfe, 0x93, 0x8c, 0xa2, 0xb0, 0x2b, 0xb2, 0xd2, 0xe1,
+  0x86, 0x30, 0x85, 0xc9, 0x8b, 0x06, 0xbd, 0x72, 0x18, 0x2f, 0x0d, 0x75, 0xa3, 0xa4, 0xac, 0x91,
+  0x06, 0xe7, 0x25, 0x22, 0x7c, 0xcf, 0x51, 0x49, 0x4d, 0x69, 0x44, 0xb8, 0xa1, 0x2a, 0x82, 0xb0,
+  0x7e, 0xc3, 0x27, 0x96, 0x45, 0x4e, 0xe9, 0x2a, 0xc5, 0x04, 0xd2, 0xac, 0xda, 0xdc, 0x5f, 0x86,
+  0x04, 0xe1, 0x99, 0xbc, 0x32, 0x38, 0x6c, 0xc8, 0x91, 0xe9, 0x4c, 0x91, 0x95, 0x10, 0x7e, 0x15,
+  0xc0, 0x12, 0x9c, 0x7e, 0xe0, 0xa5, 0x14, 0xcd, 0x31, 0x84, 0xa8, 0x25, 0x02, 0xc1, 0xd1, 0x94,
+  0xce, 0x21, 0x8c, 0xa1, 0xe1, 0x51, 0xe9, 0xc5, 0x8b, 0xd7, 0xaf, 0x89, 0x41, 0xeb, 0xb3, 0x3a,
+  0x24, 0x6d, 0x8f, 0x3b, 0x4d, 0xcc, 0x4d, 0x51, 0x1e, 0x58, 0xdb, 0x76, 0xa9, 0x37, 0xe3, 0xf3,
+  0xa3, 0xd2, 0x5e, 0x89, 0x28, 0xa6, 0x3a, 0x0a, 0x03, 0x38, 0xb8, 0x6d, 0xef, 0xa8, 0xf4, 0x7d,
+  0xb3, 0xd6, 0xfe, 0x01, 0xbe, 0xfa, 0xf8, 0xd5, 0x95, 0x4f, 0x09, 0x85, 0x5a, 0xbd, 0x7f, 0xe1,
+  0x7b, 0xbe, 0x88, 0xc3, 0x35, 0x3a, 0xd9, 0x02, 0x2b, 0x37, 0xd1, 0xf8, 0x6c, 0x9e, 0xa2, 0x72,
+  0x48, 0x64, 0x27, 0x6a, 0x61, 0x4e, 0xf3, 0x1f, 0x27, 0x18, 0x45, 0x10, 0x11, 0x82, 0x9b, 0x8c,
+  0xec, 0x41, 0x0c, 0x38, 0x73, 0x38, 0x84, 0x21, 0x4d, 0xf8, 0xd4, 0xda, 0x9d, 0x6e, 0x5f, 0xa5,
+  0x91, 0x1c, 0x91, 0xc7, 0x03, 0xf8, 0x79, 0xf2, 0x5a, 0x52, 0x0b, 0xef, 0xad, 0xd6, 0x00, 0x7e,
+  0xcf, 0x5f, 0x57, 0x14, 0xf7, 0x22, 0x50, 0x53, 0x51, 0x95, 0xc9, 0x6b, 0xc2, 0xcd, 0x27, 0x52,
+  0x6b, 0xf2, 0xc4, 0xd9, 0xca, 0x88, 0x13, 0x66, 0xfb, 0x81, 0x08, 0xdd, 0x45, 0x81, 0xf0, 0xa8,
+  0xd4, 0x2a, 0x0d, 0xc7, 0xcb, 0xd0, 0x23, 0x67, 0xa7, 0x87, 0x0d, 0xd9, 0xb3, 0x65, 0x70, 0x33,
+  0x1e, 0xfc, 0xfc, 0xf9, 0x0e, 0xa3, 0x03, 0xab, 0x5b, 0x1a, 0x8e, 0x28, 0x47, 0x2b, 0x84, 0x7b,
+  0x6a, 0x87, 0x09, 0xfd, 0x64, 0x42, 0x7f, 0xb7, 0x09, 0xad, 0x76, 0x32, 0x43, 0x6c, 0xfe, 0x5d,
+  0xa6, 0xa4, 0x58, 0xb5, 0x76, 0x44, 0xab, 0xdd, 0x4c, 0xa6, 0x88, 0x8d, 0x9d, 0x9d, 0x02, 0x22,
+  0x12, 0x22, 0xd9, 0x22, 0xa3, 0x31, 0x08, 0x85, 0xf2, 0x4f, 0x93, 0x11, 0x24, 0xa2, 0xf3, 0xd2,
+  0xf0, 0x29, 0x7c, 0x63, 0x1a, 0x0f, 0x9b, 0x8a, 0xed, 0x80, 0xf5, 0x3b, 0xf0, 0xb9, 0xa5, 0xa1,
+  0x0c, 0x29, 0xf0, 0x19, 0xcc, 0x94, 0x7b, 0xb5, 0xc3, 0xbc, 0x25, 0x9b, 0x94, 0x86, 0xe8, 0x60,
+  0xe5, 0x52, 0x05, 0xd3, 0x72, 0x28, 0xde, 0xb2, 0xdd, 0x8f, 0xcd, 0x2b, 0x96, 0xd9, 0xee, 0xd8,
+  0x34, 0x20, 0x96, 0x09, 0x3b, 0xb2, 0x4a, 0x20, 0x19, 0x7e, 0x6f, 0x41, 0x83, 0x7c, 0xa2, 0x9e,
+  0x05, 0x4f, 0x7e, 0x88, 0x1b, 0xb5, 0xba, 0xa2, 0x56, 0xd5, 0x0e, 0x9d, 0x52, 0x76, 0xdf, 0xef,
+  0xc0, 0xc7, 0x9d, 0x6c, 0x36, 0x64, 0x11, 0xb1, 0x4d, 0x83, 0xe0, 0xb3, 0x10, 0xac, 0x56, 0x0a,
+  0xd2, 0x64, 0xf5, 0xe3, 0x9f, 0xff, 0x9d, 0xa0, 0x75, 0x8c, 0xa1, 0x28, 0x2c, 0xba, 0xa3, 0x80,
+  0xe7, 0xf7, 0x7f, 0x25, 0xdf, 0x3a, 0xcf, 0x1d, 0x0c, 0x75, 0x6c, 0x67, 0xb6, 0x0c, 0x4d, 0x1c,
+  0x53, 0xe4, 0xcf, 0x15, 0xf3, 0xbe, 0x61, 0xc4, 0x47, 0xa3, 0x97, 0xc7, 0x3b, 0xdb, 0xe9, 0x95,
+  0x63, 0x3b, 0x38, 0x21, 0x23, 0xb7, 0x53, 0xca, 0x57, 0x7e, 0xf8, 0x5e, 0x9c, 0xfd, 0x96, 0x72,
+  0x48, 0xdb, 0x1d, 0x9b, 0x73, 0x18, 0x01, 0xa0, 0xac, 0x1b, 0x30, 0x0a, 0xa2, 0x61, 0x29, 0x56,
+  0x38, 0xb1, 0x00, 0xab, 0x64, 0x70, 0x3e, 0x66, 0x3b, 0x3a, 0x71, 0xe4, 0xb6, 0xa2, 0x0c, 0x05,
+  0xa2, 0xff, 0xdb, 0x5f, 0xfe, 0xed, 0x7f, 0xc8, 0xc8, 0xbc, 0xa4, 0x52, 0x3a, 0x60, 0x1f, 0x38,
+  0xa4, 0x07, 0xec, 0x41, 0x9e, 0xf4, 0x6f, 0x27, 0xf0, 0xdf, 0xfc, 0x96, 0xa0, 0x83, 0xfc, 0x08,
+  0x69, 0xea, 0xa7, 0x88, 0x39, 0x9e, 0x0b, 0x0a, 0x63, 0xd1, 0x9d, 0xe5, 0xcd, 0xa3, 0x59, 0x19,
+  0xce, 0x4a, 0x67, 0xf5, 0x66, 0xfc, 0xec, 0xd1, 0x7e, 0x95, 0x9c, 0x8f, 0xc6, 0x55, 0xf2, 0xcd,
+  0x68, 0x7c, 0x1f, 0x7e, 0xf3, 0x83, 0xb9, 0x08, 0x5c, 0x0a, 0x36, 0x21, 0x5a, 0x0b, 0x7e, 0x6a,
+  0xdd, 0x2a, 0x39, 0xc1, 0x25, 0xe3, 0x75, 0xab, 0xe4, 0xc5, 0x3f, 0x8c, 0x8b, 0x1c, 0xe3, 0x27,
+  0x89, 0x3a, 0xe6, 0xd5, 0x6d, 0xc4, 0x1d, 0xcf, 0xd9, 0x26, 0x69, 0x55, 0xe4, 0x87, 0x6c, 0x1a,
+  0x3a, 0x41, 0x64, 0x2a, 0x1b, 0x0d, 0xf2, 0xca, 0x64, 0x9c, 0x34, 0xcc, 0xc0, 0x69, 0xc8, 0x04,
+  0x53, 0xdc, 0x4d, 0xa8, 0x92, 0xf7, 0x34, 0xe0, 0x58, 0x8e, 0x08, 0x31, 0x07, 0x9f, 0x5c, 0x91,
+  0xc6, 0x8a, 0x11, 0x8b, 0x42, 0xf0, 0x2e, 0x55, 0xca, 0x05, 0xff, 0x23, 0xcb, 0x4b, 0x47, 0xc4,
+  0x5b, 0xba, 0xee, 0x41, 0xd2, 0x3a, 0x45, 0x5e, 0x9f, 0xd9, 0x36, 0x90, 0x13, 0xf7, 0xc9, 0x85,
+  0x8e, 0xc5, 0x05, 0x0c, 0xd9, 0x8f, 0x07, 0x4f, 0xb8, 0x54, 0xe8, 0xaf, 0x18, 0x78, 0x04, 0xd1,
+  0x56, 0x25, 0x8b, 0x14, 0xb6, 0xeb, 0x5c, 0x52, 0x65, 0x7a, 0xf4, 0x01, 0x28, 0x67, 0x01, 0xf5,
+  0xc8, 0xb7, 0x74, 0x32, 0x82, 0x19, 0x94, 0x0b, 0xc3, 0x8c, 0x83, 0xb0, 0x1a, 0x03, 0x71, 0x60,
+  0xe0, 0xbb, 0x2e, 0xa8, 0x7d, 0x02, 0x06, 0xdf, 0x91, 0x41, 0xe1, 0x06, 0x9a, 0x21, 0xe5, 0xe1,
+  0xd5, 0x31, 0x05, 0xf5, 0x80, 0xae, 0x76, 0x13, 0x8b, 0x7a, 0xa2, 0xcf, 0x5e, 0x7a, 0xb2, 0x98,
+  0xa8, 0x96, 0x01, 0x92, 0xea, 0x89, 0x4d, 0xf9, 0x74, 0x6e, 0x94, 0x15, 0x76, 0x95, 0xd3, 0xd0,
+  0xa8, 0xce, 0xe7, 0xd4, 0x33, 0x60, 0xa9, 0x21, 0x09, 0xeb, 0xef, 0x98, 0xef, 0x19, 0x95, 0x6c,
+  0xa7, 0x65, 0x72, 0x13, 0xfb, 0xaf, 0x1f, 0xa8, 0xbe, 0x43, 0xb2, 0x11, 0xfb, 0x0e, 0x94, 0xf6,
+  0xa9, 0xef, 0x81, 0x64, 0x16, 0xd0, 0xd3, 0xf8, 0x27, 0xe3, 0x1f, 0xad, 0x47, 0x95, 0x9a, 0xf2,
+  0x4d, 0xc4, 0xf7, 0x40, 0xf9, 0x7e, 0xd8, 0xa8, 0xd3, 0x0f, 0x74, 0x2a, 0x96, 0xa8, 0xe3, 0xf6,
+  0xa9, 0x68, 0xc0, 0x34, 0xa9, 0x2c, 0xc8, 0xcf, 0x89, 0x07, 0xf1, 0xf3, 0x31, 0xac, 0x6c, 0x2c,
+  0xbe, 0x6f, 0xfd, 0x00, 0xbc, 0xff, 0xbe, 0xfd, 0x03, 0xa9, 0x91, 0x16, 0x3e, 0x75, 0xc4, 0xfb,
+  0x9e, 0xf8, 0xee, 0x8a, 0xef, 0xde, 0x0f, 0x15, 0xe8, 0xc4, 0xe1, 0x75, 0xcf, 0x5f, 0x01, 0x43,
+  0x06, 0x0a, 0x3b, 0xe5, 0x07, 0x14, 0x05, 0xb6, 0x68, 0xcc, 0x31, 0xb5, 0x47, 0x70, 0x32, 0xf2,
+  0x47, 0x5a, 0xd7, 0x3a, 0x39, 0x0b, 0x89, 0x95, 0xf1, 0x5b, 0x87, 0x43, 0x18, 0xcf, 0x63, 0x39,
+  0x12, 0x60, 0x9a, 0x8c, 0x5e, 0x57, 0xfe, 0xd2, 0xb5, 0x88, 0x1d, 0x52, 0xfa, 0x91, 0x56, 0x09,
+  0xf3, 0x89, 0x03, 0x22, 0x5c, 0x7a, 0x0c, 0xb6, 0x0f, 0xb4, 0xfa, 0x0b, 0x31, 0xd2, 0x45, 0x55,
+  0x66, 0x57, 0xde, 0x54, 0x97, 0xa4, 0xbc, 0xf9, 0x83, 0x6a, 0xa0, 0x48, 0xd2, 0xb1, 0x89, 0xa1,
+  0x31, 0xe5, 0x48, 0x6a, 0x48, 0x05, 0x35, 0x03, 0xa3, 0x4a, 0x21, 0x16, 0xc1, 0xc8, 0xb4, 0xee,
+  0x87, 0x02, 0x11, 0x5a, 0x1d, 0xf3, 0x4e, 0xe1, 0xc8, 0x23, 0x95, 0xc7, 0x15, 0x7d, 0x4e, 0x80,
+  0x73, 0x50, 0xee, 0x23, 0x1e, 0x02, 0x59, 0x86, 0x57, 0xa9, 0x07, 0x42, 0xbb, 0x42, 0x6e, 0xb4,
+  0xab, 0xa4, 0xdc, 0x2c, 0x27, 0x13, 0xa2, 0xd5, 0x2f, 0x1e, 0x5e, 0xf3, 0x3a, 0x84, 0x68, 0xcf,
+  0x01, 0xa5, 0xef, 0xa8, 0x19, 0x1a, 0x95, 0x75, 0xed, 0xe1, 0x75, 0x60, 0x88, 0xc6, 0xd7, 0x90,
+  0x3f, 0xcc, 0xc5, 0x92, 0x2d, 0xb5, 0x59, 0x60, 0x54, 0xa9, 0xac, 0xc9, 0x05, 0x79, 0xa4, 0x07,
+  0x28, 0x17, 0xc9, 0x98, 0x17, 0x90, 0x24, 0x31, 0x1c, 0x34, 0x48, 0xa1, 0xc1, 0x56, 0xe4, 0x34,
+  0xd3, 0x38, 0xa2, 0x80, 0xb9, 0x25, 0x1a, 0x2f, 0x34, 0x21, 0x25, 0x5c, 0xd5, 0xe5, 0xad, 0xf1,
+  0xf5, 0x0b, 0xc1, 0xbb, 0x98, 0x93, 0x3a, 0x2b, 0xe4, 0x0e, 0x90, 0xdc, 0xd5, 0x7b, 0xc4, 0x3d,
+  0x0d, 0xd8, 0x06, 0xfe, 0x74, 0x89, 0x85, 0x3f, 0xc4, 0xe2, 0xc4, 0x15, 0x35, 0xc0, 0xa7, 0x57,
+  0x2f, 0x2d, 0xa3, 0x9c, 0x16, 0xd1, 0xca, 0x19, 0xf6, 0x62, 0x40, 0xf9, 0x0c, 0x4d, 0x6b, 0xb4,
+  0x8b, 0x64, 0x69, 0x58, 0x54, 0xae, 0x7e, 0x4e, 0xca, 0x71, 0xc1, 0xb9, 0x0c, 0x4a, 0x5b, 0x4e,
+  0x8a, 0xc6, 0xe5, 0x4d, 0x10, 0x63, 0xf0, 0x3e, 0xb9, 0x10, 0x4e, 0x4e, 0x9f, 0x3c, 0x7d, 0x75,
+  0x72, 0x2c, 0x00, 0x1c, 0xbf, 0x1c, 0xc9, 0x17, 0x7d, 0x3e, 0xc4, 0xa9, 0x1a, 0x06, 0xf0, 0x1e,
+  0x95, 0x84, 0x76, 0xc5, 0x00, 0x66, 0xa8, 0x08, 0x68, 0x00, 0xb6, 0x22, 0xa0, 0x5c, 0x62, 0xa9,
+  0x3b, 0x9e, 0x47, 0xc3, 0x17, 0xe3, 0xd7, 0xaf, 0x00, 0xcc, 0xc5, 0x1d, 0x55, 0x1a, 0xd3, 0x3a,
+  0x60, 0xa6, 0xd2, 0x98, 0x3b, 0x49, 0xc4, 0xed, 0x1a, 0x64, 0x74, 0x39, 0x81, 0x99, 0x38, 0x3f,
+  0xf5, 0x68, 0xe2, 0xe1, 0x75, 0x22, 0xba, 0x75, 0x69, 0x28, 0xdf, 0x90, 0x09, 0x6b, 0x70, 0xa6,
+  0x30, 0x45, 0x5b, 0x6a, 0x4b, 0x95, 0xf3, 0x73, 0x29, 0x4c, 0x0b, 0x78, 0xf7, 0x40, 0x61, 0xac,
+  0x19, 0x82, 0xc0, 0x48, 0xc8, 0x3f, 0x31, 0x7d, 0x6f, 0x9f, 0xbe, 0x19, 0xa5, 0x95, 0xb7, 0x9d,
+  0x29, 0x7c, 0x78, 0x2d, 0x34, 0xf1, 0x72, 0xb2, 0x64, 0x75, 0xee, 0x3f, 0x77, 0x3e, 0x50, 0xcb,
+  0x68, 0x83, 0x79, 0x79, 0x7b, 0xaf, 0xb8, 0x9e, 0xbd, 0x19, 0x7f, 0x06, 0xae, 0xe0, 0x3c, 0x7e,
+  0x3a, 0x5c, 0x31, 0xd2, 0xbe, 0x3d, 0x8e, 0x98, 0x34, 0xac, 0xef, 0x13, 0xad, 0x97, 0xe7, 0x98,
+  0x02, 0x86, 0x94, 0xb1, 0xdb, 0x23, 0xe7, 0x04, 0xf7, 0x8a, 0x5a, 0x9a, 0x48, 0xdc, 0x16, 0xb1,
+  0x38, 0x21, 0xb8, 0x57, 0xf4, 0x9e, 0x45, 0xf1, 0x2e, 0xa2, 0xb9, 0x3b, 0x8a, 0x22, 0x61, 0x11,
+  0xce, 0x5f, 0x60, 0xab, 0x44, 0x1b, 0xf7, 0x8a, 0xac, 0x5a, 0x4d, 0xbf, 0x2d, 0x37, 0x03, 0x2b,
+  0x9a, 0x7a, 0xcf, 0x3b, 0x24, 0x09, 0xfb, 0x6e, 0x8f, 0x62, 0x5c, 0x40, 0x66, 0x6b, 0x82, 0x07,
+  0xe3, 0x97, 0xf4, 0x5e, 0x3d, 0x40, 0x00, 0x6b, 0xde, 0x12, 0x4b, 0x91, 0xa2, 0x80, 0x73, 0x7e,
+  0x05, 0xbf, 0xc2, 0x33, 0x9f, 0x5c, 0xd2, 0xf0, 0x0a, 0x32, 0x35, 0x56, 0xde, 0x2a, 0xf7, 0x8b,
+  0x6c, 0xd0, 0x3b, 0x86, 0xd0, 0x55, 0x6a, 0x0d, 0x09, 0x96, 0x6c, 0x4e, 0x19, 0xde, 0x71, 0xf7,
+  0x66, 0x14, 0xe2, 0x5d, 0x87, 0xba, 0x16, 0xc4, 0xb8, 0x78, 0x80, 0x0b, 0x09, 0xd8, 0x01, 0xb1,
+  0x31, 0xbb, 0xc5, 0x23, 0x5c, 0xc2, 0x7d, 0x2d, 0xd9, 0x01, 0x30, 0x6a, 0x0e, 0x27, 0xb3, 0x21,
+  0x8c, 0x89, 0x99, 0xc8, 0x93, 0x88, 0x03, 0xd9, 0x9b, 0xbf, 0xf2, 0xf4, 0x10, 0x0e, 0x02, 0x0f,
+  0x0f, 0x52, 0x7e, 0x24, 0x40, 0x89, 0xe0, 0x64, 0x38, 0xb2, 0x62, 0x51, 0x9c, 0x9b, 0xe4, 0x5a,
+  0xc6, 0xc5, 0x8a, 0x0d, 0x1a, 0x0d, 0x20, 0xdc, 0x9f, 0x8a, 0xa2, 0x4f, 0x7d, 0xee, 0x33, 0xbe,
+  0x06, 0xbc, 0x2e, 0x92, 0x78, 0x6c, 0xc5, 0xea, 0xbe, 0xe7, 0x63, 0x8a, 0x76, 0x44, 0x00, 0xa4,
+  0x96, 0xe9, 0x44, 0x29, 0xdd, 0x8a, 0xa5, 0x09, 0x40, 0x4e, 0x12, 0x96, 0x26, 0x2c, 0x10, 0xf5,
+  0xbe, 0xc4, 0xf2, 0x35, 0x30, 0xdc, 0x48, 0xf2, 0x38, 0x25, 0x7b, 0xc8, 0xcf, 0xed, 0x8a, 0x53,
+  0x91, 0xb5, 0x86, 0xe4, 0x02, 0xcc, 0x23, 0xe8, 0x3f, 0xcc, 0xa5, 0x3a, 0x9a, 0x51, 0x98, 0x8a,
+  0xa9, 0x2e, 0x74, 0x7e, 0x33, 0x3a, 0x3b, 0x85, 0x58, 0x3d, 0x64, 0xd4, 0xa0, 0x75, 0xd4, 0x4b,
+  0x05, 0x81, 0xe2, 0x50, 0x97, 0x90, 0xb3, 0xc9, 0x3b, 0xe0, 0x6c, 0x1d, 0x14, 0xc7, 0x99, 0x79,
+  0x86, 0x18, 0x54, 0x95, 0x40, 0x2b, 0x37, 0xe1, 0x29, 0x01, 0x97, 0x13, 0xfd, 0x2f, 0x13, 0xc7,
+  0x8b, 0xa6, 0x16, 0xa5, 0x52, 0x3a, 0x69, 0x60, 0x8a, 0x18, 0xcd, 0x11, 0x40, 0x24, 0x58, 0x93,
+  0xbd, 0x92, 0x92, 0x90, 0x02, 0x39, 0xd2, 0x45, 0xa2, 0x26, 0xde, 0x3a, 0xa5, 0xa9, 0x0c, 0x34,
+  0xd6, 0x43, 0xb6, 0x93, 0x88, 0x29, 0xcd, 0x99, 0xab, 0x58, 0xb1, 0x68, 0x36, 0x33, 0x44, 0x45,
+  0x6b, 0x57, 0xb4, 0xe4, 0x3a, 0x1d, 0x12, 0x55, 0x40, 0xc0, 0x87, 0x1b, 0x8a, 0x6a, 0x56, 0x15,
+  0x35, 0xa9, 0x14, 0xe8, 0xce, 0x6b, 0x93, 0xcf, 0xeb, 0x0b, 0x07, 0xb2, 0xef, 0xb4, 0xf5, 0x67,
+  0x04, 0x52, 0xab, 0x8e, 0x86, 0xc5, 0x3a, 0xbb, 0xf5, 0x9e, 0xd8, 0x78, 0x3e, 0x62, 0x46, 0x1b,
+  0x6e, 0x20, 0x76, 0x0c, 0xee, 0x41, 0x32, 0xc1, 0x3c, 0x8d, 0x61, 0x96, 0xb9, 0x82, 0xbc, 0x5d,
+  0x70, 0xa5, 0x4a, 0x7c, 0xe8, 0x0e, 0x57, 0x0e, 0xc3, 0xc3, 0x94, 0xf7, 0xd9, 0x6c, 0x48, 0xdc,
+  0x10, 0xc8, 0x26, 0x42, 0x6e, 0x01, 0xb5, 0xeb, 0xbc, 0x62, 0x43, 0x2a, 0xd7, 0xfc, 0x7a, 0x43,
+  0xa2, 0x10, 0x9f, 0x5d, 0x72, 0x90, 0x9a, 0xe0, 0x3a, 0x8c, 0x6f, 0x4d, 0xb8, 0x94, 0x23, 0xbc,
+  0xb2, 0x96, 0xd1, 0x23, 0x6d, 0xba, 0x91, 0xae, 0xcb, 0x43, 0x31, 0xa1, 0x4e, 0xcd, 0x8a, 0xb6,
+  0x18, 0x11, 0x0b, 0x69, 0xa9, 0x49, 0xf9, 0x30, 0x88, 0xeb, 0x5b, 0x7a, 0x09, 0xee, 0xd4, 0x27,
+  0x09, 0x48, 0xc4, 0x52, 0x54, 0x98, 0xa9, 0x55, 0xc7, 0xeb, 0x1f, 0xe5, 0x03, 0x0d, 0x68, 0x76,
+  0xc7, 0xc5, 0x77, 0x5f, 0x0a, 0x96, 0xcc, 0xa0, 0xbb, 0x30, 0x03, 0xc3, 0x00, 0x2d, 0x75, 0xc4,
+  0x1e, 0xb9, 0xd0, 0x83, 0x79, 0xd5, 0xe8, 0xab, 0x17, 0xf8, 0x32, 0x41, 0xbf, 0x1c, 0x99, 0x6d,
+  0xcb, 0x24, 0x03, 0xda, 0x3d, 0x38, 0x74, 0x1b, 0x4c, 0x84, 0x32, 0x39, 0x19, 0xc0, 0xb6, 0xc9,
+  0xd1, 0x05, 0xb7, 0xe8, 0x86, 0x18, 0x02, 0x91, 0x8f, 0x6b, 0x09, 0x31, 0x7a, 0xd9, 0x0e, 0x33,
+  0x87, 0xe1, 0x71, 0x45, 0x54, 0x5e, 0xe8, 0xdb, 0x17, 0x07, 0x16, 0x02, 0x43, 0x71, 0x3c, 0xb4,
+  0x26, 0x5f, 0x2f, 0x1c, 0xcb, 0xf2, 0xf9, 0x01, 0xc1, 0x46, 0x3c, 0x12, 0x29, 0x48, 0x5e, 0x72,
+  0xfc, 0x71, 0x61, 0xe1, 0x53, 0x5e, 0xc0, 0x55, 0xea, 0x9e, 0x21, 0x5d, 0x80, 0x83, 0x4b, 0x8e,
+  0x3d, 0x1e, 0x5e, 0x3b, 0x6b, 0x71, 0x13, 0xe1, 0x3f, 0xfe, 0x15, 0xef, 0x0c, 0xfc, 0x52, 0xf4,
+  0x6e, 0x1e, 0x81, 0xe7, 0x2e, 0x79, 0x51, 0xa9, 0xbf, 0xf3, 0xc1, 0x0a, 0x94, 0xcb, 0xc5, 0x55,
+  0xa6, 0x64, 0xcf, 0x69, 0x17, 0x45, 0x22, 0x33, 0x9e, 0xb7, 0xef, 0x44, 0x3a, 0x87, 0x99, 0x69,
+  0xb9, 0xaa, 0xe8, 0xf5, 0x82, 0xf2, 0xb9, 0x6f, 0x81, 0xd7, 0x3f, 0x3f, 0x1b, 0x8d, 0xcb, 0xd5,
+  0xa4, 0x1d, 0xef, 0x4d, 0xd1, 0x90, 0x0d, 0xc8, 0x75, 0xf9, 0x99, 0xbc, 0x66, 0x59, 0x1b, 0x5f,
+  0x05, 0xb4, 0x0c, 0x23, 0xcd, 0x20, 0x00, 0x8a, 0x85, 0xeb, 0x6c, 0xe0, 0x5e, 0x2d, 0xaf, 0xd3,
+  0x69, 0x58, 0x74, 0x1d, 0x48, 0x6f, 0xc3, 0x44, 0x8d, 0xc8, 0xb1, 0xaf, 0x8c, 0x6b, 0x81, 0xd5,
+  0x40, 0x16, 0x4b, 0xd6, 0xf1, 0xc6, 0x5e, 0x57, 0xf2, 0x76, 0x7d, 0xd4, 0x06, 0xdb, 0x46, 0xdb,
+  0xeb, 0xb8, 0x53, 0xa1, 0xb1, 0x4e, 0xc3, 0xd0, 0x07, 0xc3, 0x6d, 0xba, 0x34, 0xe4, 0x06, 0x60,
+  0x86, 0xd5, 0x34, 0xcf, 0xe7, 0x84, 0xc9, 0xfb, 0x5a, 0x78, 0xa7, 0xb7, 0x4c, 0x1e, 0x91, 0x74,
+  0xa8, 0x6a, 0x68, 0x23, 0xd3, 0x96, 0x58, 0xd1, 0x62, 0x86, 0xa6, 0x37, 0x4a, 0xb6, 0x30, 0x14,
+  0x92, 0x60, 0x79, 0x9a, 0xf7, 0xff, 0x0c, 0xbd, 0x59, 0x43, 0x8f, 0x8d, 0x4b, 0x19, 0xa9, 0x17,
+  0x28, 0xa7, 0xf5, 0xd3, 0x33, 0x31, 0x42, 0x68, 0x40, 0xa2, 0x87, 0x0d, 0x46, 0x66, 0x03, 0x8f,
+  0x88, 0x49, 0x90, 0xb0, 0x44, 0x33, 0x90, 0x32, 0x8c, 0x60, 0x91, 0x43, 0x71, 0xd3, 0x23, 0x52,
+  0x7e, 0x5b, 0xfe, 0x14, 0x2e, 0x69, 0x67, 0xa6, 0x99, 0x28, 0x56, 0xd4, 0x8e, 0x6f, 0x72, 0x71,
+  0x18, 0x73, 0x94, 0x2b, 0x75, 0x11, 0xd8, 0xeb, 0x35, 0xb9, 0xc8, 0xec, 0xde, 0x04, 0x40, 0xde,
+  0x78, 0xc8, 0x07, 0x81, 0x56, 0xf3, 0x46, 0x00, 0x78, 0xfc, 0x1c, 0x4f, 0xaf, 0x03, 0xa3, 0x17,
+  0x40, 0xc8, 0xaf, 0x7e, 0x45, 0xca, 0xe2, 0x40, 0x3a, 0x53, 0x27, 0x74, 0x18, 0xf0, 0xf1, 0x28,
+  0x42, 0x0d, 0xff, 0xbe, 0x2a, 0xe4, 0x0c, 0xcb, 0xe6, 0x46, 0x39, 0xd8, 0x28, 0x8c, 0x4a, 0x3b,
+  0x0e, 0xa3, 0xc5, 0x24, 0xac, 0x44, 0x5a, 0x98, 0xa9, 0xdc, 0xc0, 0x0e, 0x31, 0x29, 0x4b, 0x8d,
+  0x08, 0x67, 0xc4, 0xb1, 0x42, 0x8e, 0x60, 0x21, 0x56, 0x87, 0xa0, 0x48, 0x5c, 0x15, 0x87, 0x60,
+  0x8a, 0x0b, 0x7e, 0x6a, 0x91, 0x9a, 0xe2, 0xa9, 0xd7, 0x7a, 0xd9, 0x12, 0x82, 0xb0, 0xb7, 0xa6,
+  0xeb, 0x60, 0xfa, 0x45, 0xf4, 0x4b, 0x3c, 0xc4, 0x48, 0x6e, 0xa9, 0x54, 0x36, 0x84, 0x7a, 0xba,
+  0xc4, 0x83, 0x11, 0x11, 0x98, 0x43, 0xf4, 0x69, 0x68, 0xe7, 0x1d, 0x88, 0x2a, 0x36, 0xc4, 0x31,
+  0xc9, 0x17, 0x10, 0x93, 0xec, 0x21, 0x3f, 0x1d, 0x76, 0x6a, 0x9e, 0x1a, 0xd1, 0xf4, 0xca, 0x4d,
+  0x84, 0x64, 0x6f, 0xcd, 0xe4, 0x5c, 0x07, 0xda, 0x99, 0x4a, 0x89, 0x38, 0x12, 0xc7, 0xe2, 0x68,
+  0xd5, 0x76, 0x7d, 0x3f, 0x8c, 0x91, 0x21, 0x0d, 0x8c, 0x97, 0x33, 0xd2, 0x83, 0x78, 0x16, 0x47,
+  0xc7, 0x43, 0xbe, 0xc2, 0x21, 0x99, 0xa2, 0x2f, 0x92, 0x2a, 0xa1, 0x0e, 0x01, 0x23, 0xa4, 0x51,
+  0x4c, 0x1a, 0x12, 0xe0, 0xd9, 0x26, 0x79, 0x2f, 0xbd, 0x4b, 0x64, 0xb5, 0x80, 0xf8, 0x05, 0x11,
+  0x47, 0x01, 0x64, 0xb1, 0x84, 0x95, 0x26, 0x94, 0x08, 0x4e, 0x8b, 0x3f, 0x71, 0xc4, 0xc3, 0x00,
+  0xb5, 0xb9, 0xdb, 0xdf, 0x99, 0xcc, 0xbc, 0x70, 0xf5, 0xa7, 0xb7, 0x4f, 0x48, 0xde, 0x40, 0x10,
+  0x59, 0x8d, 0xb6, 0xc9, 0x20, 0xd5, 0x94, 0x68, 0x27, 0xc4, 0xdb, 0x67, 0x39, 0x91, 0x13, 0x8d,
+  0x36, 0x9e, 0x69, 0xc9, 0xd6, 0x4a, 0x75, 0x23, 0x82, 0xd2, 0x3f, 0x72, 0x5b, 0x0d, 0xa2, 0xdf,
+  0xaa, 0xd8, 0xe3, 0x03, 0xf1, 0x7d, 0x27, 0x3e, 0x45, 0x0d, 0x9e, 0x37, 0xfc, 0x0b, 0x58, 0xbb,
+  0x24, 0x44, 0x2e, 0x76, 0x31, 0x9b, 0xe1, 0x71, 0x1a, 0x1c, 0xef, 0x6e, 0x0c, 0x31, 0x52, 0x2f,
+  0x7f, 0x82, 0x45, 0xce, 0x44, 0x74, 0x0e, 0x64, 0xb9, 0x1f, 0xb6, 0xe7, 0x34, 0x0d, 0x24, 0x44,
+  0x8c, 0x03, 0x6d, 0x49, 0x94, 0xe4, 0xf8, 0xe4, 0xd5, 0xc9, 0xf8, 0xa4, 0xbc, 0xde, 0xc8, 0x77,
+  0x24, 0x22, 0xc5, 0x5e, 0x53, 0x5e, 0x99, 0xc8, 0xf8, 0x02, 0x48, 0xc5, 0xb7, 0x9e, 0x2f, 0xc5,
+  0x57, 0x4c, 0xf2, 0xed, 0x78, 0x10, 0x1d, 0xee, 0x6c, 0x9b, 0x8d, 0x57, 0x41, 0x72, 0xed, 0x26,
+  0x2e, 0x7d, 0x93, 0xb9, 0x91, 0x4b, 0xdf, 0xb4, 0xd1, 0x54, 0xe6, 0xe1, 0x92, 0x7f, 0x87, 0x10,
+  0x0a, 0x68, 0x19, 0x08, 0x66, 0x56, 0x93, 0x0b, 0x2e, 0x03, 0xf1, 0xb4, 0x6b, 0x1c, 0x20, 0x2e,
+  0xa8, 0xb0, 0xe8, 0x82, 0x0a, 0x61, 0xe6, 0x25, 0x24, 0x78, 0xf1, 0xed, 0x80, 0x95, 0xe3, 0xba,
+  0xa8, 0xd1, 0xe8, 0xd6, 0xea, 0xe5, 0x5d, 0x22, 0xa4, 0xf4, 0xce, 0x44, 0xd6, 0xf7, 0x7f, 0xdc,
+  0x26, 0xaf, 0xb8, 0x9e, 0x9c, 0xef, 0xe7, 0x3e, 0xee, 0xe2, 0x1c, 0xe4, 0xf4, 0xdb, 0x48, 0x2c,
+  0x99, 0xf5, 0x77, 0xb1, 0x89, 0xb8, 0x32, 0x18, 0xad, 0x8f, 0xbb, 0xca, 0x29, 0xb9, 0xb9, 0x23,
+  0x44, 0xa4, 0x52, 0x9a, 0x57, 0xbe, 0xc9, 0x88, 0x48, 0x2d, 0x0b, 0xe9, 0xf0, 0xa5, 0x74, 0xe4,
+  0x35, 0x90, 0x2d, 0x02, 0x12, 0x03, 0xca, 0x9a, 0x53, 0x97, 0x73, 0xbe, 0xfe, 0x9a, 0x44, 0xc9,
+  0x85, 0x78, 0xaf, 0xe3, 0xa5, 0xa1, 0x88, 0x41, 0x08, 0x4f, 0x29, 0xbf, 0x47, 0x08, 0xc9, 0x5a,
+  0x54, 0xf4, 0x76, 0xdb, 0xd2, 0xd5, 0x26, 0xa9, 0x5a, 0xd5, 0xf4, 0x40, 0xfe, 0xd5, 0x4c, 0x74,
+  0xa5, 0x06, 0xd2, 0x54, 0xf1, 0xf7, 0x32, 0x87, 0x0d, 0xf9, 0xbf, 0x2e, 0xf9, 0x3f, 0x9a, 0x9e,
+  0x47, 0x7b, 0xd2, 0x44, 0x00, 0x00,
+};
+
+#endif
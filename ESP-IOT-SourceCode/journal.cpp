@@ -0,0 +1,269 @@
+#include "journal.h"
+#include "storage.h"
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include <freertos/FreeRTOS.h>
+
+// The journal partition is used as a circular log of fixed 16-byte records.
+// Records are only ever appended into erased flash. The sector after the
+// write head is always kept erased as a spare: when the head reaches it, the
+// live value of every key is copied in first, and only then is the sector
+// after it (the oldest data in the log) erased to become the next spare. A
+// power cut at any point leaves every live value on flash at least once.
+// Erases therefore rotate evenly over all sectors of the partition.
+#define JOURNAL_RECORD_MARKER 0x4A
+
+struct JournalRecord {
+  uint8_t marker;
+  uint8_t key;
+  uint16_t crc;         // CRC16 over key, sequence and value
+  uint32_t sequence;    // Global append counter; highest wins on replay
+  int64_t value;
+};
+static_assert(sizeof(JournalRecord) == 16, "journal record must be 16 bytes");
+
+static const esp_partition_t *partition = nullptr;
+static uint32_t writeOffset = 0;     // Byte offset of the next free slot
+static uint32_t nextSequence = 1;
+
+// Latest value per key. journalPut() runs on the control task and the
+// appends on the storage task, so these are only touched under the lock;
+// each pass copies them to the flush set and writes from that.
+static portMUX_TYPE journalMux = portMUX_INITIALIZER_UNLOCKED;
+static int64_t values[JOURNAL_KEY_COUNT];
+static bool present[JOURNAL_KEY_COUNT];
+static bool dirty[JOURNAL_KEY_COUNT];
+
+static int64_t flushValues[JOURNAL_KEY_COUNT];
+static bool flushPresent[JOURNAL_KEY_COUNT];
+static JournalStats stats = {0, 0, 0, 0, 0};
+
+static uint8_t scratch[256];         // Flash read buffer, 16 records
+
+static uint16_t recordCrc(const JournalRecord &rec) {
+  uint16_t crc = esp_rom_crc16_le(0, &rec.key, 1);
+  return esp_rom_crc16_le(crc, (const uint8_t *)&rec.sequence,
+                          sizeof(rec.sequence) + sizeof(rec.value));
+}
+
+static bool isErased(const uint8_t *p, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+static bool slotErased(uint32_t offset) {
+  JournalRecord rec;
+  if (esp_partition_read(partition, offset, &rec, sizeof(rec)) != ESP_OK) return false;
+  return isErased((const uint8_t *)&rec, sizeof(rec));
+}
+
+static bool sectorErased(uint32_t base) {
+  for (uint32_t off = 0; off < JOURNAL_SECTOR_SIZE; off += sizeof(scratch)) {
+    if (esp_partition_read(partition, base + off, scratch, sizeof(scratch)) != ESP_OK) return false;
+    if (!isErased(scratch, sizeof(scratch))) return false;
+  }
+  return true;
+}
+
+static bool writeRecord(uint8_t key, int64_t value) {
+  JournalRecord rec;
+  rec.marker = JOURNAL_RECORD_MARKER;
+  rec.key = key;
+  rec.sequence = nextSequence++;
+  rec.value = value;
+  rec.crc = recordCrc(rec);
+
+  if (esp_partition_write(partition, writeOffset, &rec, sizeof(rec)) != ESP_OK) {
+    Serial.println(F("ERR: Journal write failed."));
+    return false;
+  }
+  writeOffset += sizeof(rec);
+  stats.appends++;
+  return true;
+}
+
+static uint32_t sectorAfter(uint32_t base) {
+  base += JOURNAL_SECTOR_SIZE;
+  return base >= partition->size ? 0 : base;
+}
+
+static bool eraseSector(uint32_t base) {
+  if (sectorErased(base)) return true;
+  if (esp_partition_erase_range(partition, base, JOURNAL_SECTOR_SIZE) != ESP_OK) {
+    Serial.println(F("ERR: Journal erase failed."));
+    return false;
+  }
+  stats.erases++;
+  return true;
+}
+
+// Called whenever the write head reaches a sector boundary. The sector is
+// the spare and already blank; the live keys are copied into it before the
+// next sector is erased.
+static bool openSector(uint32_t base) {
+  writeOffset = base;
+  stats.sector = base / JOURNAL_SECTOR_SIZE;
+  if (!sectorErased(base)) {
+    // Only when the spare could not be restored at boot: nothing blank to
+    // copy into, so erase first as a last resort
+    Serial.println(F("WARN: Journal spare sector not blank."));
+    if (!eraseSector(base)) return false;
+  }
+
+  for (uint8_t k = 0; k < JOURNAL_KEY_COUNT; k++) {
+    if (flushPresent[k]) writeRecord(k, flushValues[k]);
+  }
+  eraseSector(sectorAfter(base));
+  return true;
+}
+
+// Boot found the spare in use: power was cut while the head moved into the
+// current sector, or older firmware (which erased in place) wrote the log.
+// Keys whose newest record is only in the spare are copied to the head
+// first, then it is erased.
+static void restoreSpare(uint32_t spare, const uint32_t *newestAt) {
+  if (sectorErased(spare)) return;
+
+  uint8_t keep[JOURNAL_KEY_COUNT];
+  uint8_t n = 0;
+  for (uint8_t k = 0; k < JOURNAL_KEY_COUNT; k++) {
+    if (present[k] && newestAt[k] - spare < JOURNAL_SECTOR_SIZE) keep[n++] = k;
+  }
+  uint32_t room = (JOURNAL_SECTOR_SIZE - writeOffset % JOURNAL_SECTOR_SIZE) % JOURNAL_SECTOR_SIZE;
+  if (n * sizeof(JournalRecord) > room) {
+    Serial.println(F("WARN: No room to restore the journal spare sector."));
+    return;
+  }
+  for (uint8_t i = 0; i < n; i++) {
+    if (!writeRecord(keep[i], values[keep[i]])) return;
+  }
+  eraseSector(spare);
+}
+
+// Append key's flush value. Opening a sector writes every key, which
+// clears all of changed.
+static bool appendRecord(uint8_t key, bool *changed) {
+  if (writeOffset >= partition->size) writeOffset = 0;
+  if (writeOffset % JOURNAL_SECTOR_SIZE == 0) {
+    if (!openSector(writeOffset)) return false;
+    memset(changed, 0, JOURNAL_KEY_COUNT);
+    return true;
+  }
+  changed[key] = false;
+  return writeRecord(key, flushValues[key]);
+}
+
+bool beginJournal() {
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                       (esp_partition_subtype_t)JOURNAL_PARTITION_SUBTYPE,
+                                       JOURNAL_PARTITION_LABEL);
+  if (partition == nullptr) {
+    Serial.println(F("WARN: No journal partition; output states and clock won't persist."));
+    return false;
+  }
+  stats.sectorCount = partition->size / JOURNAL_SECTOR_SIZE;
+  if (stats.sectorCount < 2) {
+    Serial.println(F("WARN: Journal partition needs at least 2 sectors."));
+    partition = nullptr;
+    return false;
+  }
+
+  // Replay: keep the newest valid record per key and find the write head
+  uint32_t bestSeq[JOURNAL_KEY_COUNT] = {0};
+  uint32_t bestOffset[JOURNAL_KEY_COUNT] = {0};
+  bool found = false;
+  uint32_t maxSeq = 0;
+  uint32_t maxOffset = 0;
+
+  for (uint32_t base = 0; base < partition->size; base += sizeof(scratch)) {
+    if (esp_partition_read(partition, base, scratch, sizeof(scratch)) != ESP_OK) continue;
+    for (uint32_t off = 0; off < sizeof(scratch); off += sizeof(JournalRecord)) {
+      JournalRecord rec;
+      memcpy(&rec, scratch + off, sizeof(rec));
+      if (rec.marker != JOURNAL_RECORD_MARKER || rec.key >= JOURNAL_KEY_COUNT) continue;
+      if (recordCrc(rec) != rec.crc) continue;
+
+      stats.replayed++;
+      if (!present[rec.key] || (int32_t)(rec.sequence - bestSeq[rec.key]) > 0) {
+        bestSeq[rec.key] = rec.sequence;
+        bestOffset[rec.key] = base + off;
+        values[rec.key] = rec.value;
+        present[rec.key] = true;
+      }
+      if (!found || (int32_t)(rec.sequence - maxSeq) > 0) {
+        found = true;
+        maxSeq = rec.sequence;
+        maxOffset = base + off;
+      }
+    }
+  }
+
+  if (found) {
+    nextSequence = maxSeq + 1;
+    writeOffset = maxOffset + sizeof(JournalRecord);
+    // Skip slots damaged by an interrupted write
+    while (writeOffset % JOURNAL_SECTOR_SIZE != 0 && !slotErased(writeOffset)) {
+      writeOffset += sizeof(JournalRecord);
+    }
+  } else {
+    writeOffset = 0;
+  }
+  if (writeOffset >= partition->size) writeOffset = 0;
+
+  // The head is at a sector boundary only when that sector is the spare
+  uint32_t head = writeOffset - writeOffset % JOURNAL_SECTOR_SIZE;
+  restoreSpare(writeOffset == head ? head : sectorAfter(head), bestOffset);
+  stats.sector = writeOffset / JOURNAL_SECTOR_SIZE;
+
+  Serial.print(F("Journal replayed: "));
+  Serial.print(stats.replayed);
+  Serial.print(F(" records, "));
+  Serial.print(stats.sectorCount);
+  Serial.println(F(" sectors."));
+  return true;
+}
+
+bool journalGet(JournalKey key, int64_t &value) {
+  portENTER_CRITICAL(&journalMux);
+  bool found = present[key];
+  if (found) value = values[key];
+  portEXIT_CRITICAL(&journalMux);
+  return found;
+}
+
+void journalPut(JournalKey key, int64_t value) {
+  portENTER_CRITICAL(&journalMux);
+  bool changed = !present[key] || values[key] != value;
+  values[key] = value;
+  present[key] = true;
+  dirty[key] |= changed;
+  portEXIT_CRITICAL(&journalMux);
+  if (changed) wakeStorageTask();
+}
+
+void journalLoop() {
+  if (partition == nullptr) return;
+  bool changed[JOURNAL_KEY_COUNT];
+  portENTER_CRITICAL(&journalMux);
+  for (uint8_t k = 0; k < JOURNAL_KEY_COUNT; k++) {
+    changed[k] = dirty[k];
+    dirty[k] = false;
+    flushValues[k] = values[k];
+    flushPresent[k] = present[k];
+  }
+  portEXIT_CRITICAL(&journalMux);
+
+  for (uint8_t k = 0; k < JOURNAL_KEY_COUNT; k++) {
+    if (!changed[k] || appendRecord(k, changed)) continue;
+    // Retried on the next pass
+    portENTER_CRITICAL(&journalMux);
+    dirty[k] = true;
+    portEXIT_CRITICAL(&journalMux);
+  }
+}
+
+const JournalStats& getJournalStats() {
+  return stats;
+}
@@ -0,0 +1,38 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "config.h"
+
+// Keys for the high-churn runtime state kept in the journal partition
+enum JournalKey : uint8_t {
+  JOURNAL_POWER_JACK = 0,
+  JOURNAL_USB_OUTPUT,
+  JOURNAL_LAST_TIME,
+  JOURNAL_KEY_COUNT
+};
+
+struct JournalStats {
+  uint32_t appends;       // Records written
+  uint32_t erases;        // Sector erases
+  uint32_t replayed;      // Valid records found at boot
+  uint16_t sector;        // Sector currently being appended to
+  uint16_t sectorCount;
+};
+
+// Locate the journal partition and replay it. Returns false if the
+// partition is missing (see partitions.csv).
+bool beginJournal();
+
+// Latest value for key; false if the journal holds none
+bool journalGet(JournalKey key, int64_t &value);
+
+// Record a new value from any task. Only RAM is touched; the storage task
+// appends it.
+void journalPut(JournalKey key, int64_t value);
+
+// Append values changed since the last pass. Storage task only.
+void journalLoop();
+
+const JournalStats& getJournalStats();
+
+#endif
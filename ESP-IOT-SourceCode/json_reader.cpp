@@ -0,0 +1,289 @@
+#include "json_reader.h"
+
+bool JsonReader::fail(const char *why) {
+  if (!err) err = why;
+  return false;
+}
+
+void JsonReader::skipSpace() {
+  while (pos < len && (js[pos] == ' ' || js[pos] == '\t' || js[pos] == '\n' || js[pos] == '\r')) pos++;
+}
+
+bool JsonReader::add(JsonTokenType type, size_t start) {
+  if (count >= JSON_MAX_TOKENS) return fail("too many fields");
+  JsonToken &t = tokens[count];
+  t.type = type;
+  t.start = start;
+  t.end = start;
+  t.next = count + 1;
+  count++;
+  return true;
+}
+
+static bool isHex(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool JsonReader::string() {
+  size_t start = ++pos;   // Past the opening quote
+  while (pos < len) {
+    uint8_t c = js[pos];
+    if (c == '"') {
+      if (!add(JSON_STRING, start)) return false;
+      tokens[count - 1].end = pos++;
+      return true;
+    }
+    if (c < 0x20) return fail("control character in string");
+    if (c == '\\') {
+      if (++pos >= len) break;
+      char e = js[pos];
+      if (e == 'u') {
+        for (uint8_t i = 1; i <= 4; i++) {
+          if (pos + i >= len || !isHex(js[pos + i])) return fail("bad \\u escape");
+        }
+        pos += 4;
+      } else if (!strchr("\"\\/bfnrt", e) || e == '\0') {
+        return fail("bad escape");
+      }
+    }
+    pos++;
+  }
+  return fail("unterminated string");
+}
+
+bool JsonReader::number() {
+  size_t start = pos;
+  if (pos < len && js[pos] == '-') pos++;
+  if (pos < len && js[pos] == '0') {
+    pos++;
+  } else if (pos < len && js[pos] >= '1' && js[pos] <= '9') {
+    while (pos < len && isDigit(js[pos])) pos++;
+  } else {
+    return fail("bad number");
+  }
+  if (pos < len && js[pos] == '.') {
+    pos++;
+    if (pos >= len || !isDigit(js[pos])) return fail("bad number");
+    while (pos < len && isDigit(js[pos])) pos++;
+  }
+  if (pos < len && (js[pos] == 'e' || js[pos] == 'E')) {
+    pos++;
+    if (pos < len && (js[pos] == '+' || js[pos] == '-')) pos++;
+    if (pos >= len || !isDigit(js[pos])) return fail("bad number");
+    while (pos < len && isDigit(js[pos])) pos++;
+  }
+  if (!add(JSON_NUMBER, start)) return false;
+  tokens[count - 1].end = pos;
+  return true;
+}
+
+bool JsonReader::literal(const char *word) {
+  size_t n = strlen(word);
+  if (pos + n > len || memcmp(js + pos, word, n) != 0) return fail("unexpected character");
+  if (!add(JSON_LITERAL, pos)) return false;
+  pos += n;
+  tokens[count - 1].end = pos;
+  return true;
+}
+
+bool JsonReader::value(uint8_t depth) {
+  skipSpace();
+  if (pos >= len) return fail("unexpected end");
+  char c = js[pos];
+  if (c == '{' || c == '[') {
+    if (depth >= JSON_MAX_NESTING) return fail("nested too deep");
+    bool object = c == '{';
+    uint8_t index = count;
+    if (!add(object ? JSON_OBJECT : JSON_ARRAY, pos)) return false;
+    char close = object ? '}' : ']';
+    pos++;
+    skipSpace();
+    if (pos < len && js[pos] == close) {
+      pos++;
+    } else {
+      for (;;) {
+        if (object) {
+          skipSpace();
+          if (pos >= len || js[pos] != '"') return fail("expected a key");
+          if (!string()) return false;
+          skipSpace();
+          if (pos >= len || js[pos] != ':') return fail("expected :");
+          pos++;
+        }
+        if (!value(depth + 1)) return false;
+        skipSpace();
+        if (pos < len && js[pos] == ',') {
+          pos++;
+        } else if (pos < len && js[pos] == close) {
+          pos++;
+          break;
+        } else {
+          return fail(object ? "expected , or }" : "expected , or ]");
+        }
+      }
+    }
+    tokens[index].end = pos;
+    tokens[index].next = count;
+    return true;
+  }
+  if (c == '"') return string();
+  if (c == '-' || isDigit(c)) return number();
+  if (c == 't') return literal("true");
+  if (c == 'f') return literal("false");
+  if (c == 'n') return literal("null");
+  return fail("unexpected character");
+}
+
+bool JsonReader::parse(const char *json, size_t length) {
+  js = json;
+  len = length;
+  pos = 0;
+  count = 0;
+  err = nullptr;
+  if (len > UINT16_MAX) return fail("body too large");
+  skipSpace();
+  if (pos >= len || js[pos] != '{') return fail("body must be a JSON object");
+  if (!value(0)) return false;
+  skipSpace();
+  if (pos != len) return fail("trailing characters");
+
+  // A repeated key would let two parts of a client disagree on the value
+  for (uint8_t i = 1; i < tokens[0].next; i = tokens[i + 1].next) {
+    const JsonToken &a = tokens[i];
+    for (uint8_t j = tokens[i + 1].next; j < tokens[0].next; j = tokens[j + 1].next) {
+      const JsonToken &b = tokens[j];
+      if (a.end - a.start == b.end - b.start && memcmp(js + a.start, js + b.start, a.end - a.start) == 0) {
+        count = 0;
+        return fail("duplicate key");
+      }
+    }
+  }
+  return true;
+}
+
+// Value token of a top-level member, or -1. Keys are compared as written,
+// so an escaped key never matches.
+int JsonReader::find(const char *key) const {
+  if (count == 0) return -1;
+  size_t n = strlen(key);
+  for (uint8_t i = 1; i < tokens[0].next; i = tokens[i + 1].next) {
+    const JsonToken &k = tokens[i];
+    if ((size_t)(k.end - k.start) == n && memcmp(js + k.start, key, n) == 0) return i + 1;
+  }
+  return -1;
+}
+
+bool JsonReader::has(const char *key) const {
+  return find(key) >= 0;
+}
+
+bool JsonReader::isString(const char *key) const {
+  int i = find(key);
+  return i >= 0 && tokens[i].type == JSON_STRING;
+}
+
+bool JsonReader::getBool(const char *key, bool &out) const {
+  int i = find(key);
+  if (i < 0 || tokens[i].type != JSON_LITERAL || js[tokens[i].start] == 'n') return false;
+  out = js[tokens[i].start] == 't';
+  return true;
+}
+
+bool JsonReader::getInt(const char *key, int32_t &out, int32_t min, int32_t max) const {
+  int i = find(key);
+  if (i < 0 || tokens[i].type != JSON_NUMBER) return false;
+  const JsonToken &t = tokens[i];
+  size_t p = t.start;
+  bool negative = js[p] == '-';
+  if (negative) p++;
+  if (t.end - p > 10) return false;
+  int64_t v = 0;
+  for (; p < t.end; p++) {
+    if (!isDigit(js[p])) return false;   // Fraction or exponent
+    v = v * 10 + (js[p] - '0');
+  }
+  if (negative) v = -v;
+  if (v < min || v > max) return false;
+  out = (int32_t)v;
+  return true;
+}
+
+bool JsonReader::getNumberText(const char *key, char *out, size_t size) const {
+  int i = find(key);
+  if (i < 0 || tokens[i].type != JSON_NUMBER) return false;
+  size_t n = tokens[i].end - tokens[i].start;
+  if (n >= size) return false;
+  memcpy(out, js + tokens[i].start, n);
+  out[n] = '\0';
+  return true;
+}
+
+static int hexValue(const char *p) {
+  int v = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    char c = p[i];
+    v = v * 16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+  }
+  return v;
+}
+
+bool JsonReader::getString(const char *key, char *out, size_t size) const {
+  int i = find(key);
+  if (i < 0 || tokens[i].type != JSON_STRING || size == 0) return false;
+  const JsonToken &t = tokens[i];
+  size_t n = 0;
+  for (size_t p = t.start; p < t.end; p++) {
+    char buf[4];
+    uint8_t bytes = 1;
+    buf[0] = js[p];
+    if (js[p] == '\\') {
+      char e = js[++p];
+      if (e == 'u') {
+        uint32_t cp = hexValue(js + p + 1);
+        p += 4;
+        if (cp >= 0xD800 && cp < 0xDC00) {
+          // High surrogate: must be followed by a low one
+          if (p + 6 >= t.end || js[p + 1] != '\\' || js[p + 2] != 'u') return false;
+          uint32_t low = hexValue(js + p + 3);
+          if (low < 0xDC00 || low >= 0xE000) return false;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          p += 6;
+        } else if (cp >= 0xDC00 && cp < 0xE000) {
+          return false;
+        }
+        if (cp == 0) return false;   // Would end the C string early
+        if (cp < 0x80) {
+          buf[0] = cp;
+        } else if (cp < 0x800) {
+          buf[0] = 0xC0 | (cp >> 6);
+          buf[1] = 0x80 | (cp & 0x3F);
+          bytes = 2;
+        } else if (cp < 0x10000) {
+          buf[0] = 0xE0 | (cp >> 12);
+          buf[1] = 0x80 | ((cp >> 6) & 0x3F);
+          buf[2] = 0x80 | (cp & 0x3F);
+          bytes = 3;
+        } else {
+          buf[0] = 0xF0 | (cp >> 18);
+          buf[1] = 0x80 | ((cp >> 12) & 0x3F);
+          buf[2] = 0x80 | ((cp >> 6) & 0x3F);
+          buf[3] = 0x80 | (cp & 0x3F);
+          bytes = 4;
+        }
+      } else {
+        const char *from = "\"\\/bfnrt";
+        const char *to = "\"\\/\b\f\n\r\t";
+        buf[0] = to[strchr(from, e) - from];
+      }
+    }
+    if (n + bytes >= size) return false;
+    memcpy(out + n, buf, bytes);
+    n += bytes;
+  }
+  out[n] = '\0';
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include "config.h"
+
+#define JSON_MAX_TOKENS 32
+#define JSON_MAX_NESTING 8
+
+enum JsonTokenType : uint8_t {
+  JSON_OBJECT,
+  JSON_ARRAY,
+  JSON_STRING,     // start/end exclude the quotes; escapes left in place
+  JSON_NUMBER,
+  JSON_LITERAL     // true, false, null
+};
+
+struct JsonToken {
+  JsonTokenType type;
+  uint16_t start;
+  uint16_t end;
+  uint8_t next;    // Index of the token after this one's children
+};
+
+// Strict tokenizer for request bodies in the style of jsmn: one pass over
+// the text into a fixed token pool, no heap and no copies. The body must
+// be a single object; malformed JSON, duplicate top-level keys, trailing
+// bytes or more than JSON_MAX_TOKENS tokens are rejected outright rather
+// than half-read. The getters only see top-level members and return false
+// when a member is missing or has the wrong type or range, so a handler
+// can answer 400 instead of guessing.
+class JsonReader {
+ public:
+  bool parse(const char *json, size_t len);
+  const char *error() const { return err; }   // Why parse() failed
+
+  bool has(const char *key) const;
+  bool isString(const char *key) const;
+  bool getBool(const char *key, bool &out) const;
+  // Integers only: 9.0, 1e1 and "9" are not numbers here
+  bool getInt(const char *key, int32_t &out, int32_t min, int32_t max) const;
+  // Unescaped into out; false if it does not fit in size - 1 bytes
+  bool getString(const char *key, char *out, size_t size) const;
+  // A number as written, e.g. "1.5", for parsers of their own
+  bool getNumberText(const char *key, char *out, size_t size) const;
+
+ private:
+  int find(const char *key) const;
+  bool value(uint8_t depth);
+  bool string();
+  bool number();
+  bool literal(const char *word);
+  bool add(JsonTokenType type, size_t start);
+  void skipSpace();
+  bool fail(const char *why);
+
+  const char *js;
+  size_t len;
+  size_t pos;
+  JsonToken tokens[JSON_MAX_TOKENS];
+  uint8_t count;
+  const char *err;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "json_writer.h"
+
+JsonWriter::JsonWriter(char *buf, size_t size, Sink sink, void *ctx)
+    : buf(buf), size(size), len(0), flushedBytes(0), sink(sink), ctx(ctx), depth(0), overflow(false) {
+  first[0] = true;
+}
+
+void JsonWriter::flush() {
+  if (len == 0 || !sink) return;
+  sink(ctx, buf, len);
+  flushedBytes += len;
+  len = 0;
+}
+
+void JsonWriter::put(char c) {
+  if (len == size) {
+    if (!sink) {
+      overflow = true;
+      return;
+    }
+    flush();
+  }
+  buf[len++] = c;
+}
+
+void JsonWriter::put(const char *s) {
+  while (*s) put(*s++);
+}
+
+void JsonWriter::putUint(uint64_t v) {
+  char digits[20];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  while (n > 0) put(digits[--n]);
+}
+
+void JsonWriter::putString(const char *s) {
+  put('"');
+  for (; *s; s++) {
+    uint8_t c = *s;
+    if (c == '"' || c == '\\') {
+      put('\\');
+      put((char)c);
+    } else if (c < 0x20) {
+      static const char hex[] = "0123456789abcdef";
+      put("\\u00");
+      put(hex[c >> 4]);
+      put(hex[c & 0xF]);
+    } else {
+      put((char)c);
+    }
+  }
+  put('"');
+}
+
+// Comma and key before a value; in arrays and at the top level only the comma
+void JsonWriter::member(const char *key) {
+  if (!first[depth]) put(',');
+  first[depth] = false;
+  if (key) {
+    putString(key);
+    put(':');
+  }
+}
+
+void JsonWriter::beginObject(const char *key) {
+  member(key);
+  put('{');
+  if (depth + 1 < JSON_MAX_DEPTH) depth++;
+  first[depth] = true;
+}
+
+void JsonWriter::endObject() {
+  put('}');
+  if (depth > 0) depth--;
+}
+
+void JsonWriter::beginArray(const char *key) {
+  member(key);
+  put('[');
+  if (depth + 1 < JSON_MAX_DEPTH) depth++;
+  first[depth] = true;
+}
+
+void JsonWriter::endArray() {
+  put(']');
+  if (depth > 0) depth--;
+}
+
+void JsonWriter::addString(const char *key, const char *value) {
+  if (!value) {
+    addNull(key);
+    return;
+  }
+  member(key);
+  putString(value);
+}
+
+void JsonWriter::addBool(const char *key, bool value) {
+  member(key);
+  put(value ? "true" : "false");
+}
+
+void JsonWriter::addInt(const char *key, int64_t value) {
+  member(key);
+  if (value < 0) {
+    put('-');
+    putUint(0 - (uint64_t)value);
+  } else {
+    putUint(value);
+  }
+}
+
+void JsonWriter::addUint(const char *key, uint64_t value) {
+  member(key);
+  putUint(value);
+}
+
+void JsonWriter::addNull(const char *key) {
+  member(key);
+  put("null");
+}
+
+void JsonWriter::addFixed(const char *key, int64_t value, uint8_t decimals) {
+  member(key);
+  uint64_t scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+  uint64_t mag = value < 0 ? 0 - (uint64_t)value : value;
+  if (value < 0) put('-');
+  putUint(mag / scale);
+  if (decimals == 0) return;
+  put('.');
+  uint64_t frac = mag % scale;
+  for (scale /= 10; scale > 0; scale /= 10) {
+    put('0' + frac / scale);
+    frac %= scale;
+  }
+}
+
+void JsonWriter::addRaw(const char *key, const char *json) {
+  member(key);
+  put(json);
+}
@@ -0,0 +1,62 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "config.h"
+
+#define JSON_MAX_DEPTH 8
+
+// Writes JSON into a fixed caller-owned buffer. When the buffer is full it
+// is passed to the sink and reused, so a response of any size costs the
+// buffer and nothing else: no String, no heap. Without a sink the buffer is
+// all there is: output past its end is dropped and overflowed() turns true,
+// so check it before using data(). Commas are inserted automatically.
+// Inside objects every add takes a key; inside arrays pass nullptr.
+class JsonWriter {
+ public:
+  typedef void (*Sink)(void *ctx, const char *data, size_t len);
+
+  JsonWriter(char *buf, size_t size, Sink sink, void *ctx);
+
+  void beginObject(const char *key = nullptr);
+  void endObject();
+  void beginArray(const char *key = nullptr);
+  void endArray();
+
+  void addString(const char *key, const char *value);   // Escaped
+  void addBool(const char *key, bool value);
+  void addInt(const char *key, int64_t value);
+  void addUint(const char *key, uint64_t value);
+  void addNull(const char *key);
+  // value / 10^decimals, e.g. addFixed(k, 425, 1) writes 42.5
+  void addFixed(const char *key, int64_t value, uint8_t decimals);
+  // Already valid JSON, e.g. a number from formatVolts()
+  void addRaw(const char *key, const char *json);
+
+  // Pass buffered output to the sink; nothing without one
+  void flush();
+
+  const char *data() const { return buf; }
+  size_t buffered() const { return len; }   // Bytes not yet flushed
+  size_t total() const { return flushedBytes + len; }
+  bool flushedAny() const { return flushedBytes > 0; }
+  bool overflowed() const { return overflow; }   // Sinkless and truncated
+
+ private:
+  void put(char c);
+  void put(const char *s);
+  void putUint(uint64_t v);
+  void putString(const char *s);
+  void member(const char *key);
+
+  char *buf;
+  size_t size;
+  size_t len;
+  size_t flushedBytes;
+  Sink sink;
+  void *ctx;
+  uint8_t depth;
+  bool overflow;
+  bool first[JSON_MAX_DEPTH];
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "live.h"
+#include "control.h"
+#include "event_loop.h"
+#include <esp_rom_crc.h>
+
+static LiveHook liveHook = nullptr;
+static int liveEvent = -1;
+static bool watching = false;   // Control task only
+
+// Written by the control task, read by the server task
+static portMUX_TYPE liveMux = portMUX_INITIALIZER_UNLOCKED;
+static LiveState current;
+static uint16_t changed = 0;
+static uint16_t scheduleCrc = 0;
+
+static uint32_t distance(uint32_t a, uint32_t b) {
+  return a > b ? a - b : b - a;
+}
+
+static void checkLive() {
+  LiveState s;
+  s.powerJack = powerJackState;
+  s.usbOutput = usbOutputState;
+  s.pdVoltage = config.pdVoltage;
+  s.pdState = getPDStatus().state;
+  s.vbusMv = getVBusMillivolts();
+  s.voutMv = getVOutMillivolts();
+  s.schedules = config.scheduleCount;
+  s.jackFault = getProtectStats().outputs[PROTECT_JACK].latched;
+  s.usbFault = getProtectStats().outputs[PROTECT_USB].latched;
+  // An edit that keeps the count still changes the table
+  uint16_t crc = esp_rom_crc16_le(0, (const uint8_t *)config.schedules,
+                                  config.scheduleCount * sizeof(Schedule));
+
+  portENTER_CRITICAL(&liveMux);
+  uint16_t mask = changed;
+  if (s.powerJack != current.powerJack) mask |= LIVE_POWER_JACK;
+  if (s.usbOutput != current.usbOutput) mask |= LIVE_USB_OUTPUT;
+  if (s.pdVoltage != current.pdVoltage) mask |= LIVE_PD_VOLTAGE;
+  if (s.pdState != current.pdState) mask |= LIVE_PD_STATE;
+  // A reading within the step keeps the value last reported
+  if (distance(s.vbusMv, current.vbusMv) >= LIVE_VOLTAGE_STEP) mask |= LIVE_VBUS;
+  else s.vbusMv = current.vbusMv;
+  if (distance(s.voutMv, current.voutMv) >= LIVE_VOLTAGE_STEP) mask |= LIVE_VOUT;
+  else s.voutMv = current.voutMv;
+  if (s.schedules != current.schedules || crc != scheduleCrc) mask |= LIVE_SCHEDULES;
+  if (s.jackFault != current.jackFault || s.usbFault != current.usbFault) mask |= LIVE_FAULTS;
+  bool notify = mask != changed;
+  current = s;
+  changed = mask;
+  portEXIT_CRITICAL(&liveMux);
+  scheduleCrc = crc;
+
+  if (notify && liveHook) liveHook();
+}
+
+static void liveTick() {
+  checkLive();
+  scheduleEvent(liveEvent, LIVE_INTERVAL);
+}
+
+void beginLive(LiveHook hook) {
+  liveHook = hook;
+  liveEvent = addEvent(liveTick, 0);
+}
+
+void setLiveWatching(bool on) {
+  if (!onControlTask()) {
+    runOnControl([](void *arg) { setLiveWatching(*(bool *)arg); }, &on);
+    return;
+  }
+  if (on) {
+    // Report everything once, to the new client and any already watching
+    checkLive();
+    portENTER_CRITICAL(&liveMux);
+    changed = LIVE_ALL;
+    portEXIT_CRITICAL(&liveMux);
+    if (liveHook) liveHook();
+    if (!watching) scheduleEvent(liveEvent, LIVE_INTERVAL);
+  } else {
+    cancelEvent(liveEvent);
+  }
+  watching = on;
+}
+
+uint16_t takeLiveChanges(LiveState &state) {
+  portENTER_CRITICAL(&liveMux);
+  state = current;
+  uint16_t mask = changed;
+  changed = 0;
+  portEXIT_CRITICAL(&liveMux);
+  return mask;
+}
@@ -0,0 +1,50 @@
+#ifndef LIVE_H
+#define LIVE_H
+
+#include "config.h"
+#include "hardware.h"
+#include "protection.h"
+
+// Change detection for the /ws push channel. While someone is watching,
+// the control task compares the state below against its last snapshot
+// every LIVE_INTERVAL and reports which fields moved; nothing runs while
+// nobody is connected. Voltages count as changed once they move by
+// LIVE_VOLTAGE_STEP from the last value reported.
+enum LiveField : uint16_t {
+  LIVE_POWER_JACK = 1 << 0,
+  LIVE_USB_OUTPUT = 1 << 1,
+  LIVE_PD_VOLTAGE = 1 << 2,
+  LIVE_PD_STATE   = 1 << 3,
+  LIVE_VBUS       = 1 << 4,
+  LIVE_VOUT       = 1 << 5,
+  LIVE_SCHEDULES  = 1 << 6,   // Added, removed or cleared
+  LIVE_FAULTS     = 1 << 7,
+  LIVE_ALL        = 0xFF
+};
+
+struct LiveState {
+  bool powerJack;
+  bool usbOutput;
+  uint8_t pdVoltage;
+  PDState pdState;
+  uint32_t vbusMv;
+  uint32_t voutMv;
+  uint16_t schedules;     // Up to MAX_SCHEDULES (256)
+  ProtectFault jackFault;
+  ProtectFault usbFault;
+};
+
+// Called on the control task after a check found changes
+typedef void (*LiveHook)();
+
+void beginLive(LiveHook hook);
+
+// Start or stop the periodic check; callable from any task. Starting also
+// marks every field changed so a new client gets the full state first.
+void setLiveWatching(bool on);
+
+// Latest snapshot and the fields changed since the last call, which are
+// then cleared. Callable from any task.
+uint16_t takeLiveChanges(LiveState &state);
+
+#endif
@@ -0,0 +1,74 @@
+#include "perf.h"
+#include <esp_heap_caps.h>
+
+// Each stage is written only by the task that records it, and a reset is
+// carried out by that task too: perfReset() bumps resetGen, and the owner
+// clears its stage before its next record. Readers see a stage whose owner
+// has not caught up yet as empty.
+static PerfStats stages[PERF_STAGE_COUNT];
+static uint32_t stageGen[PERF_STAGE_COUNT];
+static volatile uint32_t resetGen = 0;
+static volatile uint32_t windowStart = 0;
+static const PerfStats emptyStats = {};
+
+static const char *const stageNames[PERF_STAGE_COUNT] = {
+  "control_loop", "net_loop", "buttons", "schedules", "timers", "control_queue",
+  "storage", "flash_commit", "adc", "wifi", "web", "serial"
+};
+
+#if PERF_ENABLED
+void perfRecord(uint8_t stage, uint32_t cycles) {
+  PerfStats &s = stages[stage];
+  uint32_t gen = resetGen;
+  if (stageGen[stage] != gen) {
+    memset(&s, 0, sizeof(s));
+    stageGen[stage] = gen;
+  }
+  s.count++;
+  s.totalCycles += cycles;
+  if (cycles > s.maxCycles) s.maxCycles = cycles;
+  s.buckets[31 - __builtin_clz(cycles | 1)]++;
+}
+#endif
+
+const char *perfStageName(uint8_t stage) {
+  return stage < PERF_STAGE_COUNT ? stageNames[stage] : "?";
+}
+
+const PerfStats& getPerfStats(uint8_t stage) {
+  return stageGen[stage] == resetGen ? stages[stage] : emptyStats;
+}
+
+uint32_t perfCyclesToUs(uint64_t cycles) {
+  return (uint32_t)(cycles / getCpuFrequencyMhz());
+}
+
+uint32_t perfPercentileCycles(const PerfStats &s, uint8_t pct) {
+  if (s.count == 0) return 0;
+  uint32_t rank = (uint32_t)(((uint64_t)s.count * pct + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < PERF_BUCKETS; i++) {
+    seen += s.buckets[i];
+    if (seen >= rank) {
+      uint32_t upper = i == 31 ? UINT32_MAX : (2UL << i) - 1;
+      return upper < s.maxCycles ? upper : s.maxCycles;
+    }
+  }
+  return s.maxCycles;
+}
+
+uint32_t perfWindowMs() {
+  return millis() - windowStart;
+}
+
+void perfReset() {
+  windowStart = millis();
+  resetGen = resetGen + 1;
+}
+
+void perfHeapSnapshot(PerfHeap &h) {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+  h.freeBytes = info.total_free_bytes;
+  h.blocks = info.allocated_blocks;
+}
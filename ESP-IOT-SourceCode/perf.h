@@ -0,0 +1,79 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include "config.h"
+
+// Per-stage execution time, measured with the CPU cycle counter into log2
+// histograms: bucket i counts runs of [2^i, 2^(i+1)) cycles. Recording is
+// a few instructions, so it stays on in production; build with
+// PERF_ENABLED 0 to compile every PERF_SCOPE away.
+enum PerfStage : uint8_t {
+  PERF_CONTROL_LOOP,   // One control-task wakeup: every event that was due
+  PERF_NET_LOOP,       // One loop() pass, without its idle delay
+  PERF_BUTTONS,        // Control task
+  PERF_SCHEDULES,      // Control task
+  PERF_TIMERS,         // Control task
+  PERF_CONTROL_QUEUE,  // Calls forwarded to the control task, run there
+  PERF_STORAGE,        // One storage-task pass: config commit and journal appends
+  PERF_FLASH_COMMIT,   // EEPROM.commit(), on the storage task
+  PERF_ADC,            // One ADC frame on the ADC task: filter and protection check
+  PERF_WIFI,           // loop() task
+  PERF_WEB,            // One HTTP request, on the server task (there is one)
+  PERF_SERIAL,         // One serial command on the loop() task, with its output
+  PERF_STAGE_COUNT
+};
+
+#define PERF_BUCKETS 32
+
+struct PerfStats {
+  uint32_t count;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  uint32_t buckets[PERF_BUCKETS];
+};
+
+#if PERF_ENABLED
+#include <esp_cpu.h>
+
+// Each stage must only be recorded from one task, the one named above
+void perfRecord(uint8_t stage, uint32_t cycles);
+
+class PerfScope {
+ public:
+  explicit PerfScope(uint8_t stage) : stage(stage), start(esp_cpu_get_cycle_count()) {}
+  ~PerfScope() { perfRecord(stage, esp_cpu_get_cycle_count() - start); }
+ private:
+  uint8_t stage;
+  uint32_t start;
+};
+
+#define PERF_SCOPE(stage) PerfScope perfScope_(stage)
+#else
+#define PERF_SCOPE(stage) ((void)0)
+#endif
+
+const char *perfStageName(uint8_t stage);
+const PerfStats& getPerfStats(uint8_t stage);
+
+// Cycles to microseconds at the current CPU clock
+uint32_t perfCyclesToUs(uint64_t cycles);
+
+// Upper bound, in cycles, of the bucket holding the given percentile
+uint32_t perfPercentileCycles(const PerfStats &s, uint8_t pct);
+
+// Milliseconds since boot or the last reset, for rates
+uint32_t perfWindowMs();
+
+// Clear all stages, from any task. Each stage is cleared by the task that
+// records it, on its next record; until then it reads as empty.
+void perfReset();
+
+// Default heap as heap_caps_get_info() sees it, all tasks. Works on any SDK
+// build; take one before and after a run and compare.
+struct PerfHeap {
+  uint32_t freeBytes;
+  uint32_t blocks;      // Allocated blocks
+};
+void perfHeapSnapshot(PerfHeap &h);
+
+#endif
@@ -0,0 +1,84 @@
+#include "power.h"
+#include "storage.h"
+#include "control.h"
+#include <WiFi.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+
+static PowerStats stats = {};
+
+// Pins whose level or pull must survive light sleep
+static const uint8_t heldPins[] = {
+  POWER_JACK_PIN, USB_OUTPUT_PIN, CFG1_PIN, CFG2_PIN, CFG3_PIN,
+  BUTTON1_PIN, BUTTON2_PIN, BUTTON3_PIN, BUTTON4_PIN
+};
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+// Runs with interrupts disabled on the way out of every light sleep
+static esp_err_t IRAM_ATTR onSleepExit(int64_t sleptUs, void *) {
+  stats.sleeps++;
+  stats.sleptUs += sleptUs;
+  return ESP_OK;
+}
+#endif
+
+static bool applyPowerMode(bool enabled) {
+  // The CPU clock stays fixed: work runs at full speed and the chip sleeps
+  // sooner, and /perf cycle counts keep converting at one rate
+  int mhz = getCpuFrequencyMhz();
+  esp_pm_config_t pm = {};
+  pm.max_freq_mhz = mhz;
+  pm.min_freq_mhz = mhz;
+  pm.light_sleep_enable = enabled;
+  esp_err_t err = esp_pm_configure(&pm);
+
+  // Light sleep with a live link needs modem sleep; the radio then wakes
+  // for each DTIM beacon and the AP buffers traffic in between
+  if (enabled) WiFi.setSleep(true);
+
+  stats.lightSleep = enabled && err == ESP_OK;
+  Serial.print(F("Low-power mode: "));
+  if (!enabled) {
+    Serial.println(F("OFF"));
+  } else if (err == ESP_OK) {
+    Serial.println(F("ON (light sleep + modem sleep)"));
+  } else {
+    Serial.print(F("modem sleep only, light sleep unavailable ("));
+    Serial.print(esp_err_to_name(err));
+    Serial.println(F(")"));
+  }
+  return !enabled || err == ESP_OK;
+}
+
+void beginPower() {
+  for (uint8_t i = 0; i < sizeof(heldPins); i++) {
+    gpio_sleep_sel_dis((gpio_num_t)heldPins[i]);
+  }
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+  esp_pm_sleep_cbs_register_config_t cbs = {};
+  cbs.exit_cb = onSleepExit;
+  stats.sleepTracked = esp_pm_light_sleep_register_cbs(&cbs) == ESP_OK;
+#endif
+  stats.startUs = esp_timer_get_time();
+  applyPowerMode(config.lowPower);
+}
+
+bool setLowPowerMode(bool enabled) {
+  if (!onControlTask()) {
+    struct Call { bool enabled, ok; } call = { enabled, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = setLowPowerMode(c->enabled); }, &call);
+    return call.ok;
+  }
+  config.lowPower = enabled;
+  saveConfig();
+  return applyPowerMode(enabled);
+}
+
+uint32_t ioPollInterval() {
+  return config.lowPower ? IO_POLL_INTERVAL_LOW_POWER : IO_POLL_INTERVAL;
+}
+
+const PowerStats& getPowerStats() {
+  return stats;
+}
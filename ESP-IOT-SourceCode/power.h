@@ -0,0 +1,31 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "config.h"
+
+// Low-power mode: automatic light sleep whenever all tasks are blocked,
+// with Wi-Fi modem sleep keeping the link up between DTIM beacons. The
+// control task's next deadline, a button edge or network traffic wakes the
+// chip. Outputs and button pull-ups hold their state while asleep.
+struct PowerStats {
+  bool lightSleep;       // Light sleep is configured and active
+  bool sleepTracked;     // Sleep callbacks available; sleeps/sleptUs valid
+  uint32_t sleeps;       // Light sleep entries
+  uint64_t sleptUs;      // Time spent in light sleep
+  uint64_t startUs;      // When tracking started, for the asleep/awake ratio
+};
+
+// Keep pin configuration through sleep and apply config.lowPower
+void beginPower();
+
+// Switch the mode and persist it. Returns false when this build's SDK
+// lacks automatic light sleep; modem sleep is still enabled then.
+bool setLowPowerMode(bool enabled);
+
+// loop() idles this long between network polls; longer in low-power mode
+// so the chip can stay asleep between polls
+uint32_t ioPollInterval();
+
+const PowerStats& getPowerStats();
+
+#endif
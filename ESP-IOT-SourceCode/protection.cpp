@@ -0,0 +1,177 @@
+#include "protection.h"
+#include "hardware.h"
+#include "storage.h"
+#include "control.h"
+#include "adc_sampler.h"
+#include "event_loop.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+// Which rail each output is judged by, and how to drive it
+struct ProtectedOutput {
+  uint8_t pin;
+  uint8_t offLevel;
+  uint8_t rail;                 // AdcChannel
+  const bool *state;
+  bool (*setState)(bool);
+};
+
+static const ProtectedOutput protectedOutputs[PROTECT_OUTPUT_COUNT] = {
+  { POWER_JACK_PIN, LOW, ADC_VOUT, &powerJackState, setPowerJackState },
+  { USB_OUTPUT_PIN, HIGH, ADC_VBUS, &usbOutputState, setUSBOutputState },   // Inverted
+};
+
+// The check runs on the ADC task, switching on on the control task. The
+// latch and the pin level change together under the lock, so an output
+// cannot be switched on between a trip and its latch.
+static portMUX_TYPE protectMux = portMUX_INITIALIZER_UNLOCKED;
+static ProtectStats stats = {};
+static bool unreported[PROTECT_OUTPUT_COUNT];
+static int reportEvent = -1;
+
+// ADC task only
+static bool wasOn[PROTECT_OUTPUT_COUNT];
+static int64_t onSinceUs[PROTECT_OUTPUT_COUNT];
+
+// Cut the output and latch. The rest (output state, journal, log) takes
+// the control queue and is left to reportTrips().
+static void trip(uint8_t i, ProtectFault fault, uint32_t mv, uint32_t limitMv, int64_t readyUs) {
+  const ProtectedOutput &o = protectedOutputs[i];
+  ProtectOutputStats &s = stats.outputs[i];
+  portENTER_CRITICAL(&protectMux);
+  digitalWrite(o.pin, o.offLevel);
+  s.latched = fault;
+  s.railMv = mv;
+  s.limitMv = limitMv;
+  unreported[i] = true;
+  portEXIT_CRITICAL(&protectMux);
+
+  uint32_t reactionUs = esp_timer_get_time() - readyUs;
+  if (reactionUs > stats.maxReactionUs) stats.maxReactionUs = reactionUs;
+  s.reactionUs = reactionUs;
+  if (fault == PROTECT_FAULT_UVP) s.uvpTrips++;
+  else s.ovpTrips++;
+  wasOn[i] = false;
+  triggerEvent(reportEvent);
+}
+
+// Control task: bring the output state in line with a trip and log it
+static void reportTrips() {
+  for (uint8_t i = 0; i < PROTECT_OUTPUT_COUNT; i++) {
+    const ProtectOutputStats &s = stats.outputs[i];
+    portENTER_CRITICAL(&protectMux);
+    bool fresh = unreported[i];
+    ProtectFault fault = s.latched;
+    unreported[i] = false;
+    portEXIT_CRITICAL(&protectMux);
+    if (!fresh || fault == PROTECT_FAULT_NONE) continue;
+
+    Serial.print(F("ERR: "));
+    Serial.print(protectFaultName(fault));
+    Serial.print(F(" on "));
+    Serial.print(protectOutputName((ProtectOutput)i));
+    Serial.print(F(": "));
+    Serial.print(s.railMv);
+    Serial.print(F("mV vs limit "));
+    Serial.print(s.limitMv);
+    Serial.print(F("mV, output off after "));
+    Serial.print(s.reactionUs);
+    Serial.println(F("us. /protect clear to re-arm"));
+    protectedOutputs[i].setState(false);
+  }
+}
+
+void beginProtection() {
+  reportEvent = addEvent(reportTrips, 0);
+}
+
+void protectionCheck(const uint32_t *mv, int64_t readyUs) {
+  // The rail moves while PD renegotiates: until it settles it is judged
+  // against the higher of the old and new settings, and UVP waits
+  const PDStatus &pd = getPDStatus();
+  bool settling = pd.state == PD_SETTLING;
+  uint8_t pdVolts = config.pdVoltage;
+  if (settling && pd.previous > pdVolts) pdVolts = pd.previous;
+  uint32_t pdMaxMv = pdVolts * (uint32_t)(1000 + PROTECT_PD_MARGIN * 10);
+
+  for (uint8_t i = 0; i < PROTECT_OUTPUT_COUNT; i++) {
+    const ProtectedOutput &o = protectedOutputs[i];
+    // Latched: already off, its state catches up on the control task
+    if (!*o.state || stats.outputs[i].latched != PROTECT_FAULT_NONE) {
+      wasOn[i] = false;
+      continue;
+    }
+    if (!wasOn[i]) {
+      wasOn[i] = true;
+      onSinceUs[i] = readyUs;
+    }
+
+    const OutputLimits &l = config.outputLimits[i];
+    uint32_t railMv = mv[o.rail];
+    if (l.maxMv > 0 && railMv > l.maxMv) {
+      trip(i, PROTECT_FAULT_OVP, railMv, l.maxMv, readyUs);
+    } else if (pdMaxMv > 0 && railMv > pdMaxMv) {
+      trip(i, PROTECT_FAULT_PD, railMv, pdMaxMv, readyUs);
+    } else if (l.minMv > 0 && railMv < l.minMv && !settling &&
+               readyUs - onSinceUs[i] >= PROTECT_BLANKING_MS * 1000LL) {
+      trip(i, PROTECT_FAULT_UVP, railMv, l.minMv, readyUs);
+    }
+  }
+}
+
+bool protectionAllows(ProtectOutput output) {
+  return stats.outputs[output].latched == PROTECT_FAULT_NONE;
+}
+
+bool protectionDrive(ProtectOutput output, bool on) {
+  const ProtectedOutput &o = protectedOutputs[output];
+  portENTER_CRITICAL(&protectMux);
+  bool allowed = !on || stats.outputs[output].latched == PROTECT_FAULT_NONE;
+  if (allowed) digitalWrite(o.pin, on ? !o.offLevel : o.offLevel);
+  portEXIT_CRITICAL(&protectMux);
+  return allowed;
+}
+
+void clearProtectionFaults() {
+  if (!onControlTask()) {
+    runOnControl([](void *) { clearProtectionFaults(); }, nullptr);
+    return;
+  }
+  portENTER_CRITICAL(&protectMux);
+  for (uint8_t i = 0; i < PROTECT_OUTPUT_COUNT; i++) {
+    stats.outputs[i].latched = PROTECT_FAULT_NONE;
+  }
+  portEXIT_CRITICAL(&protectMux);
+  Serial.println(F("Protection faults cleared"));
+}
+
+void setProtectionLimits(ProtectOutput output, uint16_t minMv, uint16_t maxMv) {
+  if (!onControlTask()) {
+    struct Call { ProtectOutput output; uint16_t minMv, maxMv; } call = { output, minMv, maxMv };
+    runOnControl([](void *arg) {
+      Call *c = (Call *)arg;
+      setProtectionLimits(c->output, c->minMv, c->maxMv);
+    }, &call);
+    return;
+  }
+  config.outputLimits[output].minMv = minMv;
+  config.outputLimits[output].maxMv = maxMv;
+  saveConfig();
+}
+
+const ProtectStats& getProtectStats() {
+  return stats;
+}
+
+const char *protectOutputName(ProtectOutput output) {
+  return output == PROTECT_JACK ? "jack" : "usb";
+}
+
+const char *protectFaultName(ProtectFault fault) {
+  switch (fault) {
+    case PROTECT_FAULT_OVP: return "ovp";
+    case PROTECT_FAULT_PD:  return "ovp-pd";
+    case PROTECT_FAULT_UVP: return "uvp";
+    default:                return "none";
+  }
+}
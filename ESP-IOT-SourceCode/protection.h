@@ -0,0 +1,67 @@
+#ifndef PROTECTION_H
+#define PROTECTION_H
+
+#include "config.h"
+
+// Over/under-voltage protection. Every ADC frame is checked on the ADC task
+// (ADC_TASK_PRIORITY, above control, storage and lwIP) as soon as it
+// completes, and the pin is cut there, so an output is off at most one frame
+// (ADC_OVERSAMPLE conversions, ~20ms) plus that task's wakeup after the rail
+// leaves its window, whatever the control task is doing. This holds in
+// low-power mode too: the ADC only pauses while both outputs are off, which
+// also means light sleep is effectively never entered while one is on. A
+// tripped output stays off until the fault is cleared.
+enum ProtectOutput : uint8_t {
+  PROTECT_JACK,
+  PROTECT_USB,
+  PROTECT_OUTPUT_COUNT
+};
+
+enum ProtectFault : uint8_t {
+  PROTECT_FAULT_NONE,
+  PROTECT_FAULT_OVP,     // Above the configured maximum
+  PROTECT_FAULT_PD,      // Above the PD setting + PROTECT_PD_MARGIN
+  PROTECT_FAULT_UVP      // Below the configured minimum
+};
+
+struct ProtectOutputStats {
+  ProtectFault latched;  // Fault holding the output off
+  uint32_t railMv;       // Reading that tripped it
+  uint32_t limitMv;
+  uint32_t ovpTrips;     // OVP and PD trips
+  uint32_t uvpTrips;
+  uint32_t reactionUs;   // Frame-complete to output-off for the last trip
+};
+
+struct ProtectStats {
+  ProtectOutputStats outputs[PROTECT_OUTPUT_COUNT];
+  uint32_t maxReactionUs;  // Worst frame-complete to output-off delay
+};
+
+// Register the control-side trip report; call before beginControlTask()
+void beginProtection();
+
+// Check one frame of rail millivolts (ADC_CHANNEL_COUNT values) on the ADC
+// task. readyUs is when the ADC finished the frame, for the reaction time.
+// Never blocks: a trip cuts the pin and latches, the output state and the
+// log follow on the control task.
+void protectionCheck(const uint32_t *mv, int64_t readyUs);
+
+// False while a fault holds the output off
+bool protectionAllows(ProtectOutput output);
+
+// Drive an output's pin. Switching on is refused (false) while latched; the
+// check and the write are atomic against a trip.
+bool protectionDrive(ProtectOutput output, bool on);
+
+// Clear latched faults; the outputs stay off until switched on again
+void clearProtectionFaults();
+
+// Set an output's window in millivolts (0 disables that side) and persist it
+void setProtectionLimits(ProtectOutput output, uint16_t minMv, uint16_t maxMv);
+
+const ProtectStats& getProtectStats();
+const char *protectOutputName(ProtectOutput output);
+const char *protectFaultName(ProtectFault fault);
+
+#endif
@@ -1,28 +1,485 @@
 #include "scheduler.h"
 #include "hardware.h"
-#include <time.h>
+#include "storage.h"
+#include "timekeeping.h"
+#include "control.h"
+#include <esp_timer.h>
+
+// Per-weekday lists of schedules sorted by time of day, plus the absolute
+// time of the next event. checkSchedules() only compares currentTime against
+// nextFire; the index is rebuilt when schedules, the timezone or the clock
+// change. Finding the next event is a binary search in one day's list.
+// The simulator builds a second index over its own copy of the table.
+struct ScheduleIndex {
+  const Schedule *table;
+  uint16_t count;
+  long tzOffset;                         // Seconds east of UTC
+  uint16_t dayEntries[7][MAX_SCHEDULES]; // Schedule indices, by minute
+  uint16_t dayCount[7];
+  uint16_t minuteOf[MAX_SCHEDULES];      // Minute of day per schedule
+  bool valid;
+  time_t nextFire;      // UTC epoch of the next event, 0 = none
+  uint8_t nextDay;      // Weekday list holding the next event
+  int nextPos;          // First entry in that list firing at nextFire
+  time_t lastFired;     // Minute (UTC epoch) last executed
+  time_t lastCheck;
+};
+
+static ScheduleIndex live = { config.schedules };
+
+static const char *const DAY_NAMES[7] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+
+static uint16_t toMinuteOfDay(uint16_t hhmm) {
+  return (hhmm / 100) * 60 + (hhmm % 100);
+}
+
+// 1970-01-01 was a Thursday
+static uint8_t weekdayOf(time_t localDayStart) {
+  return (uint8_t)((localDayStart / 86400 + 4) % 7);
+}
+
+// Find the first event at or after `from` (minute aligned, UTC)
+static void findNextFire(ScheduleIndex &x, time_t from) {
+  time_t local = from + x.tzOffset;
+  time_t dayStart = local - (local % 86400);
+  uint16_t minute = (local % 86400) / 60;
+
+  // A week plus one day covers every weekday, including today's earlier events
+  for (int d = 0; d < 8; d++) {
+    uint8_t wd = weekdayOf(dayStart);
+    const uint16_t *list = x.dayEntries[wd];
+    int lo = 0, hi = x.dayCount[wd];
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (x.minuteOf[list[mid]] < minute) lo = mid + 1;
+      else hi = mid;
+    }
+    if (lo < x.dayCount[wd]) {
+      x.nextDay = wd;
+      x.nextPos = lo;
+      x.nextFire = dayStart + (time_t)x.minuteOf[list[lo]] * 60 - x.tzOffset;
+      return;
+    }
+    dayStart += 86400;
+    minute = 0;
+  }
+  x.nextFire = 0;
+}
+
+// Index x.table[0..count) under x.tzOffset, for a clock reading `now`
+static void rebuildIndex(ScheduleIndex &x, time_t now) {
+  uint16_t sorted[MAX_SCHEDULES];
+
+  // Insertion sort keeps entries with the same time in list order, so
+  // same-minute schedules always execute in a fixed sequence
+  int n = 0;
+  for (int i = 0; i < x.count; i++) {
+    uint16_t m = toMinuteOfDay(x.table[i].time);
+    x.minuteOf[i] = m;
+    int j = n;
+    while (j > 0 && x.minuteOf[sorted[j - 1]] > m) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = i;
+    n++;
+  }
+
+  memset(x.dayCount, 0, sizeof(x.dayCount));
+  for (int k = 0; k < n; k++) {
+    uint8_t days = x.table[sorted[k]].days;
+    for (int wd = 0; wd < 7; wd++) {
+      if (days & (1 << wd)) x.dayEntries[wd][x.dayCount[wd]++] = sorted[k];
+    }
+  }
+
+  // Events earlier in the current minute still fire, unless already done
+  time_t from = now - (now % 60);
+  if (from <= x.lastFired) from = x.lastFired + 60;
+  findNextFire(x, from);
+  x.valid = true;
+}
+
+static void rebuildLive() {
+  int hours;
+  getTimezoneOffset(hours);
+  live.tzOffset = (long)hours * 3600;
+  live.count = config.scheduleCount;
+  rebuildIndex(live, currentTime);
+}
+
+// Run every entry due at `now`, in list order, as run(entry, minute), then
+// move the index on to the next event
+template <typename Run>
+static void fireDue(ScheduleIndex &x, time_t now, Run run) {
+  if (x.nextFire == 0 || now < x.nextFire) return;
+  const uint16_t *list = x.dayEntries[x.nextDay];
+  uint16_t minute = x.minuteOf[list[x.nextPos]];
+  for (int p = x.nextPos; p < x.dayCount[x.nextDay] && x.minuteOf[list[p]] == minute; p++) {
+    run(list[p], x.nextFire);
+  }
+  x.lastFired = x.nextFire;
+  findNextFire(x, x.nextFire + 60);
+}
+
+// Walk back from `t` through at most eight days of the index. Within a day
+// the binary search finds the last entry at or before the minute; entries
+// are then visited newest first until every target has its governing event.
+void scheduleStateAt(time_t t, ScheduleState &state) {
+  memset(&state, 0, sizeof(state));
+  if (!live.valid) rebuildLive();
+
+  time_t local = t + live.tzOffset;
+  time_t dayStart = local - (local % 86400);
+  uint16_t minute = (local % 86400) / 60;
+
+  for (int d = 0; d < 8; d++) {
+    uint8_t wd = weekdayOf(dayStart);
+    const uint16_t *list = live.dayEntries[wd];
+    int lo = 0, hi = live.dayCount[wd];
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (live.minuteOf[list[mid]] <= minute) lo = mid + 1;
+      else hi = mid;
+    }
+    for (int p = lo - 1; p >= 0; p--) {
+      const Schedule &s = config.schedules[list[p]];
+      time_t at = dayStart + (time_t)live.minuteOf[list[p]] * 60 - live.tzOffset;
+      bool on = s.action == 1;
+      if (s.target == SCHEDULE_TARGET_PD) {
+        if (state.pdAt == 0) { state.pdAt = at; state.pdVoltage = s.action; }
+        continue;
+      }
+      if (s.target != SCHEDULE_TARGET_USB && state.jackAt == 0) { state.jackAt = at; state.jack = on; }
+      if (s.target != SCHEDULE_TARGET_JACK && state.usbAt == 0) { state.usbAt = at; state.usb = on; }
+      if (state.jackAt && state.usbAt && state.pdAt) return;
+    }
+    dayStart -= 86400;
+    minute = 1439;
+  }
+}
+
+int catchUpSchedules(time_t from, time_t to) {
+  if (to < 100000 || to <= from) return 0;
+
+  ScheduleState state;
+  scheduleStateAt(to, state);
+  int changed = 0;
+  if (state.jackAt > from && state.jack != powerJackState) {
+    setPowerJackState(state.jack);
+    changed++;
+  }
+  if (state.usbAt > from && state.usb != usbOutputState) {
+    setUSBOutputState(state.usb);
+    changed++;
+  }
+  if (state.pdAt > from && state.pdVoltage != config.pdVoltage) {
+    setPDVoltage(state.pdVoltage);
+    changed++;
+  }
+
+  // Everything up to and including the current minute is now applied
+  live.lastFired = to - (to % 60);
+  live.lastCheck = to;
+  live.valid = false;
+
+  if (changed > 0) {
+    Serial.print(F("Schedule catch-up: "));
+    Serial.print(changed);
+    Serial.println(F(" output(s) changed."));
+  }
+  return changed;
+}
+
+static void runSchedule(const Schedule &s) {
+  bool state = s.action == 1;
+  switch (s.target) {
+    case SCHEDULE_TARGET_JACK:
+      setPowerJackState(state);
+      break;
+    case SCHEDULE_TARGET_USB:
+      setUSBOutputState(state);
+      break;
+    case SCHEDULE_TARGET_PD:
+      setPDVoltage(s.action);
+      break;
+    default:
+      setPowerJackState(state);
+      setUSBOutputState(state);
+      break;
+  }
+}
+
+void invalidateSchedules() {
+  live.valid = false;   // A single store; safe from any task
+}
+
+time_t nextScheduleTime() {
+  return live.valid ? live.nextFire : 0;
+}
 
 void checkSchedules() {
   if (currentTime < 100000) return;  // Time not set
-  
-  struct tm *timeinfo = localtime(&currentTime);
-  uint16_t currentTimeVal = timeinfo->tm_hour * 100 + timeinfo->tm_min;
-  
-  for (int i = 0; i < config.scheduleCount; i++) {
-    if (config.schedules[i].time == currentTimeVal) {
-      // Check if we haven't already executed this minute
-      static uint16_t lastExecutedTime = 9999;
-      if (currentTimeVal != lastExecutedTime) {
-        lastExecutedTime = currentTimeVal;
-        // Apply schedule to both outputs
-        bool state = config.schedules[i].action == 1;
-        setPowerJackState(state);
-        setUSBOutputState(state);
-        Serial.print(F("Schedule executed: "));
-        Serial.print(config.schedules[i].time);
-        Serial.print(F(" -> "));
-        Serial.println(config.schedules[i].action ? F("ON") : F("OFF"));
+
+  // A clock that moves backwards or leaps ahead was set, not ticked. Events
+  // skipped by a forward leap are caught up rather than lost.
+  if (live.lastCheck > 100000 && currentTime - live.lastCheck > SCHEDULE_CLOCK_JUMP) {
+    catchUpSchedules(live.lastCheck, currentTime);
+  } else if (currentTime < live.lastCheck || currentTime - live.lastCheck > SCHEDULE_CLOCK_JUMP) {
+    live.valid = false;
+  }
+  live.lastCheck = currentTime;
+  if (!live.valid) rebuildLive();
+
+  fireDue(live, currentTime, [](uint16_t entry, time_t) {
+    const Schedule &s = config.schedules[entry];
+    runSchedule(s);
+    Serial.print(F("Schedule executed: "));
+    Serial.print(s.time);
+    Serial.print(F(" "));
+    Serial.print(scheduleTargetName(s.target));
+    Serial.print(F(" -> "));
+    if (s.target == SCHEDULE_TARGET_PD) {
+      Serial.print(s.action);
+      Serial.println(F("V"));
+    } else {
+      Serial.println(s.action ? F("ON") : F("OFF"));
+    }
+  });
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+// Runs on the calling (network) task against a copy of the table, its own
+// index and its own clock, so the control task keeps running and
+// currentTime is never touched. Only the copy is made on the control task.
+struct Simulation {
+  ScheduleIndex index;
+  Schedule table[MAX_SCHEDULES];
+  time_t now;           // currentTime when the copy was taken
+  bool jack, usb;       // Virtual outputs
+  uint8_t pd;
+  uint32_t hash;
+};
+
+// FNV-1a over (minute, entry) pairs, so order matters
+static uint32_t hashFire(uint32_t hash, time_t minute, uint16_t entry) {
+  uint32_t words[2] = { (uint32_t)(minute / 60), entry };
+  const uint8_t *p = (const uint8_t *)words;
+  for (size_t i = 0; i < sizeof(words); i++) {
+    hash = (hash ^ p[i]) * 16777619UL;
+  }
+  return hash;
+}
+
+static void runSimulated(Simulation &sim, const Schedule &s, ScheduleSimResult &r) {
+  bool state = s.action == 1;
+  if (s.target == SCHEDULE_TARGET_PD) {
+    if (sim.pd != s.action) r.pdChanges++;
+    sim.pd = s.action;
+    return;
+  }
+  if (s.target != SCHEDULE_TARGET_USB) {
+    if (sim.jack != state) r.jackChanges++;
+    sim.jack = state;
+  }
+  if (s.target != SCHEDULE_TARGET_JACK) {
+    if (sim.usb != state) r.usbChanges++;
+    sim.usb = state;
+  }
+}
+
+// What the original scheduler did: scan every entry each minute. Returns the
+// hash of the fired sequence and counts the entries.
+static uint32_t referenceRun(const Simulation &sim, time_t start, time_t end, uint32_t &count) {
+  uint32_t hash = 2166136261UL;
+  count = 0;
+  for (time_t t = start; t < end; t += 60) {
+    time_t local = t + sim.index.tzOffset;
+    uint16_t hhmm = ((local % 86400) / 3600) * 100 + (local % 3600) / 60;
+    uint8_t wd = weekdayOf(local - (local % 86400));
+    for (int i = 0; i < sim.index.count; i++) {
+      const Schedule &s = sim.table[i];
+      if (s.time == hhmm && (s.days & (1 << wd))) {
+        hash = hashFire(hash, t, i);
+        count++;
+      }
+    }
+    if ((t / 60) % 100000 == 0) delay(1);  // Let the idle task feed the watchdog
+  }
+  return hash;
+}
+
+bool simulateSchedules(uint16_t days, uint8_t stepSec, ScheduleSimResult &result) {
+  if (days == 0 || stepSec == 0 || stepSec > 60) return false;
+  memset(&result, 0, sizeof(result));
+
+  // ~6 KB, only for the length of the run
+  Simulation *sim = (Simulation *)calloc(1, sizeof(Simulation));
+  if (sim == nullptr) return false;
+
+  runOnControl([](void *arg) {
+    Simulation *s = (Simulation *)arg;
+    int hours;
+    getTimezoneOffset(hours);
+    s->index.tzOffset = (long)hours * 3600;
+    s->index.count = config.scheduleCount;
+    memcpy(s->table, config.schedules, config.scheduleCount * sizeof(Schedule));
+    s->jack = powerJackState;
+    s->usb = usbOutputState;
+    s->pd = config.pdVoltage;
+    s->now = currentTime;
+  }, sim);
+  sim->index.table = sim->table;
+  sim->hash = 2166136261UL;
+
+  // Start on a minute boundary; without a synced clock, 2026-01-01 UTC
+  time_t start = sim->now > 100000 ? sim->now : 1767225600;
+  start -= start % 60;
+  time_t end = start + (time_t)days * 86400;
+  rebuildIndex(sim->index, start);
+
+  int64_t began = esp_timer_get_time();
+  int64_t paused = 0;
+  for (time_t t = start; t < end; t += stepSec) {
+    fireDue(sim->index, t, [&](uint16_t entry, time_t minute) {
+      runSimulated(*sim, sim->table[entry], result);
+      result.fired++;
+      sim->hash = hashFire(sim->hash, minute, entry);
+    });
+    result.checks++;
+    if ((result.checks & 0x3FFFF) == 0) {
+      int64_t p = esp_timer_get_time();
+      delay(1);
+      paused += esp_timer_get_time() - p;
+    }
+  }
+  result.elapsedUs = esp_timer_get_time() - began - paused;
+
+  result.match = referenceRun(*sim, start, end, result.expected) == sim->hash &&
+                 result.expected == result.fired;
+  free(sim);
+  return true;
+}
+
+// ============================================================================
+// Schedule Table
+// ============================================================================
+bool addSchedule(const Schedule &s) {
+  if (!onControlTask()) {
+    struct Call { const Schedule *s; bool ok; } call = { &s, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = addSchedule(*c->s); }, &call);
+    return call.ok;
+  }
+  if (config.scheduleCount >= MAX_SCHEDULES) return false;
+  config.schedules[config.scheduleCount++] = s;
+  saveConfig();
+  invalidateSchedules();
+  return true;
+}
+
+bool removeSchedule(int index) {
+  if (!onControlTask()) {
+    struct Call { int index; bool ok; } call = { index, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = removeSchedule(c->index); }, &call);
+    return call.ok;
+  }
+  if (index < 0 || index >= config.scheduleCount) return false;
+  for (int i = index; i < config.scheduleCount - 1; i++) {
+    config.schedules[i] = config.schedules[i + 1];
+  }
+  config.scheduleCount--;
+  saveConfig();
+  invalidateSchedules();
+  return true;
+}
+
+void clearSchedules() {
+  if (!onControlTask()) {
+    runOnControl([](void *) { clearSchedules(); }, nullptr);
+    return;
+  }
+  config.scheduleCount = 0;
+  saveConfig();
+  invalidateSchedules();
+}
+
+// ============================================================================
+// Parsing & Formatting
+// ============================================================================
+bool isValidPDVoltage(uint8_t voltage) {
+  return voltage == 5 || voltage == 9 || voltage == 12 || voltage == 15 || voltage == 20;
+}
+
+bool parseScheduleDays(String text, uint8_t &days) {
+  text.trim();
+  text.toLowerCase();
+  if (text.length() == 0 || text == "daily") {
+    days = SCHEDULE_DAYS_ALL;
+    return true;
+  }
+  if (text == "weekdays") {
+    days = 0x3E;
+    return true;
+  }
+  if (text == "weekends") {
+    days = 0x41;
+    return true;
+  }
+
+  // Comma-separated day names
+  days = 0;
+  int start = 0;
+  while (start < (int)text.length()) {
+    int end = text.indexOf(',', start);
+    if (end == -1) end = text.length();
+    String name = text.substring(start, end);
+    name.trim();
+    int wd = 0;
+    while (wd < 7 && name != DAY_NAMES[wd]) wd++;
+    if (wd == 7) return false;
+    days |= 1 << wd;
+    start = end + 1;
+  }
+  return days != 0;
+}
+
+void formatScheduleDays(uint8_t days, char *buf, size_t len) {
+  days &= SCHEDULE_DAYS_ALL;
+  if (days == SCHEDULE_DAYS_ALL) {
+    snprintf(buf, len, "daily");
+  } else if (days == 0x3E) {
+    snprintf(buf, len, "weekdays");
+  } else if (days == 0x41) {
+    snprintf(buf, len, "weekends");
+  } else {
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (int wd = 0; wd < 7 && pos < len; wd++) {
+      if (days & (1 << wd)) {
+        pos += snprintf(buf + pos, len - pos, "%s%s", pos ? "," : "", DAY_NAMES[wd]);
       }
     }
   }
 }
+
+bool parseScheduleTarget(String text, uint8_t &target) {
+  text.trim();
+  text.toLowerCase();
+  if (text == "both" || text == "all") target = SCHEDULE_TARGET_BOTH;
+  else if (text == "jack") target = SCHEDULE_TARGET_JACK;
+  else if (text == "usb") target = SCHEDULE_TARGET_USB;
+  else if (text == "pd") target = SCHEDULE_TARGET_PD;
+  else return false;
+  return true;
+}
+
+const char *scheduleTargetName(uint8_t target) {
+  switch (target) {
+    case SCHEDULE_TARGET_JACK: return "jack";
+    case SCHEDULE_TARGET_USB: return "usb";
+    case SCHEDULE_TARGET_PD: return "pd";
+    default: return "both";
+  }
+}
@@ -5,4 +5,59 @@
 
 void checkSchedules();
 
+// Rebuild the next-fire index on the next check. Call after editing
+// config.schedules, changing the timezone or setting the clock.
+void invalidateSchedules();
+
+// UTC epoch of the next scheduled event, 0 if none
+time_t nextScheduleTime();
+
+// Output state implied by the schedule table at a given time. Each *At field
+// is the epoch of the event that set it, 0 if no event in the past week.
+struct ScheduleState {
+  time_t jackAt;
+  time_t usbAt;
+  time_t pdAt;
+  bool jack;
+  bool usb;
+  uint8_t pdVoltage;
+};
+void scheduleStateAt(time_t t, ScheduleState &state);
+
+// Apply the events missed while the clock moved from `from` to `to` (a
+// reboot, an NTP correction). Only targets with an event inside the window
+// are touched, so manual changes since the last event are kept. Returns the
+// number of outputs changed.
+int catchUpSchedules(time_t from, time_t to);
+
+// Fast-forward a copy of the schedule table over `days` of virtual time,
+// checking every `stepSec` (1-60) seconds like the clock tick does, with
+// the same index code as checkSchedules(). Actions go to virtual outputs,
+// not the hardware. The fired sequence is compared against a naive scan of
+// every entry at every minute. Runs on the calling task, not the control
+// task; a year takes seconds.
+struct ScheduleSimResult {
+  uint32_t checks;        // Clock steps evaluated
+  uint32_t fired;         // Entries executed by the indexed scheduler
+  uint32_t expected;      // Entries the naive scan says should execute
+  bool match;             // Same entries, same minutes, same order
+  uint32_t jackChanges;   // Virtual output transitions
+  uint32_t usbChanges;
+  uint32_t pdChanges;
+  int64_t elapsedUs;      // Time spent stepping the index
+};
+bool simulateSchedules(uint16_t days, uint8_t stepSec, ScheduleSimResult &result);
+
+// Schedule table edits; these persist the table and re-index it
+bool addSchedule(const Schedule &s);
+bool removeSchedule(int index);
+void clearSchedules();
+
+// Parsing and formatting shared by the serial and web interfaces
+bool isValidPDVoltage(uint8_t voltage);
+bool parseScheduleDays(String text, uint8_t &days);     // daily, weekdays, weekends, mon,wed,...
+void formatScheduleDays(uint8_t days, char *buf, size_t len);
+bool parseScheduleTarget(String text, uint8_t &target); // both, jack, usb, pd
+const char *scheduleTargetName(uint8_t target);
+
 #endif
@@ -2,6 +2,19 @@
 #include "hardware.h"
 #include "app_network.h"
 #include "storage.h"
+#include "scheduler.h"
+#include "timers.h"
+#include "journal.h"
+#include "event_loop.h"
+#include "control.h"
+#include "buttons.h"
+#include "perf.h"
+#include "power.h"
+#include "adc_sampler.h"
+#include "telemetry.h"
+#include "protection.h"
+#include "app_webserver.h"
+#include <esp_timer.h>
 #include <WiFi.h>
 
 void printHelp() {
@@ -23,15 +36,32 @@ void printHelp() {
   Serial.println(F("/usb_on - Enable USB output"));
   Serial.println(F("/usb_off - Disable USB output"));
   Serial.println(F("/pd <voltage> - Set PD voltage (5, 9, 12, 15, or 20)"));
-  Serial.println(F("/vbus - Read VBUS voltage"));
-  Serial.println(F("/vout - Read VOUT voltage"));
+  Serial.println(F("/vbus - Read VBUS voltage (mV)"));
+  Serial.println(F("/vout - Read VOUT voltage (mV)"));
+  Serial.println(F("/protect [clear | <jack|usb> <minMv> <maxMv>] - Voltage limits per output (0 = off)"));
   Serial.println(F("\n--- Scheduling ---"));
-  Serial.println(F("/do_at <HHMM> <on|off> - Add scheduled action (24hr format)"));
-  Serial.println(F("  Example: /do_at 2315 on"));
+  Serial.println(F("/do_at <HHMM> <action> [target] [days] - Add scheduled action (24hr format)"));
+  Serial.println(F("  action: on, off, or a PD voltage (5, 9, 12, 15, 20)"));
+  Serial.println(F("  target: both (default), jack, usb"));
+  Serial.println(F("  days: daily (default), weekdays, weekends, or e.g. mon,wed,fri"));
+  Serial.println(F("  Examples: /do_at 2315 on, /do_at 0700 off usb weekdays, /do_at 1800 12"));
   Serial.println(F("/do_list - List all scheduled actions"));
   Serial.println(F("/do_remove_at <index> - Remove schedule at index (use -1 for all)"));
+  Serial.println(F("/sim [days] [step] - Fast-forward the schedules (default 365 days, 1s steps)"));
+  Serial.println(F("  Outputs are simulated; the result is checked against a full scan"));
+  Serial.println(F("\n--- Timers ---"));
+  Serial.println(F("/timer <target> <on|off|toggle> <delay> [repeat] - Switch an output after a delay"));
+  Serial.println(F("  target: both, jack, usb; delay: 90, 1.5, 500ms, 90s, 15m, 2h (bare = seconds)"));
+  Serial.println(F("  Examples: /timer usb off 15m, /timer jack toggle 2s repeat"));
+  Serial.println(F("/cycle <target> <duration> - Power-cycle: off now, back on after duration"));
+  Serial.println(F("/timers - List active timers"));
+  Serial.println(F("/timer_cancel <id> - Cancel a timer (use 'all' for every timer)"));
   Serial.println(F("\n--- Status ---"));
   Serial.println(F("/status - Show system status"));
+  Serial.println(F("/power <on|off> - Light sleep between events (saves power, adds latency)"));
+  Serial.println(F("/bench - Voltage path float vs integer, status JSON, request parsing"));
+  Serial.println(F("/perf [reset] - Time spent per loop stage (count, rate, avg/p50/p99/max)"));
+  Serial.println(F("/storm [seconds] - Control latency while local clients flood the web server (default 10s)"));
   Serial.println(F("\n--- Web Interface ---"));
   Serial.print(F("Access the web UI at: http://"));
   Serial.println(WiFi.localIP());
@@ -61,11 +91,15 @@ void handleWiFiCmd(String args) {
     return;
   }
   
-  ssid.toCharArray(config.ssid, 64);
-  password.toCharArray(config.password, 64);
-  saveConfig();
+  String credentials[2] = { ssid, password };
+  runOnControl([](void *arg) {
+    String *c = (String *)arg;
+    c[0].toCharArray(config.ssid, 64);
+    c[1].toCharArray(config.password, 64);
+    saveConfig();
+  }, credentials);
   
-  Serial.println(F("WiFi credentials saved. Connecting..."));
+  Serial.println(F("WiFi credentials saved."));
   connectWiFi();
 }
 
@@ -78,8 +112,11 @@ void handleTimezoneCmd(String args) {
     return;
   }
   
-  args.toCharArray(config.timezone, 8);
-  saveConfig();
+  runOnControl([](void *arg) {
+    ((String *)arg)->toCharArray(config.timezone, 8);
+    saveConfig();
+    invalidateSchedules();
+  }, &args);
   
   Serial.print(F("Timezone set to: "));
   Serial.println(config.timezone);
@@ -89,50 +126,105 @@ void handleTimezoneCmd(String args) {
   }
 }
 
+// Print "HH:MM <target> <days> -> <action>" for one schedule
+void printSchedule(const Schedule &s) {
+  uint8_t hours = s.time / 100;
+  uint8_t mins = s.time % 100;
+  
+  if (hours < 10) Serial.print('0');
+  Serial.print(hours);
+  Serial.print(':');
+  if (mins < 10) Serial.print('0');
+  Serial.print(mins);
+  
+  char days[32];
+  formatScheduleDays(s.days, days, sizeof(days));
+  Serial.print(' ');
+  Serial.print(scheduleTargetName(s.target));
+  Serial.print(' ');
+  Serial.print(days);
+  
+  Serial.print(F(" -> "));
+  if (s.target == SCHEDULE_TARGET_PD) {
+    Serial.print(s.action);
+    Serial.println(F("V"));
+  } else {
+    Serial.println(s.action ? F("ON") : F("OFF"));
+  }
+}
+
 void handleDoAtCmd(String args) {
-  int spaceIdx = args.indexOf(' ');
-  if (spaceIdx == -1) {
-    Serial.println(F("ERR: Usage: /do_at <HHMM> <on|off>"));
-    return;
+  // Split into up to four space-separated words
+  String words[4];
+  int count = 0;
+  args.trim();
+  while (args.length() > 0 && count < 4) {
+    int spaceIdx = args.indexOf(' ');
+    words[count++] = (spaceIdx == -1) ? args : args.substring(0, spaceIdx);
+    args = (spaceIdx == -1) ? "" : args.substring(spaceIdx + 1);
+    args.trim();
   }
   
-  String timeStr = args.substring(0, spaceIdx);
-  String actionStr = args.substring(spaceIdx + 1);
-  
-  timeStr.trim();
-  actionStr.trim();
-  actionStr.toLowerCase();
+  if (count < 2 || args.length() > 0) {
+    Serial.println(F("ERR: Usage: /do_at <HHMM> <on|off|5|9|12|15|20> [both|jack|usb] [days]"));
+    return;
+  }
   
-  uint16_t schedTime = timeStr.toInt();
-  if (schedTime > 2359 || (schedTime % 100) > 59) {
+  Schedule sched;
+  sched.time = words[0].toInt();
+  if (sched.time > 2359 || (sched.time % 100) > 59) {
     Serial.println(F("ERR: Invalid time format. Use HHMM (0000-2359)."));
     return;
   }
   
-  uint8_t action;
+  String actionStr = words[1];
+  actionStr.toLowerCase();
+  sched.target = SCHEDULE_TARGET_BOTH;
   if (actionStr == "on" || actionStr == "1") {
-    action = 1;
+    sched.action = 1;
   } else if (actionStr == "off" || actionStr == "0") {
-    action = 0;
+    sched.action = 0;
+  } else if (isValidPDVoltage(actionStr.toInt())) {
+    sched.action = actionStr.toInt();
+    sched.target = SCHEDULE_TARGET_PD;
   } else {
-    Serial.println(F("ERR: Action must be 'on' or 'off'."));
+    Serial.println(F("ERR: Action must be 'on', 'off' or a PD voltage (5, 9, 12, 15, 20)."));
     return;
   }
   
-  if (config.scheduleCount >= 10) {
-    Serial.println(F("ERR: Schedule list full (max 10 entries)."));
+  // Optional target, then optional days
+  int next = 2;
+  uint8_t target;
+  if (next < count && parseScheduleTarget(words[next], target)) {
+    if ((target == SCHEDULE_TARGET_PD) != (sched.target == SCHEDULE_TARGET_PD)) {
+      Serial.println(F("ERR: PD schedules take a voltage, outputs take on/off."));
+      return;
+    }
+    sched.target = target;
+    next++;
+  }
+  sched.days = SCHEDULE_DAYS_ALL;
+  if (next < count) {
+    if (!parseScheduleDays(words[next], sched.days)) {
+      Serial.println(F("ERR: Days must be daily, weekdays, weekends or e.g. mon,wed,fri."));
+      return;
+    }
+    next++;
+  }
+  if (next < count) {
+    Serial.println(F("ERR: Usage: /do_at <HHMM> <on|off|5|9|12|15|20> [both|jack|usb] [days]"));
     return;
   }
   
-  config.schedules[config.scheduleCount].time = schedTime;
-  config.schedules[config.scheduleCount].action = action;
-  config.scheduleCount++;
-  saveConfig();
+  if (!addSchedule(sched)) {
+    Serial.print(F("ERR: Schedule list full (max "));
+    Serial.print(MAX_SCHEDULES);
+    Serial.println(F(" entries)."));
+    return;
+  }
   
   Serial.print(F("Schedule added: "));
-  Serial.print(schedTime);
-  Serial.print(F(" -> "));
-  Serial.println(action ? F("ON") : F("OFF"));
+  printSchedule(sched);
 }
 
 void handleDoListCmd() {
@@ -143,19 +235,7 @@ void handleDoListCmd() {
     for (int i = 0; i < config.scheduleCount; i++) {
       Serial.print(i);
       Serial.print(F(": "));
-      
-      uint16_t t = config.schedules[i].time;
-      uint8_t hours = t / 100;
-      uint8_t mins = t % 100;
-      
-      if (hours < 10) Serial.print('0');
-      Serial.print(hours);
-      Serial.print(':');
-      if (mins < 10) Serial.print('0');
-      Serial.print(mins);
-      
-      Serial.print(F(" -> "));
-      Serial.println(config.schedules[i].action ? F("ON") : F("OFF"));
+      printSchedule(config.schedules[i]);
     }
   }
   Serial.println(F("-------------------------\n"));
@@ -166,28 +246,54 @@ void handleDoRemoveAtCmd(String args) {
   int index = args.toInt();
   
   if (index == -1) {
-    config.scheduleCount = 0;
-    saveConfig();
+    clearSchedules();
     Serial.println(F("All schedules cleared."));
     return;
   }
   
-  if (index < 0 || index >= config.scheduleCount) {
+  if (!removeSchedule(index)) {
     Serial.println(F("ERR: Invalid schedule index."));
     return;
   }
   
-  for (int i = index; i < config.scheduleCount - 1; i++) {
-    config.schedules[i] = config.schedules[i + 1];
-  }
-  config.scheduleCount--;
-  saveConfig();
-  
   Serial.print(F("Schedule "));
   Serial.print(index);
   Serial.println(F(" removed."));
 }
 
+void printProtection() {
+  const ProtectStats &ps = getProtectStats();
+  for (uint8_t i = 0; i < PROTECT_OUTPUT_COUNT; i++) {
+    const ProtectOutputStats &s = ps.outputs[i];
+    const OutputLimits &l = config.outputLimits[i];
+    Serial.print(F("Protection "));
+    Serial.print(protectOutputName((ProtectOutput)i));
+    Serial.print(F(": "));
+    Serial.print(l.minMv);
+    Serial.print(F("-"));
+    Serial.print(l.maxMv);
+    Serial.print(F("mV, "));
+    if (s.latched == PROTECT_FAULT_NONE) {
+      Serial.print(F("armed"));
+    } else {
+      Serial.print(protectFaultName(s.latched));
+      Serial.print(F(" LATCHED at "));
+      Serial.print(s.railMv);
+      Serial.print(F("mV"));
+    }
+    Serial.print(F(" ("));
+    Serial.print(s.ovpTrips);
+    Serial.print(F(" ovp, "));
+    Serial.print(s.uvpTrips);
+    Serial.println(F(" uvp)"));
+  }
+  Serial.print(F("Protection reaction max: "));
+  Serial.print(ps.maxReactionUs);
+  Serial.print(F("us after the frame, +"));
+  Serial.print(PROTECT_PD_MARGIN);
+  Serial.println(F("% over the PD setting always trips"));
+}
+
 void handleStatusCmd() {
   Serial.println(F("\n========== SYSTEM STATUS =========="));
   
@@ -197,16 +303,34 @@ void handleStatusCmd() {
   Serial.print(F("USB Output: "));
   Serial.println(usbOutputState ? F("ENABLED") : F("DISABLED"));
   
-  float vbus = getVBusVoltage();
+  char volts[12];
+  formatVolts(volts, getVBusMillivolts());
   Serial.print(F("VBUS Voltage: "));
-  Serial.print(vbus, 2);
+  Serial.print(volts);
   Serial.println(F("V"));
   
-  float vout = getVOutVoltage();
+  formatVolts(volts, getVOutMillivolts());
   Serial.print(F("VOUT Voltage: "));
-  Serial.print(vout, 2);
+  Serial.print(volts);
   Serial.println(F("V"));
   
+  const AdcStats& as = getAdcStats();
+  Serial.print(F("ADC: "));
+  Serial.print(as.frames);
+  Serial.print(F(" frames, last unfiltered VBUS "));
+  Serial.print(getAdcRawMillivolts(ADC_VBUS));
+  Serial.print(F("mV, VOUT "));
+  Serial.print(getAdcRawMillivolts(ADC_VOUT));
+  Serial.println(F("mV"));
+  uint32_t first, last;
+  Serial.print(F("History: "));
+  Serial.print(telemetryRange(TELEMETRY_FINE, first, last) ? last - first + 1 : 0);
+  Serial.print(F("s fine, "));
+  Serial.print(telemetryRange(TELEMETRY_COARSE, first, last) ? last - first + 1 : 0);
+  Serial.print(F(" coarse periods, "));
+  Serial.print(telemetryMemoryBytes());
+  Serial.println(F(" bytes"));
+  
   Serial.print(F("WiFi SSID: "));
   if (strlen(config.ssid) > 0) {
     Serial.println(config.ssid);
@@ -220,8 +344,17 @@ void handleStatusCmd() {
     Serial.print(WiFi.localIP());
     Serial.println(F(")"));
   } else {
-    Serial.println(F("Disconnected"));
+    Serial.print(F("Disconnected ("));
+    Serial.print(wifiStateName(getWiFiState()));
+    if (getWiFiState() == WIFI_STATE_BACKOFF) {
+      Serial.print(F(", retry in "));
+      Serial.print(wifiRetryIn() / 1000);
+      Serial.print(F("s"));
+    }
+    Serial.println(F(")"));
   }
+  Serial.print(F("WiFi Attempts: "));
+  Serial.println(wifiAttempts());
   
   Serial.print(F("Timezone: "));
   Serial.println(config.timezone);
@@ -238,18 +371,431 @@ void handleStatusCmd() {
   
   Serial.print(F("PD Voltage Setting: "));
   Serial.print(config.pdVoltage);
-  Serial.println(F("V"));
+  const PDStatus &pd = getPDStatus();
+  Serial.print(F("V ("));
+  Serial.print(pdStateName(pd.state));
+  if (pd.state == PD_OK || pd.state == PD_FAILED) {
+    Serial.print(F(" after "));
+    Serial.print(pd.settleMs);
+    Serial.print(F("ms"));
+  }
+  Serial.print(F(", "));
+  Serial.print(pd.failures);
+  Serial.println(F(" failures)"));
   
   Serial.print(F("Scheduled Actions: "));
   Serial.print(config.scheduleCount);
+  Serial.print('/');
+  Serial.print(MAX_SCHEDULES);
   Serial.println(F(" configured"));
   
+  Serial.print(F("Active Timers: "));
+  Serial.println(getTimerCount());
+  
+  const StorageStats& st = getStorageStats();
+  Serial.print(F("Flash Commits: "));
+  Serial.print(st.commits);
+  Serial.print(F(" ("));
+  Serial.print(st.bytesWritten);
+  Serial.print(F(" bytes written, "));
+  Serial.print(st.bytesChanged);
+  Serial.print(F(" changed, "));
+  Serial.print(st.skippedSaves);
+  Serial.println(F(" saves skipped)"));
+  
+  const JournalStats& js = getJournalStats();
+  Serial.print(F("Journal: "));
+  Serial.print(js.appends);
+  Serial.print(F(" appends, "));
+  Serial.print(js.erases);
+  Serial.print(F(" erases, sector "));
+  Serial.print(js.sector);
+  Serial.print('/');
+  Serial.println(js.sectorCount);
+  
+  const EventLoopStats& es = getEventLoopStats();
+  uint64_t upUs = esp_timer_get_time() - es.startUs;
+  Serial.print(F("Event loop: "));
+  Serial.print(es.dispatched);
+  Serial.print(F(" events, "));
+  Serial.print(es.wakeups);
+  Serial.print(F(" wakeups, idle "));
+  Serial.print(upUs > 0 ? (double)es.sleptUs * 100.0 / upUs : 0.0, 1);
+  Serial.println(F("%"));
+  Serial.print(F("Control latency: avg "));
+  Serial.print(es.triggered > 0 ? (unsigned long)(es.sumLatencyUs / es.triggered) : 0UL);
+  Serial.print(F("us, max "));
+  Serial.print(es.maxLatencyUs);
+  Serial.print(F("us over "));
+  Serial.print(es.triggered);
+  Serial.println(F(" button/command wakeups"));
+  
+  printProtection();
+  
+  Serial.print(F("Heap: "));
+  Serial.print(ESP.getFreeHeap());
+  Serial.print(F(" free, "));
+  Serial.print(ESP.getMinFreeHeap());
+  Serial.print(F(" min since boot, largest block "));
+  Serial.println(ESP.getMaxAllocHeap());
+  
+  const PowerStats& ps = getPowerStats();
+  Serial.print(F("Power: "));
+  if (!config.lowPower) {
+    Serial.println(F("always awake"));
+  } else if (!ps.lightSleep) {
+    Serial.println(F("modem sleep only (no light sleep in this build)"));
+  } else if (!ps.sleepTracked) {
+    Serial.println(F("light sleep (time asleep not tracked in this build)"));
+  } else {
+    uint64_t spanUs = esp_timer_get_time() - ps.startUs;
+    double asleep = spanUs > 0 ? (double)ps.sleptUs * 100.0 / spanUs : 0.0;
+    Serial.print(F("light sleep, asleep "));
+    Serial.print(asleep, 1);
+    Serial.print(F("%, awake "));
+    Serial.print(100.0 - asleep, 1);
+    Serial.print(F("% ("));
+    Serial.print(ps.sleeps);
+    Serial.println(F(" sleeps)"));
+  }
+  
+  const ButtonStats& bs = getButtonStats();
+  Serial.print(F("Buttons: "));
+  Serial.print(bs.gestures);
+  Serial.print(F(" actions from "));
+  Serial.print(bs.edges);
+  Serial.print(F(" edges ("));
+  Serial.print(bs.overflows);
+  Serial.print(F(" dropped), latency avg "));
+  Serial.print(bs.gestures > 0 ? (unsigned long)(bs.sumLatencyUs / bs.gestures) : 0UL);
+  Serial.print(F("us, max "));
+  Serial.print(bs.maxLatencyUs);
+  Serial.println(F("us"));
+  
   Serial.println(F("===================================\n"));
 }
 
+void handleSimCmd(String args) {
+  int spaceIdx = args.indexOf(' ');
+  uint16_t days = 365;
+  uint8_t step = 1;
+  if (args.length() > 0) days = args.toInt();
+  if (spaceIdx != -1) step = args.substring(spaceIdx + 1).toInt();
+  
+  Serial.print(F("Simulating "));
+  Serial.print(days);
+  Serial.print(F(" days of "));
+  Serial.print(config.scheduleCount);
+  Serial.print(F(" schedules in "));
+  Serial.print(step);
+  Serial.println(F("s steps..."));
+  
+  ScheduleSimResult r;
+  if (!simulateSchedules(days, step, r)) {
+    Serial.println(F("ERR: Usage: /sim [days 1-65535] [step 1-60]"));
+    return;
+  }
+  
+  Serial.print(F("Checks: "));
+  Serial.print(r.checks);
+  Serial.print(F(" in "));
+  Serial.print((unsigned long)(r.elapsedUs / 1000));
+  Serial.print(F("ms ("));
+  Serial.print(r.elapsedUs > 0 ? (unsigned long)((uint64_t)r.checks * 1000000 / r.elapsedUs) : 0UL);
+  Serial.println(F(" checks/s)"));
+  Serial.print(F("Executed: "));
+  Serial.print(r.fired);
+  Serial.print(F(", expected: "));
+  Serial.print(r.expected);
+  Serial.println(r.match ? F(" - PASS") : F(" - FAIL (sequence differs)"));
+  Serial.print(F("Transitions: jack "));
+  Serial.print(r.jackChanges);
+  Serial.print(F(", usb "));
+  Serial.print(r.usbChanges);
+  Serial.print(F(", pd "));
+  Serial.println(r.pdChanges);
+}
+
+void handleTimerCmd(String args) {
+  String words[4];
+  int count = 0;
+  args.trim();
+  while (args.length() > 0 && count < 4) {
+    int spaceIdx = args.indexOf(' ');
+    words[count++] = (spaceIdx == -1) ? args : args.substring(0, spaceIdx);
+    args = (spaceIdx == -1) ? "" : args.substring(spaceIdx + 1);
+    args.trim();
+  }
+  
+  uint8_t target, action;
+  uint32_t delayMs;
+  bool repeat = count == 4 && words[3].equalsIgnoreCase("repeat");
+  if (count < 3 || (count == 4 && !repeat) || args.length() > 0 ||
+      !parseScheduleTarget(words[0], target) || target == SCHEDULE_TARGET_PD ||
+      !parseTimerAction(words[1], action) || !parseDuration(words[2], delayMs)) {
+    Serial.println(F("ERR: Usage: /timer <both|jack|usb> <on|off|toggle> <delay> [repeat]"));
+    return;
+  }
+  
+  int id = addTimer(target, action, delayMs, repeat ? delayMs : 0);
+  if (id < 0) {
+    if (repeat && delayMs < TIMER_MIN_PERIOD) {
+      Serial.print(F("ERR: Repeating timers need a period of at least "));
+      Serial.print(TIMER_MIN_PERIOD);
+      Serial.println(F("ms."));
+    } else {
+      Serial.println(F("ERR: Timer table full."));
+    }
+    return;
+  }
+  Serial.print(F("Timer #"));
+  Serial.print(id);
+  Serial.print(F(" set: "));
+  Serial.print(scheduleTargetName(target));
+  Serial.print(F(" "));
+  Serial.print(timerActionName(action));
+  Serial.print(repeat ? F(" every ") : F(" in "));
+  Serial.print(delayMs);
+  Serial.println(F("ms"));
+}
+
+void handleCycleCmd(String args) {
+  int spaceIdx = args.indexOf(' ');
+  uint8_t target;
+  uint32_t offMs;
+  if (spaceIdx == -1 || !parseScheduleTarget(args.substring(0, spaceIdx), target) ||
+      target == SCHEDULE_TARGET_PD || !parseDuration(args.substring(spaceIdx + 1), offMs)) {
+    Serial.println(F("ERR: Usage: /cycle <both|jack|usb> <duration>"));
+    return;
+  }
+  
+  int id = startPowerCycle(target, offMs);
+  if (id < 0) {
+    Serial.println(F("ERR: Timer table full."));
+    return;
+  }
+  Serial.print(F("Power-cycling "));
+  Serial.print(scheduleTargetName(target));
+  Serial.print(F(", back on in "));
+  Serial.print(offMs);
+  Serial.print(F("ms (timer #"));
+  Serial.print(id);
+  Serial.println(F(")"));
+}
+
+void handleTimersCmd() {
+  Serial.println(F("\n--- Active Timers ---"));
+  OutputTimer timers[TIMER_MAX];
+  uint8_t count = copyTimers(timers);
+  if (count == 0) {
+    Serial.println(F("No active timers."));
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    const OutputTimer &t = timers[i];
+    Serial.print(F("#"));
+    Serial.print(t.id);
+    Serial.print(F(": "));
+    Serial.print(scheduleTargetName(t.target));
+    Serial.print(F(" "));
+    Serial.print(timerActionName(t.action));
+    Serial.print(F(" in "));
+    Serial.print(timerRemaining(t));
+    Serial.print(F("ms"));
+    if (t.periodMs > 0) {
+      Serial.print(F(", repeats every "));
+      Serial.print(t.periodMs);
+      Serial.print(F("ms"));
+    }
+    Serial.println();
+  }
+  Serial.println(F("---------------------\n"));
+}
+
+void handleTimerCancelCmd(String args) {
+  if (args.equalsIgnoreCase("all")) {
+    cancelAllTimers();
+    Serial.println(F("All timers cancelled."));
+  } else if (cancelTimer(args.toInt())) {
+    Serial.print(F("Timer #"));
+    Serial.print(args.toInt());
+    Serial.println(F(" cancelled."));
+  } else {
+    Serial.println(F("ERR: No such timer."));
+  }
+}
+
+void handlePerfCmd(String args) {
+  if (args == "reset") {
+    perfReset();
+    Serial.println(F("Stage timings cleared."));
+    return;
+  }
+  if (!PERF_ENABLED) {
+    Serial.println(F("Stage timing is compiled out (PERF_ENABLED 0)."));
+    return;
+  }
+  
+  uint32_t windowMs = perfWindowMs();
+  Serial.print(F("\n=== Stage timing: last "));
+  Serial.print(windowMs / 1000);
+  Serial.print(F("s at "));
+  Serial.print(getCpuFrequencyMhz());
+  Serial.println(F("MHz ==="));
+  Serial.println(F("stage            count   rate/s   avg us   p50 us   p99 us   max us"));
+  char line[80];
+  for (uint8_t i = 0; i < PERF_STAGE_COUNT; i++) {
+    const PerfStats &s = getPerfStats(i);
+    snprintf(line, sizeof(line), "%-13s %8lu %8lu %8lu %8lu %8lu %8lu", perfStageName(i),
+             (unsigned long)s.count,
+             windowMs > 0 ? (unsigned long)((uint64_t)s.count * 1000 / windowMs) : 0UL,
+             s.count > 0 ? (unsigned long)perfCyclesToUs(s.totalCycles / s.count) : 0UL,
+             (unsigned long)perfCyclesToUs(perfPercentileCycles(s, 50)),
+             (unsigned long)perfCyclesToUs(perfPercentileCycles(s, 99)),
+             (unsigned long)perfCyclesToUs(s.maxCycles));
+    Serial.println(line);
+  }
+  Serial.println(F("Percentiles are log2 bucket bounds. /perf reset clears.\n"));
+}
+
+void handleProtectCmd(String args) {
+  args.trim();
+  args.toLowerCase();
+  if (args.length() == 0) {
+    printProtection();
+    return;
+  }
+  if (args == "clear") {
+    clearProtectionFaults();
+    return;
+  }
+  
+  int space1 = args.indexOf(' ');
+  int space2 = args.indexOf(' ', space1 + 1);
+  String name = args.substring(0, space1);
+  ProtectOutput output;
+  if (name == "jack") output = PROTECT_JACK;
+  else if (name == "usb") output = PROTECT_USB;
+  else space1 = -1;
+  long minMv = args.substring(space1 + 1, space2).toInt();
+  long maxMv = args.substring(space2 + 1).toInt();
+  if (space1 < 0 || space2 < 0 || minMv < 0 || maxMv < 0 || minMv > 30000 || maxMv > 30000 ||
+      (maxMv > 0 && minMv >= maxMv)) {
+    Serial.println(F("Usage: /protect [clear | <jack|usb> <minMv> <maxMv>]"));
+    Serial.println(F("  e.g. /protect jack 8500 9900 (0 disables a limit)"));
+    return;
+  }
+  setProtectionLimits(output, minMv, maxMv);
+  printProtection();
+}
+
+void handlePowerCmd(String args) {
+  args.toLowerCase();
+  if (args != "on" && args != "off") {
+    Serial.print(F("Low-power mode is "));
+    Serial.println(config.lowPower ? F("ON") : F("OFF"));
+    Serial.println(F("Usage: /power <on|off>"));
+    return;
+  }
+  setLowPowerMode(args == "on");
+}
+
+void handleBenchCmd() {
+  Serial.println(F("Timing the voltage path, 1000 rounds each..."));
+  VoltageBench r;
+  benchVoltagePath(r);
+  
+  Serial.println(F("cycles/op        float   integer"));
+  char line[80];
+  snprintf(line, sizeof(line), "conversion    %8lu  %8lu", (unsigned long)r.floatConvert, (unsigned long)r.intConvert);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "format        %8lu  %8lu", (unsigned long)r.floatFormat, (unsigned long)r.intFormat);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "status JSON   %8lu  %8lu", (unsigned long)r.floatStatus, (unsigned long)r.intStatus);
+  Serial.println(line);
+  Serial.print(F("At "));
+  Serial.print(getCpuFrequencyMhz());
+  Serial.println(F("MHz; float is the old raw-count path (soft-float)."));
+  
+  Serial.println(F("\nBuilding the /api/status body, 100 rounds each..."));
+  JsonBench j;
+  benchStatusJson(j);
+  Serial.println(F("per body         String  JsonWriter"));
+  snprintf(line, sizeof(line), "time (us)     %8lu  %8lu",
+           (unsigned long)perfCyclesToUs(j.stringCycles), (unsigned long)perfCyclesToUs(j.writerCycles));
+  Serial.println(line);
+  snprintf(line, sizeof(line), "heap blocks   %8ld  %8ld", (long)j.stringBlocks, (long)j.writerBlocks);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "heap bytes    %8ld  %8ld", (long)j.stringBytes, (long)j.writerBytes);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "run heap lost %8ld  %8ld", (long)j.stringLost, (long)j.writerLost);
+  Serial.println(line);
+  Serial.print(j.length);
+  Serial.print(F(" bytes of JSON. Heap free "));
+  Serial.print(ESP.getFreeHeap());
+  Serial.print(F(", min "));
+  Serial.print(ESP.getMinFreeHeap());
+  Serial.print(F(", largest block "));
+  Serial.println(ESP.getMaxAllocHeap());
+  
+  Serial.println(F("\nReading request bodies with JsonReader..."));
+  ParseBench p;
+  benchRequestParsing(p);
+  Serial.print(F("Schedule body ("));
+  Serial.print(p.bodyLength);
+  Serial.print(F(" bytes): "));
+  Serial.print(p.readerCycles);
+  Serial.print(F(" cycles ("));
+  Serial.print(perfCyclesToUs(p.readerCycles));
+  Serial.println(F("us) per parse"));
+  snprintf(line, sizeof(line), "Body corpus: %u/%u pass, old scans wrong on %u",
+           p.corpusPassed, p.corpusCases, p.legacyWrong);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "Fuzz: %lu edits, %lu accepted, %lu at 20V/on, %lu wrong%s",
+           (unsigned long)p.mutants, (unsigned long)p.accepted, (unsigned long)p.reached,
+           (unsigned long)p.wrong,
+           p.wrong == 0 && p.reached > 0 && p.corpusPassed == p.corpusCases ? "" : "  FAIL");
+  Serial.println(line);
+}
+
+void handleStormCmd(String args) {
+  long seconds = args.length() > 0 ? args.toInt() : 10;
+  if (seconds < 1 || seconds > 300) {
+    Serial.println(F("Usage: /storm [seconds 1-300]"));
+    return;
+  }
+  Serial.print(F("Flooding the web server for "));
+  Serial.print(seconds);
+  Serial.print(F("s from "));
+  Serial.print(STORM_CLIENTS);
+  Serial.println(F(" local clients..."));
+  
+  StormBench r;
+  if (!benchRequestStorm(r, seconds)) {
+    Serial.println(F("ERR: Web server not running (needs WiFi)."));
+    return;
+  }
+  
+  char line[96];
+  snprintf(line, sizeof(line), "Control round trip, idle:  avg %5lu us, max %6lu us (%lu probes)",
+           (unsigned long)r.idleAvgUs, (unsigned long)r.idleMaxUs, (unsigned long)r.idleProbes);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "Control round trip, flood: avg %5lu us, max %6lu us (%lu probes)",
+           (unsigned long)r.avgUs, (unsigned long)r.maxUs, (unsigned long)r.probes);
+  Serial.println(line);
+  snprintf(line, sizeof(line), "Requests: %lu answered (%lu/s), %lu failed",
+           (unsigned long)r.requests, (unsigned long)(r.requests / seconds), (unsigned long)r.failures);
+  Serial.println(line);
+  bool pass = r.requests > 0 && r.maxUs <= STORM_LATENCY_BUDGET;
+  Serial.print(pass ? F("PASS") : F("FAIL"));
+  Serial.print(F(": budget "));
+  Serial.print(STORM_LATENCY_BUDGET);
+  Serial.println(r.requests > 0 ? F(" us") : F(" us, but no request was answered"));
+}
+
 void handleSerialCommand() {
   if (!Serial.available()) return;
   
+  PERF_SCOPE(PERF_SERIAL);
   String line = Serial.readStringUntil('\n');
   line.trim();
   if (line.length() == 0) return;
@@ -279,23 +825,41 @@ void handleSerialCommand() {
     uint8_t voltage = args.toInt();
     setPDVoltage(voltage);
   } else if (cmd == "/vbus") {
-    float vbus = getVBusVoltage();
     Serial.print(F("VBUS Voltage: "));
-    Serial.print(vbus, 2);
-    Serial.println(F("V"));
+    Serial.print(getVBusMillivolts());
+    Serial.println(F("mV"));
   } else if (cmd == "/vout") {
-    float vout = getVOutVoltage();
     Serial.print(F("VOUT Voltage: "));
-    Serial.print(vout, 2);
-    Serial.println(F("V"));
+    Serial.print(getVOutMillivolts());
+    Serial.println(F("mV"));
   } else if (cmd == "/do_at") {
     handleDoAtCmd(args);
   } else if (cmd == "/do_list") {
     handleDoListCmd();
   } else if (cmd == "/do_remove_at") {
     handleDoRemoveAtCmd(args);
+  } else if (cmd == "/sim") {
+    handleSimCmd(args);
+  } else if (cmd == "/timer") {
+    handleTimerCmd(args);
+  } else if (cmd == "/cycle") {
+    handleCycleCmd(args);
+  } else if (cmd == "/timers") {
+    handleTimersCmd();
+  } else if (cmd == "/timer_cancel") {
+    handleTimerCancelCmd(args);
   } else if (cmd == "/status") {
     handleStatusCmd();
+  } else if (cmd == "/protect") {
+    handleProtectCmd(args);
+  } else if (cmd == "/power") {
+    handlePowerCmd(args);
+  } else if (cmd == "/bench") {
+    handleBenchCmd();
+  } else if (cmd == "/perf") {
+    handlePerfCmd(args);
+  } else if (cmd == "/storm") {
+    handleStormCmd(args);
   } else {
     Serial.println(F("ERR: Unknown command. Type /help for available commands."));
   }
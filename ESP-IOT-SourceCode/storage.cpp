@@ -1,94 +1,613 @@
 #include "storage.h"
+#include "control.h"
+#include "journal.h"
+#include "perf.h"
 #include <EEPROM.h>
+#include <nvs.h>
+#include <esp_system.h>
+#include <esp_rom_crc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+// Header at the start of each record slot. The CRC covers the header (with
+// crc = 0) and the payload, so a torn write in either part is rejected.
+struct RecordHeader {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t reserved;
+  uint32_t sequence;    // Incremented per record; newest valid slot wins
+  uint16_t length;      // Payload bytes following the header
+  uint16_t reserved2;
+  uint32_t crc;
+};
+static_assert(sizeof(RecordHeader) == 16, "record header must be packed");
+static_assert(sizeof(RecordHeader) + 2 + MAX_SCHEDULES * 4 <= SCHEDULE_SLOT_SIZE,
+              "schedule slot too small for MAX_SCHEDULES");
+
+// One A/B pair of record slots in an EEPROM image
+struct RecordRegion {
+  EEPROMClass *store;
+  int slotA;
+  int slotB;
+  size_t slotSize;
+  uint16_t magic;
+  uint8_t version;
+  uint8_t *persisted;   // Payload of the newest staged record
+  size_t persistedLen;
+  int activeSlot;       // Slot holding the newest record, -1 if none
+  uint32_t sequence;
+  bool pending;         // Staged but not yet committed
+};
+
+static uint8_t configPersisted[CONFIG_SLOT_SIZE - sizeof(RecordHeader)];
+static uint8_t schedulePersisted[SCHEDULE_SLOT_SIZE - sizeof(RecordHeader)];
+static uint8_t configImage[CONFIG_SLOT_SIZE - sizeof(RecordHeader)];   // Encoded on commit
+static uint8_t scratch[SCHEDULE_SLOT_SIZE];   // Encode/read buffer, largest slot
+
+static EEPROMClass scheduleStore(SCHEDULE_STORE_NAME);
+
+static RecordRegion configRegion = {
+  &EEPROM, CONFIG_SLOT_A, CONFIG_SLOT_B, CONFIG_SLOT_SIZE,
+  CONFIG_RECORD_MAGIC, CONFIG_RECORD_VERSION,
+  configPersisted, 0, -1, 0, false
+};
+static RecordRegion scheduleRegion = {
+  &scheduleStore, SCHEDULE_SLOT_A, SCHEDULE_SLOT_B, SCHEDULE_SLOT_SIZE,
+  SCHEDULE_RECORD_MAGIC, SCHEDULE_RECORD_VERSION,
+  schedulePersisted, 0, -1, 0, false
+};
+
+static bool commitPending = false;
+static uint32_t pendingBytes = 0;
+static unsigned long firstPendingAt = 0;
+static unsigned long lastChangeAt = 0;
+static StorageStats stats = {0, 0, 0, 0, 0};
+
+// ============================================================================
+// Record Encoding
+// ============================================================================
+// Within a version fields are only ever appended; a shorter payload decodes
+// with defaults for the fields it does not carry. The output states and
+// lastTime are not part of the record, they are kept in the journal.
+struct RecordCursor {
+  uint8_t *buf;
+  size_t pos;
+  size_t len;
+};
+
+static void putBytes(RecordCursor &c, const void *src, size_t n) {
+  memcpy(c.buf + c.pos, src, n);
+  c.pos += n;
+}
+
+static void putU8(RecordCursor &c, uint8_t v) {
+  putBytes(c, &v, 1);
+}
+
+static void putU16(RecordCursor &c, uint16_t v) {
+  uint8_t b[2] = { (uint8_t)(v & 0xFF), (uint8_t)(v >> 8) };
+  putBytes(c, b, 2);
+}
+
+static bool getBytes(RecordCursor &c, void *dst, size_t n) {
+  if (c.pos + n > c.len) return false;
+  memcpy(dst, c.buf + c.pos, n);
+  c.pos += n;
+  return true;
+}
+
+static bool getU8(RecordCursor &c, uint8_t &v) {
+  return getBytes(c, &v, 1);
+}
+
+static bool getU16(RecordCursor &c, uint16_t &v) {
+  uint8_t b[2];
+  if (!getBytes(c, b, 2)) return false;
+  v = (uint16_t)b[0] | ((uint16_t)b[1] << 8);
+  return true;
+}
+
+static bool getI64(RecordCursor &c, int64_t &v) {
+  uint8_t b[8];
+  if (!getBytes(c, b, 8)) return false;
+  uint64_t u = 0;
+  for (int i = 0; i < 8; i++) u |= (uint64_t)b[i] << (8 * i);
+  v = (int64_t)u;
+  return true;
+}
+
+static size_t encodeConfig(uint8_t *buf) {
+  RecordCursor c = { buf, 0, CONFIG_SLOT_SIZE - sizeof(RecordHeader) };
+  putBytes(c, config.ssid, sizeof(config.ssid));
+  putBytes(c, config.password, sizeof(config.password));
+  putBytes(c, config.timezone, sizeof(config.timezone));
+  putU8(c, config.pdVoltage);
+  putU8(c, config.lowPower ? 1 : 0);
+  for (int i = 0; i < 2; i++) {
+    putU16(c, config.outputLimits[i].minMv);
+    putU16(c, config.outputLimits[i].maxMv);
+  }
+  return c.pos;
+}
+
+// Each entry packs into 4 bytes: minute of day (11 bits) and target (2 bits),
+// weekday mask, action
+static size_t encodeSchedules(uint8_t *buf) {
+  RecordCursor c = { buf, 0, SCHEDULE_SLOT_SIZE - sizeof(RecordHeader) };
+  putU16(c, config.scheduleCount);
+  for (int i = 0; i < config.scheduleCount; i++) {
+    const Schedule &s = config.schedules[i];
+    uint16_t minute = (s.time / 100) * 60 + (s.time % 100);
+    putU16(c, minute | ((uint16_t)(s.target & 0x03) << 11));
+    putU8(c, s.days);
+    putU8(c, s.action);
+  }
+  return c.pos;
+}
+
+static void setDefaults() {
+  memset(&config, 0, sizeof(config));
+  strcpy(config.timezone, "UTC");
+  config.pdVoltage = 9;
+  config.powerJackState = false;
+  config.usbOutputState = false;
+}
+
+// Older schedules drove both outputs every day
+static void setLegacySchedule(int i, uint16_t time, uint8_t action) {
+  config.schedules[i].time = time;
+  config.schedules[i].action = action;
+  config.schedules[i].days = SCHEDULE_DAYS_ALL;
+  config.schedules[i].target = SCHEDULE_TARGET_BOTH;
+}
+
+// Version 1 records also carried lastTime and the output states, which now
+// live in the journal; versions 1 and 2 carried up to 10 schedules, which now
+// have their own record. Those fields are only read here when migrating.
+static void decodeConfig(uint8_t *buf, size_t len, uint8_t version) {
+  RecordCursor c = { buf, 0, len };
+  uint8_t v;
+  int64_t t;
+
+  getBytes(c, config.ssid, sizeof(config.ssid));
+  getBytes(c, config.password, sizeof(config.password));
+  getBytes(c, config.timezone, sizeof(config.timezone));
+  config.ssid[sizeof(config.ssid) - 1] = '\0';
+  config.password[sizeof(config.password) - 1] = '\0';
+  config.timezone[sizeof(config.timezone) - 1] = '\0';
+  if (version == 1) {
+    if (getI64(c, t)) config.lastTime = (time_t)t;
+    if (getU8(c, v)) config.pdVoltage = v;
+    if (getU8(c, v)) config.powerJackState = v == 1;
+    if (getU8(c, v)) config.usbOutputState = v == 1;
+  } else {
+    if (getU8(c, v)) config.pdVoltage = v;
+  }
+  if (version < 3 && getU8(c, v) && v <= 10) {
+    for (int i = 0; i < v; i++) {
+      uint16_t time;
+      uint8_t action;
+      if (!getU16(c, time) || !getU8(c, action)) break;
+      setLegacySchedule(i, time, action);
+      config.scheduleCount = i + 1;
+    }
+  }
+  // Trailing fields added within a version are absent from older records
+  // and keep their defaults
+  if (version >= 3 && getU8(c, v)) config.lowPower = v == 1;
+  for (int i = 0; version >= 3 && i < 2; i++) {
+    OutputLimits l;
+    if (!getU16(c, l.minMv) || !getU16(c, l.maxMv)) break;
+    config.outputLimits[i] = l;
+  }
+}
+
+static void decodeSchedules(uint8_t *buf, size_t len, uint8_t version) {
+  RecordCursor c = { buf, 0, len };
+  uint16_t count;
+
+  config.scheduleCount = 0;
+  if (!getU16(c, count) || count > MAX_SCHEDULES) return;
+  for (int i = 0; i < count; i++) {
+    uint16_t packed;
+    uint8_t days, action;
+    if (!getU16(c, packed) || !getU8(c, days) || !getU8(c, action)) break;
+    uint16_t minute = packed & 0x07FF;
+    if (minute >= 1440) continue;
+    Schedule &s = config.schedules[config.scheduleCount++];
+    s.time = (minute / 60) * 100 + (minute % 60);
+    s.target = (packed >> 11) & 0x03;
+    s.days = days & SCHEDULE_DAYS_ALL;
+    s.action = action;
+  }
+}
+
+static uint32_t recordCrc(RecordHeader hdr, const uint8_t *payload) {
+  hdr.crc = 0;
+  uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&hdr, sizeof(hdr));
+  return esp_rom_crc32_le(crc, payload, hdr.length);
+}
+
+// ============================================================================
+// Staging & Commit
+// ============================================================================
+// Copy bytes into an EEPROM buffer, skipping ones that already match.
+// Returns the number of bytes that differed.
+static uint32_t stageBytes(EEPROMClass &store, int addr, const uint8_t *data, size_t len) {
+  uint32_t changed = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (store.read(addr + i) != data[i]) {
+      store.write(addr + i, data[i]);
+      changed++;
+    }
+  }
+  return changed;
+}
+
+// Stage payload as the region's next record unless it matches the newest
+// one. Returns false when there was nothing to write.
+static bool stageRecord(RecordRegion &r, const uint8_t *payload, size_t len) {
+  if (r.activeSlot >= 0 && len == r.persistedLen &&
+      memcmp(payload, r.persisted, len) == 0) {
+    return false;
+  }
+
+  // Until the commit happens, keep rewriting the same slot so the other one
+  // still holds the last committed record.
+  int slot = r.activeSlot;
+  if (!r.pending) {
+    slot = (r.activeSlot == r.slotA) ? r.slotB : r.slotA;
+    r.sequence++;
+  }
+
+  RecordHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = r.magic;
+  hdr.version = r.version;
+  hdr.sequence = r.sequence;
+  hdr.length = len;
+  hdr.crc = recordCrc(hdr, payload);
+
+  pendingBytes += stageBytes(*r.store, slot, (const uint8_t *)&hdr, sizeof(hdr));
+  pendingBytes += stageBytes(*r.store, slot + sizeof(hdr), payload, len);
+
+  memcpy(r.persisted, payload, len);
+  r.persistedLen = len;
+  r.activeSlot = slot;
+  r.pending = true;
+  return true;
+}
+
+// saveConfig() only notes that something changed; the storage task encodes
+// and commits once the changes settle. These fields are shared with it.
+static portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
 
 void saveConfig() {
-  EEPROM.write(ADDR_MAGIC, EEPROM_MAGIC);
-  
-  // Save WiFi credentials
-  for (int i = 0; i < 64; i++) {
-    EEPROM.write(ADDR_SSID + i, config.ssid[i]);
-    EEPROM.write(ADDR_PASSWORD + i, config.password[i]);
+  portENTER_CRITICAL(&pendingMux);
+  stats.saveRequests++;
+  lastChangeAt = millis();
+  if (!commitPending) firstPendingAt = lastChangeAt;
+  commitPending = true;
+  portEXIT_CRITICAL(&pendingMux);
+  wakeStorageTask();
+}
+
+// Each store is one NVS blob and commit() rewrites all of it, so only the
+// stores with a staged record are committed
+static size_t commitRegion(RecordRegion &r) {
+  if (!r.pending) return 0;
+  r.pending = false;
+  {
+    PERF_SCOPE(PERF_FLASH_COMMIT);
+    r.store->commit();
   }
-  
-  // Save timezone
-  for (int i = 0; i < 8; i++) {
-    EEPROM.write(ADDR_TIMEZONE + i, config.timezone[i]);
-  }
-  
-  // Save last time (4 bytes)
-  EEPROM.write(ADDR_LAST_TIME + 0, (config.lastTime >> 24) & 0xFF);
-  EEPROM.write(ADDR_LAST_TIME + 1, (config.lastTime >> 16) & 0xFF);
-  EEPROM.write(ADDR_LAST_TIME + 2, (config.lastTime >> 8) & 0xFF);
-  EEPROM.write(ADDR_LAST_TIME + 3, config.lastTime & 0xFF);
-  
-  // Save PD voltage
-  EEPROM.write(ADDR_PD_VOLTAGE, config.pdVoltage);
-  
-  // Save schedule count
-  EEPROM.write(ADDR_SCHEDULE_COUNT, config.scheduleCount);
-  
-  // Save schedules
-  for (int i = 0; i < 10; i++) {
-    int addr = ADDR_SCHEDULES + (i * 3);
-    EEPROM.write(addr + 0, (config.schedules[i].time >> 8) & 0xFF);
-    EEPROM.write(addr + 1, config.schedules[i].time & 0xFF);
-    EEPROM.write(addr + 2, config.schedules[i].action);
+  stats.commits++;
+  stats.bytesWritten += r.store->length();
+  return r.store->length();
+}
+
+// The config belongs to the control task, so the records are encoded there,
+// into this task's buffers while it waits; staging and the flash commit then
+// run here without holding up the control task.
+static void commitConfig() {
+  portENTER_CRITICAL(&pendingMux);
+  bool due = commitPending;
+  commitPending = false;
+  portEXIT_CRITICAL(&pendingMux);
+  if (!due) return;
+
+  struct Encoded { size_t configLen, scheduleLen; } enc;
+  runOnControl([](void *arg) {
+    Encoded *e = (Encoded *)arg;
+    e->configLen = encodeConfig(configImage);
+    e->scheduleLen = encodeSchedules(scratch);
+  }, &enc);
+
+  bool staged = stageRecord(configRegion, configImage, enc.configLen);
+  staged |= stageRecord(scheduleRegion, scratch, enc.scheduleLen);
+  if (!staged) {
+    stats.skippedSaves++;
+    return;
   }
-  
-  // Save power states
-  EEPROM.write(ADDR_POWER_JACK_STATE, config.powerJackState ? 1 : 0);
-  EEPROM.write(ADDR_USB_OUTPUT_STATE, config.usbOutputState ? 1 : 0);
-  
-  EEPROM.commit();
-  Serial.println(F("Config saved to EEPROM."));
+
+  size_t written = commitRegion(configRegion);
+  written += commitRegion(scheduleRegion);
+  stats.bytesChanged += pendingBytes;
+
+  Serial.print(F("Config saved to EEPROM ("));
+  Serial.print(pendingBytes);
+  Serial.print(F(" of "));
+  Serial.print(written);
+  Serial.println(F(" bytes changed)."));
+  pendingBytes = 0;
 }
 
-void loadConfig() {
-  if (EEPROM.read(ADDR_MAGIC) != EEPROM_MAGIC) {
-    Serial.println(F("No valid config found. Using defaults."));
-    memset(&config, 0, sizeof(config));
-    strcpy(config.timezone, "UTC");
-    config.pdVoltage = 9;
-    config.powerJackState = false;
-    config.usbOutputState = false;
+// Ticks until the pending changes are due, portMAX_DELAY if none
+static TickType_t commitWait() {
+  portENTER_CRITICAL(&pendingMux);
+  bool pending = commitPending;
+  unsigned long now = millis();
+  unsigned long quiet = now - lastChangeAt;
+  unsigned long held = now - firstPendingAt;
+  portEXIT_CRITICAL(&pendingMux);
+  if (!pending) return portMAX_DELAY;
+  if (quiet >= CONFIG_FLUSH_QUIET || held >= CONFIG_FLUSH_MAX_DELAY) return 0;
+  unsigned long wait = CONFIG_FLUSH_QUIET - quiet;
+  if (CONFIG_FLUSH_MAX_DELAY - held < wait) wait = CONFIG_FLUSH_MAX_DELAY - held;
+  return pdMS_TO_TICKS(wait) + 1;
+}
+
+// ============================================================================
+// Storage Task
+// ============================================================================
+// Owns every flash write after boot: config commits and journal appends.
+// It runs below the network tasks and sleeps until saveConfig(),
+// journalPut() or a flush request wakes it, or the next commit is due.
+// Requests are the calling task's handle (nullptr for a plain wake-up),
+// notified once the flush is done.
+static TaskHandle_t storageTask = nullptr;
+static QueueHandle_t storageQueue = nullptr;
+
+static bool onStorageTask() {
+  return storageTask == nullptr || xTaskGetCurrentTaskHandle() == storageTask;
+}
+
+void wakeStorageTask() {
+  if (storageQueue == nullptr) return;
+  TaskHandle_t none = nullptr;
+  xQueueSend(storageQueue, &none, 0);   // Full: a wake-up is already queued
+}
+
+static void storageTaskMain(void *) {
+  TaskHandle_t waiting[STORAGE_QUEUE_LENGTH];
+  uint8_t count = 0;
+  for (;;) {
+    {
+      PERF_SCOPE(PERF_STORAGE);
+      if (count > 0 || commitWait() == 0) commitConfig();
+      journalLoop();
+    }
+    for (uint8_t i = 0; i < count; i++) xTaskNotifyGive(waiting[i]);
+    count = 0;
+
+    TaskHandle_t caller;
+    if (xQueueReceive(storageQueue, &caller, commitWait()) != pdTRUE) continue;
+    do {
+      if (caller != nullptr) waiting[count++] = caller;
+    } while (count < STORAGE_QUEUE_LENGTH && xQueueReceive(storageQueue, &caller, 0) == pdTRUE);
+  }
+}
+
+void flushConfig() {
+  if (onStorageTask()) {
+    commitConfig();
     return;
   }
-  
-  // Load WiFi credentials
+  if (onControlTask()) {
+    // Waiting here would deadlock: the commit needs the control task to
+    // encode. Make it due now instead.
+    portENTER_CRITICAL(&pendingMux);
+    firstPendingAt = millis() - CONFIG_FLUSH_MAX_DELAY;
+    portEXIT_CRITICAL(&pendingMux);
+    wakeStorageTask();
+    return;
+  }
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  xQueueSend(storageQueue, &self, portMAX_DELAY);
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+// Runs inside esp_restart() (ESP.restart()) so write-behind changes are not
+// lost on a software restart. Brownout resets skip shutdown handlers; those
+// are covered by CONFIG_FLUSH_MAX_DELAY bounding how long changes stay in RAM.
+// The restarting task waits for the storage task to commit.
+static void storageShutdownHandler() {
+  flushConfig();
+}
+
+void beginStorage() {
+  esp_register_shutdown_handler(storageShutdownHandler);
+  storageQueue = xQueueCreate(STORAGE_QUEUE_LENGTH, sizeof(TaskHandle_t));
+  xTaskCreate(storageTaskMain, "storage", STORAGE_TASK_STACK, nullptr,
+              STORAGE_TASK_PRIORITY, &storageTask);
+}
+
+void loadRuntimeState() {
+  int64_t v;
+
+  // Seed the journal from the config record on the first boot after an
+  // upgrade; afterwards the journal is authoritative.
+  if (journalGet(JOURNAL_POWER_JACK, v)) config.powerJackState = v != 0;
+  else journalPut(JOURNAL_POWER_JACK, config.powerJackState ? 1 : 0);
+
+  if (journalGet(JOURNAL_USB_OUTPUT, v)) config.usbOutputState = v != 0;
+  else journalPut(JOURNAL_USB_OUTPUT, config.usbOutputState ? 1 : 0);
+
+  if (journalGet(JOURNAL_LAST_TIME, v)) config.lastTime = (time_t)v;
+  else if (config.lastTime > 0) journalPut(JOURNAL_LAST_TIME, config.lastTime);
+}
+
+const StorageStats& getStorageStats() {
+  return stats;
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+// Read a whole slot into scratch in one go. True if it holds an intact
+// record of this region, including one from a newer firmware that this one
+// cannot decode.
+static bool readSlot(const RecordRegion &r, int addr, RecordHeader &hdr) {
+  r.store->readBytes(addr, scratch, r.slotSize);
+  memcpy(&hdr, scratch, sizeof(hdr));
+  if (hdr.magic != r.magic || hdr.version == 0) return false;
+  if (hdr.length > r.slotSize - sizeof(hdr)) return false;
+  return recordCrc(hdr, scratch + sizeof(hdr)) == hdr.crc;
+}
+
+// Sequence comparison is wrap-safe
+static bool newerRecord(const RecordHeader &a, const RecordHeader &b) {
+  return (int32_t)(a.sequence - b.sequence) > 0;
+}
+
+// Find the newest valid record of a region and decode it. Returns false if
+// neither slot holds one. Either way the region's sequence continues from
+// the highest intact slot, so the next record outranks every one on flash.
+static bool loadRecord(RecordRegion &r, const __FlashStringHelper *name,
+                       void (*decode)(uint8_t *, size_t, uint8_t)) {
+  RecordHeader hdrA, hdrB;
+  bool intactA = readSlot(r, r.slotA, hdrA);
+  bool intactB = readSlot(r, r.slotB, hdrB);
+  if (intactA) r.sequence = hdrA.sequence;
+  if (intactB && (!intactA || newerRecord(hdrB, hdrA))) r.sequence = hdrB.sequence;
+
+  bool validA = intactA && hdrA.version <= r.version;
+  bool validB = intactB && hdrB.version <= r.version;
+  if (!validA && !validB) return false;
+
+  bool useB = validB && (!validA || newerRecord(hdrB, hdrA));
+  RecordHeader &hdr = useB ? hdrB : hdrA;
+  if (!useB) readSlot(r, r.slotA, hdrA);   // scratch holds slot B otherwise
+
+  decode(scratch + sizeof(hdr), hdr.length, hdr.version);
+  r.activeSlot = useB ? r.slotB : r.slotA;
+  // An older version re-encodes differently, so the next save upgrades it
+  if (hdr.version == r.version) {
+    r.persistedLen = hdr.length;
+    memcpy(r.persisted, scratch + sizeof(hdr), hdr.length);
+  }
+
+  Serial.print(name);
+  Serial.print(F(" loaded from EEPROM (slot "));
+  Serial.print(useB ? 'B' : 'A');
+  Serial.print(F(", seq "));
+  Serial.print(hdr.sequence);
+  Serial.println(F(")."));
+  if (validA != validB) {
+    Serial.print(F("WARN: Other "));
+    Serial.print(name);
+    Serial.println(F(" slot invalid (torn write?)."));
+  }
+  return true;
+}
+
+// Decode the original byte-by-byte layout identified by EEPROM_MAGIC
+static void loadLegacyConfig() {
   for (int i = 0; i < 64; i++) {
     config.ssid[i] = EEPROM.read(ADDR_SSID + i);
     config.password[i] = EEPROM.read(ADDR_PASSWORD + i);
   }
-  
-  // Load timezone
   for (int i = 0; i < 8; i++) {
     config.timezone[i] = EEPROM.read(ADDR_TIMEZONE + i);
   }
-  
-  // Load last time
+  config.ssid[63] = '\0';
+  config.password[63] = '\0';
+  config.timezone[7] = '\0';
+
   config.lastTime = ((time_t)EEPROM.read(ADDR_LAST_TIME + 0) << 24) |
                     ((time_t)EEPROM.read(ADDR_LAST_TIME + 1) << 16) |
                     ((time_t)EEPROM.read(ADDR_LAST_TIME + 2) << 8) |
                     ((time_t)EEPROM.read(ADDR_LAST_TIME + 3));
-  
-  // Load PD voltage
   config.pdVoltage = EEPROM.read(ADDR_PD_VOLTAGE);
-  
-  // Load schedule count
-  config.scheduleCount = EEPROM.read(ADDR_SCHEDULE_COUNT);
-  if (config.scheduleCount > 10) config.scheduleCount = 0;
-  
-  // Load schedules
-  for (int i = 0; i < 10; i++) {
+
+  uint8_t count = EEPROM.read(ADDR_SCHEDULE_COUNT);
+  if (count > 10) count = 0;
+  for (int i = 0; i < count; i++) {
     int addr = ADDR_SCHEDULES + (i * 3);
-    config.schedules[i].time = ((uint16_t)EEPROM.read(addr + 0) << 8) |
-                               EEPROM.read(addr + 1);
-    config.schedules[i].action = EEPROM.read(addr + 2);
+    setLegacySchedule(i, ((uint16_t)EEPROM.read(addr + 0) << 8) | EEPROM.read(addr + 1),
+                      EEPROM.read(addr + 2));
   }
-  
-  // Load power states
+  config.scheduleCount = count;
+
   config.powerJackState = EEPROM.read(ADDR_POWER_JACK_STATE) == 1;
   config.usbOutputState = EEPROM.read(ADDR_USB_OUTPUT_STATE) == 1;
-  
-  Serial.println(F("Config loaded from EEPROM."));
+}
+
+// Size of the EEPROM blob as last committed, 0 if there is none
+static size_t eepromBlobSize() {
+  nvs_handle_t handle;
+  size_t size = 0;
+  if (nvs_open("eeprom", NVS_READONLY, &handle) != ESP_OK) return 0;
+  nvs_get_blob(handle, "eeprom", nullptr, &size);
+  nvs_close(handle);
+  return size;
+}
+
+// The table from its own store or, failing that, from wherever an older
+// layout kept it. Runs whatever became of the config record. Returns true
+// when the table still has to be written to its store.
+static bool loadScheduleTable(bool sharedLayout) {
+  if (loadRecord(scheduleRegion, F("Schedules"), decodeSchedules)) return false;
+
+  // The 4 KB shared blob held the table in its own slots; before that,
+  // config records carried up to 10 schedules (already decoded)
+  RecordRegion shared = {
+    &EEPROM, SHARED_SCHEDULE_SLOT_A, SHARED_SCHEDULE_SLOT_B, SCHEDULE_SLOT_SIZE,
+    SCHEDULE_RECORD_MAGIC, SCHEDULE_RECORD_VERSION,
+    schedulePersisted, 0, -1, 0, false
+  };
+  if (sharedLayout && loadRecord(shared, F("Shared EEPROM schedules"), decodeSchedules)) {
+    Serial.println(F("Moving schedules to their own store..."));
+  }
+  return config.scheduleCount > 0;
+}
+
+void loadConfig() {
+  setDefaults();
+
+  // Opening the EEPROM smaller than its blob truncates it, so a unit on the
+  // shared layout opens it whole until the table has been moved out
+  bool sharedLayout = eepromBlobSize() > EEPROM_SIZE;
+  EEPROM.begin(sharedLayout ? SHARED_EEPROM_SIZE : EEPROM_SIZE);
+  scheduleStore.begin(SCHEDULE_STORE_SIZE);
+
+  // A missing or corrupt config record falls back to defaults; the
+  // schedule table below is loaded either way
+  bool migrate = false;
+  if (!loadRecord(configRegion, F("Config"), decodeConfig)) {
+    if (EEPROM.read(ADDR_MAGIC) == EEPROM_MAGIC) {
+      // The legacy image overlaps slot A, so the first record goes to slot
+      // B and the old data stays intact until that commit has succeeded.
+      Serial.println(F("Migrating legacy config to versioned record..."));
+      loadLegacyConfig();
+      configRegion.activeSlot = configRegion.slotA;
+      migrate = true;
+    } else {
+      Serial.println(F("No valid config found. Using defaults."));
+    }
+  }
+
+  if (loadScheduleTable(sharedLayout)) migrate = true;
+
+  if (migrate || configRegion.persistedLen == 0) {
+    saveConfig();
+    flushConfig();
+  }
+
+  // The table is in its own blob now; cut the old slots off
+  if (sharedLayout) {
+    EEPROM.end();
+    EEPROM.begin(EEPROM_SIZE);
+  }
 }
@@ -3,7 +3,37 @@
 
 #include "config.h"
 
+// Flash wear counters (since boot)
+struct StorageStats {
+  uint32_t saveRequests;   // saveConfig() calls
+  uint32_t skippedSaves;   // Write-behind passes that found nothing changed
+  uint32_t commits;        // EEPROM.commit() calls (sector rewrites)
+  uint32_t bytesWritten;   // Flash bytes rewritten: the whole blob per commit
+  uint32_t bytesChanged;   // Of those, bytes that actually differed
+};
+
+// Note that the config or schedules changed; any task. The storage task
+// commits once CONFIG_FLUSH_QUIET has passed without further changes.
 void saveConfig();
+// Open the EEPROM and schedule stores and load both records
 void loadConfig();
 
+// Restore output states and lastTime from the journal (call after
+// beginJournal())
+void loadRuntimeState();
+
+// Start the storage task, which does all flash writes from then on, and
+// register the shutdown hook that flushes pending changes on restart. Call
+// at the end of setup(), after beginControlTask().
+void beginStorage();
+
+// Commit pending changes now and wait for it (e.g. before a restart). On the
+// control task it only brings the commit forward.
+void flushConfig();
+
+// Have the storage task look for work (journal appends)
+void wakeStorageTask();
+
+const StorageStats& getStorageStats();
+
 #endif
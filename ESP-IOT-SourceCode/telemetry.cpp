@@ -0,0 +1,152 @@
+#include "telemetry.h"
+#include <esp_timer.h>
+
+#define FINE_SLOTS TELEMETRY_FINE_SECONDS
+#define COARSE_SLOTS (TELEMETRY_COARSE_HOURS * 3600UL / TELEMETRY_COARSE_PERIOD)
+#define FINE_HOLD_SLOTS 2   // Seconds without a frame that repeat the last value
+
+static FineSample fine[FINE_SLOTS];
+static CoarseSample coarse[COARSE_SLOTS];
+
+// Slots [first, last] are complete. Only the control task writes; readers
+// on other tasks check after copying that `writing` has not reached the
+// slot they read (it runs ahead of last while a slot is overwritten).
+struct TierState {
+  volatile uint32_t first;
+  volatile uint32_t last;
+  volatile uint32_t writing;
+  volatile bool any;
+};
+
+// Frames collected for the slot in progress
+struct Accumulator {
+  bool open;
+  uint32_t slot;
+  uint32_t count;
+  uint32_t sum[ADC_CHANNEL_COUNT];
+  uint32_t min[ADC_CHANNEL_COUNT];
+  uint32_t max[ADC_CHANNEL_COUNT];
+};
+
+static TierState tiers[2];
+static Accumulator fineAcc, coarseAcc;
+
+static int16_t pack(uint32_t mv) {
+  return mv > INT16_MAX ? INT16_MAX : (int16_t)mv;
+}
+
+static void beginSlot(TierState &t, uint32_t slot, uint32_t slots) {
+  t.writing = slot;
+  if (!t.any) t.first = slot;
+  else if (slot - t.first >= slots) t.first = slot - slots + 1;
+}
+
+static void endSlot(TierState &t, uint32_t slot) {
+  t.last = slot;
+  t.any = true;
+}
+
+// Close the fine slot in progress; next is the slot the new frame is in
+static void closeFine(uint32_t next) {
+  FineSample s;
+  for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) s.mv[ch] = pack(fineAcc.sum[ch] / fineAcc.count);
+  FineSample none;
+  for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) none.mv[ch] = TELEMETRY_NONE;
+
+  uint32_t start = next - fineAcc.slot > FINE_SLOTS ? next - FINE_SLOTS : fineAcc.slot;
+  for (uint32_t slot = start; slot != next; slot++) {
+    beginSlot(tiers[TELEMETRY_FINE], slot, FINE_SLOTS);
+    fine[slot % FINE_SLOTS] = slot - fineAcc.slot <= FINE_HOLD_SLOTS ? s : none;
+    endSlot(tiers[TELEMETRY_FINE], slot);
+  }
+}
+
+static void closeCoarse(uint32_t next) {
+  CoarseSample s;
+  for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+    s.min[ch] = pack(coarseAcc.min[ch]);
+    s.avg[ch] = pack(coarseAcc.sum[ch] / coarseAcc.count);
+    s.max[ch] = pack(coarseAcc.max[ch]);
+  }
+  CoarseSample none;
+  for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+    none.min[ch] = none.avg[ch] = none.max[ch] = TELEMETRY_NONE;
+  }
+
+  uint32_t start = next - coarseAcc.slot > COARSE_SLOTS ? next - COARSE_SLOTS : coarseAcc.slot;
+  for (uint32_t slot = start; slot != next; slot++) {
+    beginSlot(tiers[TELEMETRY_COARSE], slot, COARSE_SLOTS);
+    coarse[slot % COARSE_SLOTS] = slot == coarseAcc.slot ? s : none;
+    endSlot(tiers[TELEMETRY_COARSE], slot);
+  }
+}
+
+static void accumulate(Accumulator &a, uint32_t slot, const uint32_t *mv) {
+  if (!a.open || a.slot != slot) {
+    a.open = true;
+    a.slot = slot;
+    a.count = 0;
+    for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+      a.sum[ch] = 0;
+      a.min[ch] = UINT32_MAX;
+      a.max[ch] = 0;
+    }
+  }
+  a.count++;
+  for (uint8_t ch = 0; ch < ADC_CHANNEL_COUNT; ch++) {
+    a.sum[ch] += mv[ch];
+    if (mv[ch] < a.min[ch]) a.min[ch] = mv[ch];
+    if (mv[ch] > a.max[ch]) a.max[ch] = mv[ch];
+  }
+}
+
+void telemetryAddFrame(const uint32_t *mv) {
+  uint32_t sec = telemetryUptime();
+  uint32_t coarseSlot = sec / TELEMETRY_COARSE_PERIOD;
+  if (fineAcc.open && sec != fineAcc.slot) closeFine(sec);
+  if (coarseAcc.open && coarseSlot != coarseAcc.slot) closeCoarse(coarseSlot);
+  accumulate(fineAcc, sec, mv);
+  accumulate(coarseAcc, coarseSlot, mv);
+}
+
+uint32_t telemetryPeriod(uint8_t tier) {
+  return tier == TELEMETRY_FINE ? 1 : TELEMETRY_COARSE_PERIOD;
+}
+
+uint32_t telemetrySlots(uint8_t tier) {
+  return tier == TELEMETRY_FINE ? FINE_SLOTS : COARSE_SLOTS;
+}
+
+bool telemetryRange(uint8_t tier, uint32_t &first, uint32_t &last) {
+  const TierState &t = tiers[tier];
+  if (!t.any) return false;
+  last = t.last;
+  first = t.first;
+  return true;
+}
+
+static bool slotValid(uint8_t tier, uint32_t slot) {
+  const TierState &t = tiers[tier];
+  return t.any && slot >= t.first && slot <= t.last &&
+         t.writing - slot < telemetrySlots(tier);
+}
+
+bool getFineSample(uint32_t slot, FineSample &out) {
+  if (!slotValid(TELEMETRY_FINE, slot)) return false;
+  out = fine[slot % FINE_SLOTS];
+  return slotValid(TELEMETRY_FINE, slot);
+}
+
+bool getCoarseSample(uint32_t slot, CoarseSample &out) {
+  if (!slotValid(TELEMETRY_COARSE, slot)) return false;
+  out = coarse[slot % COARSE_SLOTS];
+  return slotValid(TELEMETRY_COARSE, slot);
+}
+
+uint32_t telemetryUptime() {
+  return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+size_t telemetryMemoryBytes() {
+  return sizeof(fine) + sizeof(coarse);
+}
@@ -0,0 +1,51 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "config.h"
+#include "adc_sampler.h"
+
+// In-RAM VBUS/VOUT history in two fixed-size tiers, as int16 millivolts:
+//   fine:   1s averages for the last TELEMETRY_FINE_SECONDS
+//   coarse: min/avg/max per TELEMETRY_COARSE_PERIOD over TELEMETRY_COARSE_HOURS
+// Both tiers are fed from every ADC frame, so a sag shorter than a second
+// still shows in the coarse min/max. Slots are indexed by uptime (slot =
+// time / period, stored at slot % count), so there is no head pointer and
+// a slot's time follows from its number. Lost on reboot.
+#define TELEMETRY_FINE 0
+#define TELEMETRY_COARSE 1
+
+#define TELEMETRY_NONE INT16_MIN   // Slot with no frames
+
+struct FineSample {
+  int16_t mv[ADC_CHANNEL_COUNT];
+};
+
+struct CoarseSample {
+  int16_t min[ADC_CHANNEL_COUNT];
+  int16_t avg[ADC_CHANNEL_COUNT];
+  int16_t max[ADC_CHANNEL_COUNT];
+};
+
+// Called by the ADC sampler with each frame's unfiltered rail millivolts
+void telemetryAddFrame(const uint32_t *mv);
+
+// Seconds per slot and number of slots in a tier
+uint32_t telemetryPeriod(uint8_t tier);
+uint32_t telemetrySlots(uint8_t tier);
+
+// Range of complete slots currently held; false while a tier is empty.
+// Slot n covers uptime seconds [n * period, (n + 1) * period).
+bool telemetryRange(uint8_t tier, uint32_t &first, uint32_t &last);
+
+// Copy one slot; false if it has been overwritten or is not complete yet.
+// May run on any task: a slot overwritten mid-copy is detected and dropped.
+bool getFineSample(uint32_t slot, FineSample &out);
+bool getCoarseSample(uint32_t slot, CoarseSample &out);
+
+// Seconds since boot, the time base of the slots
+uint32_t telemetryUptime();
+
+// RAM used by both tiers
+size_t telemetryMemoryBytes();
+
+#endif
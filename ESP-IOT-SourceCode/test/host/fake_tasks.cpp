@@ -0,0 +1,15 @@
+// Host stand-ins for the control task and the perf counters: there is one
+// thread, so it is always the control task
+#include "control.h"
+#include "perf.h"
+
+bool onControlTask() {
+  return true;
+}
+
+void runOnControl(ControlFn fn, void *ctx) {
+  fn(ctx);
+}
+
+void perfRecord(uint8_t stage, uint32_t cycles) {
+}
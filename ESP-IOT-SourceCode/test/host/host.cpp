@@ -0,0 +1,94 @@
+#include "host.h"
+#include "config.h"
+#include <stdarg.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <esp_timer.h>
+
+// Globals the sketch defines in ESP-IOT-SourceCode.ino
+Config config;
+bool powerJackState = false;
+bool usbOutputState = false;
+bool wifiConnected = false;
+time_t currentTime = 0;
+
+unsigned long hostMillis = 0;
+uint8_t hostPinLevel[HOST_MAX_PINS];
+PinChange hostPinLog[HOST_PIN_LOG];
+int hostPinLogCount = 0;
+
+int hostFailures = 0;
+
+HardwareSerial Serial;
+
+size_t Print::out(const char *fmt, ...) {
+  static bool verbose = getenv("HOST_VERBOSE") != nullptr;
+  if (!verbose) return 0;
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n > 0 ? n : 0;
+}
+
+unsigned long millis() {
+  return hostMillis;
+}
+
+// Nothing else runs on the host; waiting just moves the clock
+void delay(unsigned long ms) {
+  hostMillis += ms;
+}
+
+int64_t esp_timer_get_time() {
+  return (int64_t)hostMillis * 1000;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  if (pin >= HOST_MAX_PINS) return;
+  level = level ? HIGH : LOW;
+  if (hostPinLevel[pin] == level) return;
+  hostPinLevel[pin] = level;
+  if (hostPinLogCount < HOST_PIN_LOG) {
+    hostPinLog[hostPinLogCount++] = { currentTime, pin, level };
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < HOST_MAX_PINS ? hostPinLevel[pin] : LOW;
+}
+
+void hostClearPinLog() {
+  hostPinLogCount = 0;
+}
+
+static int runOne(const HostTest &t) {
+  t.run();
+  printf("%s %s\n", hostFailures == 0 ? "ok  " : "FAIL", t.name);
+  return hostFailures == 0 ? 0 : 1;
+}
+
+int hostMain(int argc, char **argv, const HostTest *tests, size_t count) {
+  if (argc > 1) {
+    for (size_t i = 0; i < count; i++) {
+      if (strcmp(argv[1], tests[i].name) == 0) return runOne(tests[i]);
+    }
+    printf("No test named %s\n", argv[1]);
+    return 2;
+  }
+
+  int failed = 0;
+  for (size_t i = 0; i < count; i++) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) exit(runOne(tests[i]));
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+  }
+  printf("%zu tests, %d failed\n", count, failed);
+  return failed == 0 ? 0 : 1;
+}
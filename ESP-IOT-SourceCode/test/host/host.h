@@ -0,0 +1,64 @@
+#ifndef HOST_H
+#define HOST_H
+
+// Host test support: a virtual millis() clock, virtual GPIO with a log of
+// every level change, and a minimal check/report framework. Each test
+// program is one main() calling RUN_TEST() per case.
+#include <Arduino.h>
+
+// ============================================================================
+// Virtual Clock & GPIO
+// ============================================================================
+extern unsigned long hostMillis;
+
+struct PinChange {
+  time_t at;          // currentTime when the pin changed
+  uint8_t pin;
+  uint8_t level;
+};
+
+#define HOST_MAX_PINS 32
+#define HOST_PIN_LOG 256
+
+extern uint8_t hostPinLevel[HOST_MAX_PINS];
+extern PinChange hostPinLog[HOST_PIN_LOG];
+extern int hostPinLogCount;
+
+// Forget the log, keeping the levels
+void hostClearPinLog();
+
+// ============================================================================
+// Checks
+// ============================================================================
+// The firmware keeps its state in file statics, so every test runs in a
+// fresh process: hostMain() runs the test named on the command line, or
+// forks one child per test when there is none.
+extern int hostFailures;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("  %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      hostFailures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { \
+    long long a_ = (long long)(actual), e_ = (long long)(expected); \
+    if (a_ != e_) { \
+      printf("  %s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+      hostFailures++; \
+    } \
+  } while (0)
+
+struct HostTest {
+  const char *name;
+  void (*run)();
+};
+
+#define HOST_TEST(fn) { #fn, fn }
+
+int hostMain(int argc, char **argv, const HostTest *tests, size_t count);
+
+#endif
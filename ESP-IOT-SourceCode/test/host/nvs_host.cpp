@@ -0,0 +1,159 @@
+// In-memory NVS and EEPROMClass for the host build. Tests seed and inspect
+// blobs through hostBlob().
+#include "host.h"
+#include <EEPROM.h>
+#include <esp_rom_crc.h>
+#include <map>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> namespaces;
+static std::map<std::string, std::vector<uint8_t>> blobs;   // "ns/key"
+
+std::vector<uint8_t> *hostBlob(const char *ns, const char *key) {
+  auto it = blobs.find(std::string(ns) + "/" + key);
+  return it == blobs.end() ? nullptr : &it->second;
+}
+
+void hostSetBlob(const char *ns, const char *key, const std::vector<uint8_t> &data) {
+  blobs[std::string(ns) + "/" + key] = data;
+}
+
+// ============================================================================
+// NVS
+// ============================================================================
+static std::string blobKey(nvs_handle_t handle, const char *key) {
+  return namespaces[handle - 1] + "/" + key;
+}
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *handle) {
+  for (size_t i = 0; i < namespaces.size(); i++) {
+    if (namespaces[i] == ns) {
+      *handle = i + 1;
+      return ESP_OK;
+    }
+  }
+  // Like NVS, a read-only open fails until something created the namespace
+  std::string prefix = std::string(ns) + "/";
+  bool exists = false;
+  for (auto &b : blobs) exists |= b.first.compare(0, prefix.size(), prefix) == 0;
+  if (mode == NVS_READONLY && !exists) return ESP_ERR_NVS_NOT_FOUND;
+  namespaces.push_back(ns);
+  *handle = namespaces.size();
+  return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *length) {
+  auto it = blobs.find(blobKey(handle, key));
+  if (it == blobs.end()) return ESP_ERR_NVS_NOT_FOUND;
+  if (out) {
+    if (*length < it->second.size()) return ESP_FAIL;
+    memcpy(out, it->second.data(), it->second.size());
+  }
+  *length = it->second.size();
+  return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+  const uint8_t *p = (const uint8_t *)value;
+  blobs[blobKey(handle, key)] = std::vector<uint8_t>(p, p + length);
+  return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+  return blobs.erase(blobKey(handle, key)) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+  return ESP_OK;
+}
+
+// ============================================================================
+// EEPROMClass
+// ============================================================================
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass() : name("eeprom") {
+}
+
+EEPROMClass::EEPROMClass(const char *name) : name(name) {
+}
+
+EEPROMClass::~EEPROMClass() {
+  free(data);
+}
+
+bool EEPROMClass::begin(size_t newSize) {
+  if (data) end();
+  if (nvs_open(name, NVS_READWRITE, &handle) != ESP_OK) return false;
+  std::vector<uint8_t> stored;
+  size_t storedSize = 0;
+  if (nvs_get_blob(handle, name, nullptr, &storedSize) == ESP_OK) {
+    stored.resize(storedSize);
+    nvs_get_blob(handle, name, stored.data(), &storedSize);
+  }
+  // Missing bytes read as zero; a larger blob is cut to the new size
+  stored.resize(newSize, 0);
+  nvs_set_blob(handle, name, stored.data(), newSize);
+  data = (uint8_t *)malloc(newSize);
+  memcpy(data, stored.data(), newSize);
+  size = newSize;
+  dirty = false;
+  return true;
+}
+
+void EEPROMClass::end() {
+  if (!data) return;
+  commit();
+  free(data);
+  data = nullptr;
+  size = 0;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  return address >= 0 && (size_t)address < size ? data[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address < 0 || (size_t)address >= size || data[address] == value) return;
+  data[address] = value;
+  dirty = true;
+}
+
+size_t EEPROMClass::readBytes(int address, void *value, size_t maxLen) {
+  if (address < 0 || address + maxLen > size) return 0;
+  memcpy(value, data + address, maxLen);
+  return maxLen;
+}
+
+bool EEPROMClass::commit() {
+  if (!data || !dirty) return true;
+  nvs_set_blob(handle, name, data, size);
+  dirty = false;
+  commits++;
+  return true;
+}
+
+// ============================================================================
+// CRC
+// ============================================================================
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0x8408 & -(crc & 1));
+  }
+  return ~crc;
+}
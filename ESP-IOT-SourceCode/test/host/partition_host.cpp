@@ -0,0 +1,68 @@
+// Flash partition for the host build. The contents live in shared memory,
+// so a test can run a boot in a child process, cut its power part-way
+// through a write or erase, and boot again from what is left.
+#include "host.h"
+#include <esp_partition.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define HOST_FLASH_SECTOR 4096
+
+uint32_t hostFlashSize = 4 * HOST_FLASH_SECTOR;
+int hostFlashBudget = -1;
+uint32_t hostFlashErases = 0;
+
+static uint8_t *flash = nullptr;
+static esp_partition_t part;
+
+uint8_t *hostFlash() {
+  if (!flash) {
+    flash = (uint8_t *)mmap(nullptr, hostFlashSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    memset(flash, 0xFF, hostFlashSize);
+  }
+  return flash;
+}
+
+// Spend one operation of the budget; the one that runs out is torn
+static bool powerCut() {
+  if (hostFlashBudget < 0) return false;
+  return hostFlashBudget-- == 0;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char *label) {
+  part.type = type;
+  part.subtype = subtype;
+  part.address = 0;
+  part.size = hostFlashSize;
+  strncpy(part.label, label, sizeof(part.label) - 1);
+  hostFlash();
+  return &part;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t size) {
+  if (offset + size > p->size) return ESP_FAIL;
+  memcpy(dst, hostFlash() + offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t size) {
+  if (offset + size > p->size) return ESP_FAIL;
+  bool cut = powerCut();
+  if (cut) size /= 2;
+  const uint8_t *s = (const uint8_t *)src;
+  for (size_t i = 0; i < size; i++) hostFlash()[offset + i] &= s[i];
+  if (cut) _exit(0);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t size) {
+  if (offset % HOST_FLASH_SECTOR || size % HOST_FLASH_SECTOR || offset + size > p->size) return ESP_FAIL;
+  bool cut = powerCut();
+  if (cut) size /= 2;
+  memset(hostFlash() + offset, 0xFF, size);
+  hostFlashErases++;
+  if (cut) _exit(0);
+  return ESP_OK;
+}
@@ -0,0 +1,93 @@
+// Host build: the subset of the Arduino core the tested modules use, backed
+// by a virtual clock and virtual GPIO (host.h)
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <string>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define PROGMEM
+#define IRAM_ATTR
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class String {
+ public:
+  String() {}
+  String(const char *c) : s(c ? c : "") {}
+  explicit String(int v) : s(std::to_string(v)) {}
+  explicit String(unsigned v) : s(std::to_string(v)) {}
+  explicit String(long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long v) : s(std::to_string(v)) {}
+
+  unsigned length() const { return s.size(); }
+  const char *c_str() const { return s.c_str(); }
+  char operator[](unsigned i) const { return s[i]; }
+  int indexOf(char c, unsigned from = 0) const { return find(s.find(c, from)); }
+  int indexOf(const char *c, unsigned from = 0) const { return find(s.find(c, from)); }
+  String substring(unsigned from) const { return from < s.size() ? String(s.substr(from).c_str()) : String(); }
+  String substring(unsigned from, unsigned to) const {
+    return from < to && from < s.size() ? String(s.substr(from, to - from).c_str()) : String();
+  }
+  bool startsWith(const char *p) const { return s.rfind(p, 0) == 0; }
+  long toInt() const { return atol(s.c_str()); }
+  void toUpperCase() { for (char &c : s) c = toupper((unsigned char)c); }
+  void toLowerCase() { for (char &c : s) c = tolower((unsigned char)c); }
+  void trim() {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = a == std::string::npos ? std::string() : s.substr(a, b - a + 1);
+  }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const char *o) const { return s != o; }
+  bool operator==(const String &o) const { return s == o.s; }
+  String &operator+=(const char *o) { s += o; return *this; }
+  String &operator+=(const String &o) { s += o.s; return *this; }
+
+ private:
+  static int find(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  std::string s;
+};
+
+// Serial output goes to stdout when HOST_VERBOSE is set, nowhere otherwise
+class Print {
+ public:
+  size_t print(const char *v) { return out("%s", v); }
+  size_t print(const String &v) { return out("%s", v.c_str()); }
+  size_t print(const __FlashStringHelper *v) { return out("%s", (const char *)v); }
+  size_t print(char v) { return out("%c", v); }
+  size_t print(int v) { return out("%d", v); }
+  size_t print(unsigned v) { return out("%u", v); }
+  size_t print(long v) { return out("%ld", v); }
+  size_t print(unsigned long v) { return out("%lu", v); }
+  size_t print(long long v) { return out("%lld", v); }
+  size_t print(unsigned long long v) { return out("%llu", v); }
+  size_t print(double v, int digits = 2) { return out("%.*f", digits, v); }
+  template <typename T> size_t println(T v) { return print(v) + out("\n"); }
+  size_t println() { return out("\n"); }
+
+ private:
+  size_t out(const char *fmt, ...);
+};
+
+class HardwareSerial : public Print {};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+void delay(unsigned long ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+#endif
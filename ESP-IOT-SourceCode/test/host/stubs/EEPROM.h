@@ -0,0 +1,38 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// Arduino-ESP32's EEPROMClass over the in-memory NVS, with the same
+// behaviour where the firmware depends on it: one blob per name, begin()
+// grows or truncates the blob to the requested size, commit() rewrites the
+// whole blob and only when something was written.
+#include <stddef.h>
+#include <stdint.h>
+#include <nvs.h>
+
+class EEPROMClass {
+ public:
+  EEPROMClass();
+  explicit EEPROMClass(const char *name);
+  ~EEPROMClass();
+
+  bool begin(size_t size);
+  void end();
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  size_t readBytes(int address, void *value, size_t maxLen);
+  bool commit();
+  uint16_t length() { return size; }
+
+  uint32_t commits = 0;   // Host only: blob rewrites
+
+ private:
+  const char *name;
+  nvs_handle_t handle = 0;
+  uint8_t *data = nullptr;
+  size_t size = 0;
+  bool dirty = false;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
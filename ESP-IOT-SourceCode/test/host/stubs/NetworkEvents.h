@@ -0,0 +1,3 @@
+#ifndef HOST_NETWORK_EVENTS_H
+#define HOST_NETWORK_EVENTS_H
+#endif
@@ -0,0 +1,3 @@
+#ifndef HOST_NETWORK_INTERFACE_H
+#define HOST_NETWORK_INTERFACE_H
+#endif
@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_CPU_H
+#define HOST_ESP_CPU_H
+
+#include <stdint.h>
+
+static inline uint32_t esp_cpu_get_cycle_count() { return 0; }
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+// One data partition over NOR-like flash (partition_host.cpp): writes can
+// only clear bits, erases set whole sectors back to 0xFF
+#include <stddef.h>
+#include <stdint.h>
+#include <nvs.h>
+
+typedef enum { ESP_PARTITION_TYPE_APP = 0, ESP_PARTITION_TYPE_DATA = 1 } esp_partition_type_t;
+typedef int esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t size);
+
+#endif
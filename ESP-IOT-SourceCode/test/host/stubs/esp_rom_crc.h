@@ -0,0 +1,11 @@
+#ifndef HOST_ESP_ROM_CRC_H
+#define HOST_ESP_ROM_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Same conventions as the ROM: reflected polynomials, inverted in and out
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
+uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t *buf, uint32_t len);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <nvs.h>
+
+typedef void (*shutdown_handler_t)(void);
+static inline esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler) { return ESP_OK; }
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef void *QueueHandle_t;
+
+static inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t size) { return nullptr; }
+static inline BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait) { return pdFALSE; }
+static inline BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait) { return pdFALSE; }
+
+#endif
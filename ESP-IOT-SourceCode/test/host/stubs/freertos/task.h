@@ -0,0 +1,20 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+// Task creation fails, so the firmware keeps running its work inline, as it
+// does in setup() before its tasks start
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+static inline BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack,
+                                     void *arg, UBaseType_t priority, TaskHandle_t *handle) {
+  if (handle) *handle = nullptr;
+  return pdFAIL;
+}
+static inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task) { return pdPASS; }
+static inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) { return 1; }
+
+#endif
@@ -0,0 +1,181 @@
+// The real journal (journal.cpp) on a 4-sector host partition. Each boot
+// runs in a child process over shared flash, so a boot can lose power in
+// the middle of any flash operation and the next boot sees what is left.
+#include "host.h"
+#include "journal.h"
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern uint32_t hostFlashSize;
+extern int hostFlashBudget;
+uint8_t *hostFlash();
+
+// No storage task here: appends run from put() below
+void wakeStorageTask() {
+}
+
+static const uint32_t SECTOR = JOURNAL_SECTOR_SIZE;
+static const uint32_t SLOTS = JOURNAL_SECTOR_SIZE / 16;
+
+// Run one boot in a child. Its failures count towards the test; a power
+// cut ends it early without failing.
+static void boot(void (*session)()) {
+  hostFlash();   // Mapped before the fork so both sides share it
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    CHECK(beginJournal());
+    session();
+    fflush(stdout);
+    _exit(hostFailures ? 1 : 0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) hostFailures++;
+}
+
+static void put(JournalKey key, int64_t value) {
+  journalPut(key, value);
+  journalLoop();
+}
+
+static int64_t get(JournalKey key) {
+  int64_t v = -1;
+  journalGet(key, v);
+  return v;
+}
+
+static bool sectorBlank(uint32_t base) {
+  for (uint32_t i = 0; i < SECTOR; i++) {
+    if (hostFlash()[base + i] != 0xFF) return false;
+  }
+  return true;
+}
+
+// The sector after the write head
+static uint32_t spare() {
+  uint32_t next = (getJournalStats().sector + 1) * SECTOR;
+  return next >= hostFlashSize ? 0 : next;
+}
+
+// Outputs set once, then only the now moves: the outputs' newest records
+// are as old as they can get when the head laps
+static int64_t now = 1000;
+
+static void setOutputs() {
+  put(JOURNAL_POWER_JACK, 1);
+  put(JOURNAL_USB_OUTPUT, 0);
+}
+
+static void tick(uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) put(JOURNAL_LAST_TIME, ++now);
+}
+
+static void checkOutputs() {
+  CHECK_EQ(get(JOURNAL_POWER_JACK), 1);
+  CHECK_EQ(get(JOURNAL_USB_OUTPUT), 0);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+// Several laps of the partition: values survive and the sector after the
+// head is blank after every append
+static void lapsKeepValuesAndSpare() {
+  boot([] {
+    setOutputs();
+    for (uint32_t i = 0; i < 5 * 4 * SLOTS; i++) {
+      tick(1);
+      if (!sectorBlank(spare())) {
+        CHECK(sectorBlank(spare()));
+        return;
+      }
+    }
+    CHECK(getJournalStats().erases >= 16);
+  });
+  boot([] {
+    checkOutputs();
+    CHECK_EQ(get(JOURNAL_LAST_TIME), 1000 + 5 * 4 * SLOTS);
+    CHECK(sectorBlank(spare()));
+  });
+}
+
+// Cut the power at every flash operation around a lap into the next
+// sector. Each time the next boot has the outputs, the now it last wrote
+// or the one before, and a blank spare again.
+static void powerCutWhileChangingSector() {
+  boot([] {
+    setOutputs();
+    tick(2 * SLOTS - 4);   // Three slots left in sector 1
+  });
+
+  static int cut;
+  for (cut = 0; cut < 12; cut++) {
+    std::vector<uint8_t> image(hostFlash(), hostFlash() + hostFlashSize);
+    boot([] {
+      now = 1000 + 2 * SLOTS - 4;
+      hostFlashBudget = cut;
+      tick(8);
+    });
+    boot([] {
+      checkOutputs();
+      int64_t t = get(JOURNAL_LAST_TIME);
+      CHECK(t >= 1000 + 2 * SLOTS - 4 && t <= 1000 + 2 * SLOTS + 4);
+      CHECK(sectorBlank(spare()));
+      // And it keeps going from there
+      now = t;
+      tick(3 * SLOTS);
+    });
+    boot([] {
+      checkOutputs();
+      CHECK(sectorBlank(spare()));
+    });
+    if (hostFailures) {
+      printf("  with the power cut at flash operation %d\n", cut);
+      return;
+    }
+    memcpy(hostFlash(), image.data(), hostFlashSize);
+  }
+}
+
+// Older firmware erased each sector as the head entered it, so no sector
+// is blank: the first boot erases the one after the head, keeping the
+// values whose newest record is elsewhere
+static void upgradeFromEraseInPlace() {
+  boot([] {
+    setOutputs();
+    tick(4 * SLOTS);
+  });
+  // Fill the spare with a copy of the oldest sector, as erase-in-place
+  // left it
+  uint32_t blank = 0;
+  for (uint32_t s = 0; s < 4; s++) {
+    if (sectorBlank(s * SECTOR)) blank = s;
+  }
+  memcpy(hostFlash() + blank * SECTOR, hostFlash() + ((blank + 1) % 4) * SECTOR, SECTOR);
+
+  boot([] {
+    checkOutputs();
+    CHECK_EQ(get(JOURNAL_LAST_TIME), 1000 + 4 * SLOTS);
+    CHECK(sectorBlank(spare()));
+    now = 1000 + 4 * SLOTS;
+    tick(2 * SLOTS);
+  });
+  boot([] {
+    checkOutputs();
+    CHECK_EQ(get(JOURNAL_LAST_TIME), 1000 + 6 * SLOTS);
+  });
+}
+
+static const HostTest tests[] = {
+  HOST_TEST(lapsKeepValuesAndSpare),
+  HOST_TEST(powerCutWhileChangingSector),
+  HOST_TEST(upgradeFromEraseInPlace),
+};
+
+int main(int argc, char **argv) {
+  return hostMain(argc, argv, tests, sizeof(tests) / sizeof(tests[0]));
+}
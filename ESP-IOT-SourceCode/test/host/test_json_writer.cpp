@@ -0,0 +1,63 @@
+// JsonWriter (json_writer.cpp) at the edges of its buffer: with a sink a
+// body of any length arrives whole, without one it must say it was cut.
+#include "host.h"
+#include "json_writer.h"
+#include <string>
+
+static void append(void *ctx, const char *data, size_t len) {
+  ((std::string *)ctx)->append(data, len);
+}
+
+static void writeBody(JsonWriter &json) {
+  json.beginObject();
+  json.addString("name", "a \"quoted\" name");
+  json.beginArray("values");
+  for (int i = 0; i < 10; i++) json.addInt(nullptr, -i * 1000);
+  json.endArray();
+  json.addFixed("volts", 425, 1);
+  json.endObject();
+}
+
+static const char *const BODY =
+  "{\"name\":\"a \\\"quoted\\\" name\",\"values\":[0,-1000,-2000,-3000,-4000,"
+  "-5000,-6000,-7000,-8000,-9000],\"volts\":42.5}";
+
+static void sinkGetsWholeBody() {
+  char buf[8];
+  std::string out;
+  JsonWriter json(buf, sizeof(buf), append, &out);
+  writeBody(json);
+  json.flush();
+  CHECK(out == BODY);
+  CHECK_EQ(json.total(), strlen(BODY));
+  CHECK(!json.overflowed());
+}
+
+static void sinklessFits() {
+  char buf[128];
+  JsonWriter json(buf, sizeof(buf), nullptr, nullptr);
+  writeBody(json);
+  CHECK(!json.overflowed());
+  CHECK(std::string(json.data(), json.buffered()) == BODY);
+}
+
+static void sinklessOverflowIsFlagged() {
+  char buf[32];
+  JsonWriter json(buf, sizeof(buf), nullptr, nullptr);
+  writeBody(json);
+  json.flush();
+  // What fitted is kept as written, the rest dropped
+  CHECK(json.overflowed());
+  CHECK_EQ(json.buffered(), sizeof(buf));
+  CHECK(std::string(json.data(), json.buffered()) == std::string(BODY, sizeof(buf)));
+}
+
+static const HostTest tests[] = {
+  HOST_TEST(sinkGetsWholeBody),
+  HOST_TEST(sinklessFits),
+  HOST_TEST(sinklessOverflowIsFlagged),
+};
+
+int main(int argc, char **argv) {
+  return hostMain(argc, argv, tests, sizeof(tests) / sizeof(tests[0]));
+}
@@ -0,0 +1,292 @@
+// The real scheduler (scheduler.cpp) and clock (timekeeping.cpp) driven by
+// the virtual clock. tickClock() runs every virtual second as the control
+// task would; the fake outputs below drive the same pins as hardware.cpp,
+// so every check is on a pin level at a clock time.
+#include "host.h"
+#include "scheduler.h"
+#include "timekeeping.h"
+#include "hardware.h"
+
+// ============================================================================
+// Outputs
+// ============================================================================
+struct PDChange {
+  time_t at;
+  uint8_t volts;
+};
+static PDChange pdLog[64];
+static int pdLogCount = 0;
+
+bool setPowerJackState(bool state) {
+  powerJackState = state;
+  digitalWrite(POWER_JACK_PIN, state ? HIGH : LOW);
+  return true;
+}
+
+bool setUSBOutputState(bool state) {
+  usbOutputState = state;
+  digitalWrite(USB_OUTPUT_PIN, state ? LOW : HIGH);  // Inverted
+  return true;
+}
+
+bool setPDVoltage(uint8_t voltage) {
+  if (!isValidPDVoltage(voltage)) return false;
+  config.pdVoltage = voltage;
+  if (pdLogCount < 64) pdLog[pdLogCount++] = { currentTime, voltage };
+  return true;
+}
+
+void saveConfig() {
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+// Monday 2026-01-05 00:00:00 UTC
+static const time_t MONDAY = 1767571200;
+static const time_t DAY = 86400;
+
+static time_t at(time_t day, int hour, int minute, int second = 0) {
+  return day + hour * 3600 + minute * 60 + second;
+}
+
+static void addRule(uint16_t time, uint8_t action, uint8_t target, uint8_t days = SCHEDULE_DAYS_ALL) {
+  Schedule s = { time, action, days, target };
+  CHECK(addSchedule(s));
+}
+
+// Both outputs off, clock set to `start`, as after boot and an NTP sync
+static void boot(time_t start, const char *timezone = "UTC") {
+  strcpy(config.timezone, timezone);
+  config.pdVoltage = 9;
+  setPowerJackState(false);
+  setUSBOutputState(false);
+  hostClearPinLog();
+  currentTime = start;
+  tickClock();   // Starts counting from the current millis()
+  invalidateSchedules();
+}
+
+// Tick once per virtual second, like CLOCK_TICK_INTERVAL
+static void runFor(time_t seconds) {
+  for (time_t i = 0; i < seconds; i++) {
+    hostMillis += CLOCK_TICK_INTERVAL;
+    tickClock();
+  }
+}
+
+static void runUntil(time_t t) {
+  runFor(t - currentTime);
+}
+
+// The n-th logged change of a pin, or a { 0 } entry when there is none
+static PinChange change(uint8_t pin, int n) {
+  for (int i = 0; i < hostPinLogCount; i++) {
+    if (hostPinLog[i].pin == pin && n-- == 0) return hostPinLog[i];
+  }
+  return PinChange { 0, pin, 0 };
+}
+
+static int changes(uint8_t pin) {
+  int count = 0;
+  for (int i = 0; i < hostPinLogCount; i++) count += hostPinLog[i].pin == pin;
+  return count;
+}
+
+#define CHECK_CHANGE(pin_, n_, when_, level_) \
+  do { \
+    PinChange c_ = change(pin_, n_); \
+    CHECK_EQ(c_.at, when_); \
+    CHECK_EQ(c_.level, level_); \
+  } while (0)
+
+// ============================================================================
+// Tests
+// ============================================================================
+static void dailyAndWeekdayRules() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  addRule(2200, 0, SCHEDULE_TARGET_JACK, 0x02);    // Mondays only
+  addRule(1200, 1, SCHEDULE_TARGET_USB, 0x04);     // Tuesdays only
+  boot(MONDAY);
+  runUntil(MONDAY + 2 * DAY);
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 3);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 7, 30), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 22, 0), LOW);
+  CHECK_CHANGE(POWER_JACK_PIN, 2, at(MONDAY + DAY, 7, 30), HIGH);
+  CHECK_EQ(changes(USB_OUTPUT_PIN), 1);
+  CHECK_CHANGE(USB_OUTPUT_PIN, 0, at(MONDAY + DAY, 12, 0), LOW);   // LOW = on
+}
+
+static void bothTargetsAndPD() {
+  addRule(600, 1, SCHEDULE_TARGET_BOTH);
+  addRule(600, 20, SCHEDULE_TARGET_PD);
+  addRule(1800, 5, SCHEDULE_TARGET_PD);
+  addRule(1800, 0, SCHEDULE_TARGET_BOTH);
+  boot(MONDAY);
+  runUntil(MONDAY + DAY);
+
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 6, 0), HIGH);
+  CHECK_CHANGE(USB_OUTPUT_PIN, 0, at(MONDAY, 6, 0), LOW);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 18, 0), LOW);
+  CHECK_CHANGE(USB_OUTPUT_PIN, 1, at(MONDAY, 18, 0), HIGH);
+  CHECK_EQ(pdLogCount, 2);
+  CHECK_EQ(pdLog[0].at, at(MONDAY, 6, 0));
+  CHECK_EQ(pdLog[0].volts, 20);
+  CHECK_EQ(pdLog[1].at, at(MONDAY, 18, 0));
+  CHECK_EQ(pdLog[1].volts, 5);
+}
+
+// Entries sharing a minute run in table order
+static void sameMinuteInTableOrder() {
+  addRule(900, 1, SCHEDULE_TARGET_JACK);
+  addRule(900, 0, SCHEDULE_TARGET_JACK);
+  boot(MONDAY);
+  runUntil(at(MONDAY, 9, 1));
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 2);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 9, 0), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 9, 0), LOW);
+}
+
+// Schedules are in local time, weekdays included; no DST, fixed offsets
+static void localTime(const char *timezone, int offsetHours) {
+  addRule(800, 1, SCHEDULE_TARGET_JACK, 0x02);   // Monday 08:00 local
+  addRule(100, 1, SCHEDULE_TARGET_USB, 0x04);    // Tuesday 01:00 local
+  boot(MONDAY - DAY, timezone);
+  runUntil(MONDAY + 3 * DAY);
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 1);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 8, 0) - offsetHours * 3600, HIGH);
+  CHECK_EQ(changes(USB_OUTPUT_PIN), 1);
+  CHECK_CHANGE(USB_OUTPUT_PIN, 0, at(MONDAY + DAY, 1, 0) - offsetHours * 3600, LOW);
+}
+
+static void timezoneUtcPlus2() { localTime("UTC+2", 2); }
+static void timezoneUtcMinus3() { localTime("UTC-3", -3); }
+static void timezoneEst() { localTime("EST", -5); }
+static void timezoneJst() { localTime("jst", 9); }   // Crosses UTC midnight
+static void timezoneUnknownIsUtc() { localTime("XYZ", 0); }
+
+// A clock step within SCHEDULE_CLOCK_JUMP is a late tick: the event runs
+// at the tick that passes it
+static void shortStallFiresLate() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  boot(at(MONDAY, 7, 29));
+  hostMillis += 90 * 1000;
+  tickClock();
+
+  CHECK_EQ(currentTime, at(MONDAY, 7, 30, 30));
+  CHECK_EQ(changes(POWER_JACK_PIN), 1);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 7, 30, 30), HIGH);
+}
+
+// millis() leaping ahead (a long block) past SCHEDULE_CLOCK_JUMP: the
+// missed events are caught up once, as the state they imply
+static void longStallCatchesUp() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  addRule(745, 1, SCHEDULE_TARGET_USB);
+  addRule(800, 0, SCHEDULE_TARGET_USB);
+  addRule(2200, 0, SCHEDULE_TARGET_JACK);
+  boot(at(MONDAY, 7, 0));
+  hostMillis += 3 * 3600 * 1000UL;
+  tickClock();
+  runUntil(at(MONDAY, 23, 0));
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 2);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 10, 0), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 22, 0), LOW);
+  // USB went on and off inside the gap and ends where it started
+  CHECK_EQ(changes(USB_OUTPUT_PIN), 0);
+}
+
+// The clock set forward (NTP, /settime): same catch-up, then normal firing
+static void clockSetForward() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  addRule(2200, 0, SCHEDULE_TARGET_JACK);
+  addRule(1200, 15, SCHEDULE_TARGET_PD);
+  boot(at(MONDAY, 6, 0));
+  runFor(60);
+  currentTime = at(MONDAY, 13, 0);
+  runUntil(at(MONDAY + DAY, 13, 0));
+
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 13, 0, 1), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 22, 0), LOW);
+  CHECK_CHANGE(POWER_JACK_PIN, 2, at(MONDAY + DAY, 7, 30), HIGH);
+  CHECK_EQ(pdLogCount >= 2, true);
+  CHECK_EQ(pdLog[0].at, at(MONDAY, 13, 0, 1));
+  CHECK_EQ(pdLog[0].volts, 15);
+  CHECK_EQ(pdLog[1].at, at(MONDAY + DAY, 12, 0));
+}
+
+// Jumping over a whole on/off pair leaves the output alone
+static void clockSetPastOnAndOff() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  addRule(2200, 0, SCHEDULE_TARGET_JACK);
+  boot(at(MONDAY, 6, 0));
+  runFor(10);
+  currentTime = at(MONDAY, 23, 0);
+  runFor(3600);
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 0);
+}
+
+// The clock set back over an event that already ran does not repeat it
+static void clockSetBackNoRepeat() {
+  addRule(730, 1, SCHEDULE_TARGET_JACK);
+  addRule(731, 0, SCHEDULE_TARGET_JACK);
+  boot(at(MONDAY, 7, 29));
+  runUntil(at(MONDAY, 7, 32));
+  currentTime = at(MONDAY, 7, 0);
+  runUntil(at(MONDAY, 7, 40));
+  runUntil(at(MONDAY + DAY, 7, 35));
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 4);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 7, 30), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 1, at(MONDAY, 7, 31), LOW);
+  CHECK_CHANGE(POWER_JACK_PIN, 2, at(MONDAY + DAY, 7, 30), HIGH);
+  CHECK_CHANGE(POWER_JACK_PIN, 3, at(MONDAY + DAY, 7, 31), LOW);
+}
+
+// No clock yet: nothing runs until the time is set
+static void noClockNoEvents() {
+  addRule(0, 1, SCHEDULE_TARGET_JACK);
+  boot(0);
+  runFor(2 * DAY);
+  CHECK_EQ(changes(POWER_JACK_PIN), 0);
+}
+
+// Editing the table takes effect at the next tick
+static void editWhileRunning() {
+  addRule(1000, 1, SCHEDULE_TARGET_JACK);
+  boot(at(MONDAY, 9, 0));
+  runUntil(at(MONDAY, 9, 30));
+  CHECK(removeSchedule(0));
+  addRule(1100, 1, SCHEDULE_TARGET_JACK);
+  runUntil(at(MONDAY, 12, 0));
+
+  CHECK_EQ(changes(POWER_JACK_PIN), 1);
+  CHECK_CHANGE(POWER_JACK_PIN, 0, at(MONDAY, 11, 0), HIGH);
+}
+
+static const HostTest tests[] = {
+  HOST_TEST(dailyAndWeekdayRules),
+  HOST_TEST(bothTargetsAndPD),
+  HOST_TEST(sameMinuteInTableOrder),
+  HOST_TEST(timezoneUtcPlus2),
+  HOST_TEST(timezoneUtcMinus3),
+  HOST_TEST(timezoneEst),
+  HOST_TEST(timezoneJst),
+  HOST_TEST(timezoneUnknownIsUtc),
+  HOST_TEST(shortStallFiresLate),
+  HOST_TEST(longStallCatchesUp),
+  HOST_TEST(clockSetForward),
+  HOST_TEST(clockSetPastOnAndOff),
+  HOST_TEST(clockSetBackNoRepeat),
+  HOST_TEST(noClockNoEvents),
+  HOST_TEST(editWhileRunning),
+};
+
+int main(int argc, char **argv) {
+  return hostMain(argc, argv, tests, sizeof(tests) / sizeof(tests[0]));
+}
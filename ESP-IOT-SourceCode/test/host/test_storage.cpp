@@ -0,0 +1,210 @@
+// The real record storage (storage.cpp) over the in-memory NVS: what
+// loadConfig() makes of each layout a unit may boot with, and what it leaves
+// in flash afterwards.
+#include "host.h"
+#include "storage.h"
+#include "journal.h"
+#include <EEPROM.h>
+#include <esp_rom_crc.h>
+#include <vector>
+
+std::vector<uint8_t> *hostBlob(const char *ns, const char *key);
+void hostSetBlob(const char *ns, const char *key, const std::vector<uint8_t> &data);
+
+bool journalGet(JournalKey key, int64_t &value) {
+  return false;
+}
+
+void journalPut(JournalKey key, int64_t value) {
+}
+
+void journalLoop() {
+}
+
+// ============================================================================
+// Record Images
+// ============================================================================
+// Same layout as RecordHeader in storage.cpp, built byte by byte so a
+// change there shows up here
+static void putLE(std::vector<uint8_t> &b, size_t at, uint32_t v, int n) {
+  for (int i = 0; i < n; i++) b[at + i] = (v >> (8 * i)) & 0xFF;
+}
+
+static void writeRecord(std::vector<uint8_t> &blob, size_t slot, uint16_t magic, uint8_t version,
+                        uint32_t sequence, const std::vector<uint8_t> &payload) {
+  std::vector<uint8_t> rec(16 + payload.size(), 0);
+  putLE(rec, 0, magic, 2);
+  rec[2] = version;
+  putLE(rec, 4, sequence, 4);
+  putLE(rec, 8, payload.size(), 2);
+  memcpy(rec.data() + 16, payload.data(), payload.size());
+  uint32_t crc = esp_rom_crc32_le(0, rec.data(), 16);
+  crc = esp_rom_crc32_le(crc, payload.data(), payload.size());
+  putLE(rec, 12, crc, 4);
+  memcpy(blob.data() + slot, rec.data(), rec.size());
+}
+
+struct Rule {
+  uint16_t minute;
+  uint8_t target, days, action;
+};
+
+static std::vector<uint8_t> schedulePayload(const std::vector<Rule> &rules) {
+  std::vector<uint8_t> p(2 + rules.size() * 4);
+  putLE(p, 0, rules.size(), 2);
+  for (size_t i = 0; i < rules.size(); i++) {
+    putLE(p, 2 + i * 4, rules[i].minute | (rules[i].target << 11), 2);
+    p[4 + i * 4] = rules[i].days;
+    p[5 + i * 4] = rules[i].action;
+  }
+  return p;
+}
+
+// ssid, password, timezone, pdVoltage, lowPower, two output limits
+static std::vector<uint8_t> configPayload(const char *ssid, uint8_t pdVoltage) {
+  std::vector<uint8_t> p(64 + 64 + 8 + 1 + 1 + 8, 0);
+  strcpy((char *)p.data(), ssid);
+  strcpy((char *)p.data() + 128, "UTC+2");
+  p[136] = pdVoltage;
+  return p;
+}
+
+// Header fields of the record in a slot, or magic 0 if there is none
+struct SlotInfo {
+  uint16_t magic;
+  uint32_t sequence;
+  bool intact;
+};
+
+static SlotInfo slotAt(const std::vector<uint8_t> *blob, size_t slot) {
+  SlotInfo s = { 0, 0, false };
+  if (!blob || blob->size() < slot + 16) return s;
+  const uint8_t *h = blob->data() + slot;
+  s.magic = h[0] | (h[1] << 8);
+  s.sequence = h[4] | (h[5] << 8) | (h[6] << 16) | ((uint32_t)h[7] << 24);
+  uint16_t length = h[8] | (h[9] << 8);
+  if (slot + 16 + length > blob->size()) return s;
+  std::vector<uint8_t> hdr(h, h + 16);
+  uint32_t stored = hdr[12] | (hdr[13] << 8) | (hdr[14] << 16) | ((uint32_t)hdr[15] << 24);
+  putLE(hdr, 12, 0, 4);
+  uint32_t crc = esp_rom_crc32_le(0, hdr.data(), 16);
+  s.intact = esp_rom_crc32_le(crc, h + 16, length) == stored;
+  return s;
+}
+
+static std::vector<uint8_t> *eepromBlob() {
+  return hostBlob("eeprom", "eeprom");
+}
+
+static std::vector<uint8_t> *scheduleBlob() {
+  return hostBlob(SCHEDULE_STORE_NAME, SCHEDULE_STORE_NAME);
+}
+
+// A unit that last ran the shared 4 KB layout: config slots at 0/256,
+// schedule slots at 512/2304
+static std::vector<uint8_t> sharedImage(const std::vector<Rule> &rules) {
+  std::vector<uint8_t> blob(SHARED_EEPROM_SIZE, 0xFF);
+  writeRecord(blob, SHARED_SCHEDULE_SLOT_B, SCHEDULE_RECORD_MAGIC, 1, 7, schedulePayload(rules));
+  return blob;
+}
+
+static const uint8_t WEEKDAYS = 0x3E;   // Monday to Friday
+
+static const std::vector<Rule> RULES = {
+  { 7 * 60 + 30, SCHEDULE_TARGET_JACK, WEEKDAYS, 1 },
+  { 22 * 60, SCHEDULE_TARGET_BOTH, SCHEDULE_DAYS_ALL, 0 },
+};
+
+static void checkRules() {
+  CHECK_EQ(config.scheduleCount, 2);
+  CHECK_EQ(config.schedules[0].time, 730);
+  CHECK_EQ(config.schedules[0].target, SCHEDULE_TARGET_JACK);
+  CHECK_EQ(config.schedules[0].days, WEEKDAYS);
+  CHECK_EQ(config.schedules[0].action, 1);
+  CHECK_EQ(config.schedules[1].time, 2200);
+  CHECK_EQ(config.schedules[1].target, SCHEDULE_TARGET_BOTH);
+  CHECK_EQ(config.schedules[1].action, 0);
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+// Old layout with neither a valid config record nor the legacy magic: the
+// config falls back to defaults, the schedules still move to their own store
+static void sharedLayoutBadConfigKeepsSchedules() {
+  std::vector<uint8_t> blob = sharedImage(RULES);
+  blob[ADDR_MAGIC] = 0x00;
+  hostSetBlob("eeprom", "eeprom", blob);
+
+  loadConfig();
+  CHECK(strcmp(config.timezone, "UTC") == 0);
+  checkRules();
+
+  SlotInfo a = slotAt(scheduleBlob(), SCHEDULE_SLOT_A);
+  SlotInfo b = slotAt(scheduleBlob(), SCHEDULE_SLOT_B);
+  CHECK((a.magic == SCHEDULE_RECORD_MAGIC && a.intact) || (b.magic == SCHEDULE_RECORD_MAGIC && b.intact));
+  CHECK(slotAt(eepromBlob(), CONFIG_SLOT_A).intact || slotAt(eepromBlob(), CONFIG_SLOT_B).intact);
+  CHECK_EQ(eepromBlob()->size(), EEPROM_SIZE);
+
+  // And the next boot finds them in the new store
+  memset(&config, 0, sizeof(config));
+  loadConfig();
+  checkRules();
+}
+
+// Old layout with a good config record: both survive the move
+static void sharedLayoutGoodConfig() {
+  std::vector<uint8_t> blob = sharedImage(RULES);
+  writeRecord(blob, CONFIG_SLOT_A, CONFIG_RECORD_MAGIC, CONFIG_RECORD_VERSION, 4, configPayload("home", 12));
+  hostSetBlob("eeprom", "eeprom", blob);
+
+  loadConfig();
+  CHECK(strcmp(config.ssid, "home") == 0);
+  CHECK(strcmp(config.timezone, "UTC+2") == 0);
+  CHECK_EQ(config.pdVoltage, 12);
+  checkRules();
+  CHECK_EQ(eepromBlob()->size(), EEPROM_SIZE);
+  CHECK(scheduleBlob() != nullptr);
+}
+
+// A config record written by newer firmware is left alone rather than
+// decoded, and the next record outranks it
+static void newerConfigVersionIsOutranked() {
+  std::vector<uint8_t> blob(EEPROM_SIZE, 0xFF);
+  writeRecord(blob, CONFIG_SLOT_A, CONFIG_RECORD_MAGIC, CONFIG_RECORD_VERSION + 1, 41, configPayload("future", 20));
+  hostSetBlob("eeprom", "eeprom", blob);
+  std::vector<uint8_t> schedules(SCHEDULE_STORE_SIZE, 0xFF);
+  writeRecord(schedules, SCHEDULE_SLOT_A, SCHEDULE_RECORD_MAGIC, 1, 3, schedulePayload(RULES));
+  hostSetBlob(SCHEDULE_STORE_NAME, SCHEDULE_STORE_NAME, schedules);
+
+  loadConfig();
+  CHECK(strcmp(config.ssid, "") == 0);
+  checkRules();
+
+  SlotInfo a = slotAt(eepromBlob(), CONFIG_SLOT_A);
+  SlotInfo b = slotAt(eepromBlob(), CONFIG_SLOT_B);
+  SlotInfo &written = (b.intact && b.sequence == 42) ? b : a;
+  CHECK(written.intact);
+  CHECK_EQ(written.sequence, 42);
+}
+
+// Nothing in flash: defaults, written once
+static void freshDevice() {
+  loadConfig();
+  CHECK(strcmp(config.timezone, "UTC") == 0);
+  CHECK_EQ(config.pdVoltage, 9);
+  CHECK_EQ(config.scheduleCount, 0);
+  CHECK(slotAt(eepromBlob(), CONFIG_SLOT_A).intact || slotAt(eepromBlob(), CONFIG_SLOT_B).intact);
+  CHECK_EQ(eepromBlob()->size(), EEPROM_SIZE);
+}
+
+static const HostTest tests[] = {
+  HOST_TEST(sharedLayoutBadConfigKeepsSchedules),
+  HOST_TEST(sharedLayoutGoodConfig),
+  HOST_TEST(newerConfigVersionIsOutranked),
+  HOST_TEST(freshDevice),
+};
+
+int main(int argc, char **argv) {
+  return hostMain(argc, argv, tests, sizeof(tests) / sizeof(tests[0]));
+}
@@ -0,0 +1,57 @@
+#include "timekeeping.h"
+#include "scheduler.h"
+#include "perf.h"
+
+void tickClock() {
+  static unsigned long lastMillis = millis();
+  unsigned long elapsed = (millis() - lastMillis) / 1000;
+  lastMillis += elapsed * 1000;
+  if (currentTime == 0) return;
+  
+  currentTime += elapsed;
+  config.lastTime = currentTime;
+  PERF_SCOPE(PERF_SCHEDULES);
+  checkSchedules();
+}
+
+bool getTimezoneOffset(int &tzOffset) {
+  tzOffset = 0;
+  String tz = String(config.timezone);
+  tz.toUpperCase();
+  
+  // Check for UTC+X or UTC-X format
+  if (tz.startsWith("UTC")) {
+    if (tz.length() > 3) {
+      String offsetStr = tz.substring(3);
+      tzOffset = offsetStr.toInt();
+    } else {
+      tzOffset = 0;
+    }
+  }
+  // Named timezones
+  else if (tz == "EST") tzOffset = -5;
+  else if (tz == "EDT") tzOffset = -4;
+  else if (tz == "CST") tzOffset = -6;
+  else if (tz == "CDT") tzOffset = -5;
+  else if (tz == "MST") tzOffset = -7;
+  else if (tz == "MDT") tzOffset = -6;
+  else if (tz == "PST") tzOffset = -8;
+  else if (tz == "PDT") tzOffset = -7;
+  else if (tz == "GMT") tzOffset = 0;
+  else if (tz == "CET") tzOffset = 1;
+  else if (tz == "CEST") tzOffset = 2;
+  else if (tz == "JST") tzOffset = 9;
+  else if (tz == "KST") tzOffset = 9;
+  else if (tz == "CNST") tzOffset = 8;
+  else if (tz == "AEST") tzOffset = 10;
+  else if (tz == "AEDT") tzOffset = 11;
+  else if (tz == "NZST") tzOffset = 12;
+  else if (tz == "NZDT") tzOffset = 13;
+  else if (tz == "IST") tzOffset = 5;
+  else if (tz == "HKT") tzOffset = 8;
+  else {
+    tzOffset = 0;
+    return false;
+  }
+  return true;
+}
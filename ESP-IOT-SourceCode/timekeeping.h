@@ -0,0 +1,17 @@
+#ifndef TIMEKEEPING_H
+#define TIMEKEEPING_H
+
+#include "config.h"
+
+// currentTime is a UTC epoch kept by the control task: set by NTP or the
+// journal checkpoint, and advanced here from millis() between syncs.
+
+// Advance the clock by whole elapsed seconds, carrying the remainder, and
+// run the schedules that are due. Control task, every CLOCK_TICK_INTERVAL.
+void tickClock();
+
+// Resolve config.timezone to a UTC offset in hours. Returns false (offset 0)
+// for unknown codes.
+bool getTimezoneOffset(int &tzOffset);
+
+#endif
@@ -0,0 +1,252 @@
+#include "timers.h"
+#include "hardware.h"
+#include "scheduler.h"
+#include "event_loop.h"
+#include "control.h"
+#include "perf.h"
+
+// Active timers form a binary min-heap on deadline. One event-loop event is
+// kept armed for the earliest deadline, so idle timers cost nothing.
+static OutputTimer heap[TIMER_MAX];
+static uint8_t heapSize = 0;
+static uint16_t nextId = 1;
+static int timerEvent = -1;
+
+static bool before(const OutputTimer &a, const OutputTimer &b) {
+  return (int32_t)(a.deadline - b.deadline) < 0;
+}
+
+static void siftUp(uint8_t pos) {
+  OutputTimer t = heap[pos];
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (!before(t, heap[parent])) break;
+    heap[pos] = heap[parent];
+    pos = parent;
+  }
+  heap[pos] = t;
+}
+
+static void siftDown(uint8_t pos) {
+  OutputTimer t = heap[pos];
+  while (true) {
+    uint8_t child = pos * 2 + 1;
+    if (child >= heapSize) break;
+    if (child + 1 < heapSize && before(heap[child + 1], heap[child])) child++;
+    if (!before(heap[child], t)) break;
+    heap[pos] = heap[child];
+    pos = child;
+  }
+  heap[pos] = t;
+}
+
+static void push(const OutputTimer &t) {
+  heap[heapSize] = t;
+  siftUp(heapSize++);
+}
+
+static void removeAt(uint8_t pos) {
+  heapSize--;
+  if (pos == heapSize) return;
+  heap[pos] = heap[heapSize];
+  siftDown(pos);
+  siftUp(pos);
+}
+
+static void armEvent() {
+  if (heapSize == 0) {
+    cancelEvent(timerEvent);
+    return;
+  }
+  int32_t until = (int32_t)(heap[0].deadline - millis());
+  scheduleEvent(timerEvent, until > 0 ? until : 0);
+}
+
+static void applyOutput(uint8_t target, uint8_t action) {
+  if (target != SCHEDULE_TARGET_USB) {
+    setPowerJackState(action == TIMER_TOGGLE ? !powerJackState : action == TIMER_ON);
+  }
+  if (target != SCHEDULE_TARGET_JACK) {
+    setUSBOutputState(action == TIMER_TOGGLE ? !usbOutputState : action == TIMER_ON);
+  }
+}
+
+static void runTimers() {
+  PERF_SCOPE(PERF_TIMERS);
+  uint32_t now = millis();
+  while (heapSize > 0 && (int32_t)(now - heap[0].deadline) >= 0) {
+    OutputTimer t = heap[0];
+    removeAt(0);
+
+    Serial.print(F("Timer #"));
+    Serial.print(t.id);
+    Serial.print(F(": "));
+    Serial.print(scheduleTargetName(t.target));
+    Serial.print(F(" -> "));
+    Serial.println(timerActionName(t.action));
+    applyOutput(t.target, t.action);
+
+    // Repeats keep their phase unless they fell a whole period behind
+    if (t.periodMs > 0) {
+      t.deadline += t.periodMs;
+      if ((int32_t)(now - t.deadline) >= 0) t.deadline = now + t.periodMs;
+      push(t);
+    }
+    now = millis();
+  }
+  armEvent();
+}
+
+void beginTimers() {
+  timerEvent = addEvent(runTimers, 0);
+}
+
+int addTimer(uint8_t target, uint8_t action, uint32_t delayMs, uint32_t periodMs) {
+  if (!onControlTask()) {
+    struct Call { uint8_t target, action; uint32_t delayMs, periodMs; int id; } call =
+      { target, action, delayMs, periodMs, -1 };
+    runOnControl([](void *arg) {
+      Call *c = (Call *)arg;
+      c->id = addTimer(c->target, c->action, c->delayMs, c->periodMs);
+    }, &call);
+    return call.id;
+  }
+  if (target == SCHEDULE_TARGET_PD || action > TIMER_TOGGLE) return -1;
+  if (periodMs > 0 && periodMs < TIMER_MIN_PERIOD) return -1;
+  if (heapSize >= TIMER_MAX) return -1;
+
+  OutputTimer t;
+  t.id = nextId++;
+  if (nextId == 0) nextId = 1;
+  t.target = target;
+  t.action = action;
+  t.deadline = millis() + delayMs;
+  t.periodMs = periodMs;
+  push(t);
+  armEvent();
+  return t.id;
+}
+
+int startPowerCycle(uint8_t target, uint32_t offMs) {
+  if (!onControlTask()) {
+    struct Call { uint8_t target; uint32_t offMs; int id; } call = { target, offMs, -1 };
+    runOnControl([](void *arg) {
+      Call *c = (Call *)arg;
+      c->id = startPowerCycle(c->target, c->offMs);
+    }, &call);
+    return call.id;
+  }
+  if (target == SCHEDULE_TARGET_PD || heapSize >= TIMER_MAX) return -1;
+  applyOutput(target, TIMER_OFF);
+  return addTimer(target, TIMER_ON, offMs, 0);
+}
+
+bool cancelTimer(uint16_t id) {
+  if (!onControlTask()) {
+    struct Call { uint16_t id; bool ok; } call = { id, false };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->ok = cancelTimer(c->id); }, &call);
+    return call.ok;
+  }
+  for (uint8_t i = 0; i < heapSize; i++) {
+    if (heap[i].id == id) {
+      removeAt(i);
+      armEvent();
+      return true;
+    }
+  }
+  return false;
+}
+
+void cancelAllTimers() {
+  if (!onControlTask()) {
+    runOnControl([](void *) { cancelAllTimers(); }, nullptr);
+    return;
+  }
+  heapSize = 0;
+  armEvent();
+}
+
+uint8_t getTimerCount() {
+  return heapSize;
+}
+
+uint8_t copyTimers(OutputTimer *out) {
+  if (!onControlTask()) {
+    struct Call { OutputTimer *out; uint8_t count; } call = { out, 0 };
+    runOnControl([](void *arg) { Call *c = (Call *)arg; c->count = copyTimers(c->out); }, &call);
+    return call.count;
+  }
+  memcpy(out, heap, heapSize * sizeof(OutputTimer));
+  return heapSize;
+}
+
+uint32_t timerRemaining(const OutputTimer &t) {
+  int32_t until = (int32_t)(t.deadline - millis());
+  return until > 0 ? until : 0;
+}
+
+// ============================================================================
+// Parsing
+// ============================================================================
+bool parseDuration(String text, uint32_t &ms) {
+  text.trim();
+  text.toLowerCase();
+  uint32_t unit = 1000;
+  if (text.endsWith("ms")) {
+    unit = 1;
+    text = text.substring(0, text.length() - 2);
+  } else if (text.endsWith("s")) {
+    text = text.substring(0, text.length() - 1);
+  } else if (text.endsWith("m")) {
+    unit = 60000;
+    text = text.substring(0, text.length() - 1);
+  } else if (text.endsWith("h")) {
+    unit = 3600000;
+    text = text.substring(0, text.length() - 1);
+  }
+  if (text.length() == 0) return false;
+
+  // Integer and fractional parts, milliseconds precision
+  uint32_t whole = 0;
+  uint32_t frac = 0;
+  uint32_t fracScale = 1;
+  bool point = false;
+  for (unsigned i = 0; i < text.length(); i++) {
+    char c = text.charAt(i);
+    if (c == '.' && !point) {
+      point = true;
+    } else if (c >= '0' && c <= '9') {
+      if (point) {
+        if (fracScale < 1000) {
+          frac = frac * 10 + (c - '0');
+          fracScale *= 10;
+        }
+      } else {
+        whole = whole * 10 + (c - '0');
+        if (whole > TIMER_MAX_DELAY / unit) return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  ms = whole * unit + (uint32_t)((uint64_t)frac * unit / fracScale);
+  return ms <= TIMER_MAX_DELAY;
+}
+
+bool parseTimerAction(String text, uint8_t &action) {
+  text.trim();
+  text.toLowerCase();
+  if (text == "on") action = TIMER_ON;
+  else if (text == "off") action = TIMER_OFF;
+  else if (text == "toggle") action = TIMER_TOGGLE;
+  else return false;
+  return true;
+}
+
+const char *timerActionName(uint8_t action) {
+  switch (action) {
+    case TIMER_ON: return "on";
+    case TIMER_OFF: return "off";
+    default: return "toggle";
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include "config.h"
+
+// Relative output timers ("USB off in 90s", "toggle the jack every 2s").
+// Timers live in RAM only and don't survive a reboot.
+#define TIMER_ON 0
+#define TIMER_OFF 1
+#define TIMER_TOGGLE 2
+
+struct OutputTimer {
+  uint16_t id;
+  uint8_t target;       // SCHEDULE_TARGET_BOTH, _JACK or _USB
+  uint8_t action;       // TIMER_*
+  uint32_t deadline;    // millis() value
+  uint32_t periodMs;    // 0 = one-shot
+};
+
+// Register the timer event with the event loop
+void beginTimers();
+
+// Returns the new timer id, or -1 if the table is full or the arguments are
+// invalid (bad target, repeat period below TIMER_MIN_PERIOD)
+int addTimer(uint8_t target, uint8_t action, uint32_t delayMs, uint32_t periodMs);
+
+// Switch target off now and back on after offMs. Returns the timer id.
+int startPowerCycle(uint8_t target, uint32_t offMs);
+
+bool cancelTimer(uint16_t id);
+void cancelAllTimers();
+
+uint8_t getTimerCount();
+
+// Snapshot of the active timers, in no particular order. out must hold
+// TIMER_MAX entries. Returns the count.
+uint8_t copyTimers(OutputTimer *out);
+
+// Milliseconds until a timer fires (0 if due)
+uint32_t timerRemaining(const OutputTimer &t);
+
+// "90", "1.5", "500ms", "90s", "15m", "2h"; bare numbers are seconds
+bool parseDuration(String text, uint32_t &ms);
+bool parseTimerAction(String text, uint8_t &action);  // on, off, toggle
+const char *timerActionName(uint8_t action);
+
+#endif
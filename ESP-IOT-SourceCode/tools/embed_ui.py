@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""Compress web/index.html into index_html.h for the sketch.
+
+Run after editing the UI:  python3 tools/embed_ui.py
+The output is deterministic (no gzip timestamp), so an unchanged page
+produces an unchanged header and ETag.
+"""
+import gzip
+import hashlib
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, "web", "index.html")
+OUTPUT = os.path.join(ROOT, "index_html.h")
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        html = f.read()
+    data = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(html).hexdigest()[:16]
+
+    lines = [
+        "// Generated by tools/embed_ui.py from web/index.html - do not edit",
+        "#ifndef INDEX_HTML_H",
+        "#define INDEX_HTML_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// %d bytes of HTML, gzip-compressed" % len(html),
+        "#define INDEX_HTML_GZ_LEN %d" % len(data),
+        '#define INDEX_HTML_ETAG "\\"%s\\""' % etag,
+        "",
+        "const uint8_t INDEX_HTML_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(data), 16):
+        chunk = data[i:i + 16]
+        lines.append("  " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif", ""]
+
+    with open(OUTPUT, "w", newline="\n") as f:
+        f.write("\n".join(lines))
+    print("index_html.h: %d -> %d bytes, ETag %s" % (len(html), len(data), etag))
+
+
+if __name__ == "__main__":
+    main()